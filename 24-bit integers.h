@@ -0,0 +1,296 @@
+/**********************************************************************
+ * File: 24-bit integers.h                        Created: 2024/05/13 *
+ *                                          Last modified: 2024/07/26 *
+ *                                                                    *
+ * Desc: ui24 & si24, 3-byte integers that convert to & from 32-bit,  *
+ *       with wrapping arithmetic, & ui24x16 & si24x16, blocks of 16  *
+ *       packed codes. fpdtWiden() & fpdtNarrow() convert arrays of   *
+ *       either to & from 32-bit integers, 16 codes at a time.        *
+ *                                                                    *
+ * Notes: Include this file before any other, or define               *
+ *        _24BIT_INTEGERS_ for the whole project, so that the 24-bit  *
+ *        vector structures & fixed-point types are declared.         *
+ *        Arrays are tightly packed, 3 bytes per code, with no        *
+ *        alignment. Narrowing keeps the low 24 bits, as ui24(x)      *
+ *        does. Kernels are SSE, AVX2, or AVX512, chosen by           *
+ *        fpdtISA(), & never read or write past either array.         *
+ *                                                                    *
+ * MIT license.                     Copyright (c) David William Bull. *
+ **********************************************************************/
+#pragma once
+
+#include <type_traits>
+#include "typedefs.h"
+#include "Fixed-point CPU dispatch.h"
+
+#define _24BIT_INTEGERS_
+
+/************
+ *  Scalar  *
+ ************/
+
+// 24-bit, unsigned : Range of 0~16777215; arithmetic wraps modulo 2^24
+struct ui24 {
+   typedef const ui24 cui24;
+
+   ui8 data[3];
+
+   inline void set(cui32 value) { data[0] = ui8(value); data[1] = ui8(value >> 8); data[2] = ui8(value >> 16); }
+
+   ui24(void) = default;
+   // Integers keep their low 24 bits, & floats truncate toward zero first
+   template<typename T> explicit ui24(const T value) { if constexpr (std::is_floating_point_v<T>) set(ui32(si32(value))); else set(ui32(value)); }
+
+   operator cui32(void) const { return ui32(data[0]) | ui32(data[1]) << 8 | ui32(data[2]) << 16; }
+
+   // Assignments from 32-bit integers keep the low 24 bits
+   inline cui24 operator=(cui32 value) { set(value); return *this; }
+
+   inline cui24 operator~(void) const { return ui24(~ui32(*this)); }
+   inline cui24 operator-(void) const { return ui24(0u - ui32(*this)); }
+
+   inline cui24 operator++(void) { set(ui32(*this) + 1); return *this; }
+   inline cui24 operator++(int) { cui24 temp = *this; set(ui32(temp) + 1); return temp; }
+   inline cui24 operator--(void) { set(ui32(*this) - 1); return *this; }
+   inline cui24 operator--(int) { cui24 temp = *this; set(ui32(temp) - 1); return temp; }
+
+   inline cui24 operator<<(csi32 &value) const { return ui24(ui32(*this) << value); }
+   inline cui24 operator>>(csi32 &value) const { return ui24(ui32(*this) >> value); }
+   inline cui24 operator<<=(csi32 &value) { set(ui32(*this) << value); return *this; }
+   inline cui24 operator>>=(csi32 &value) { set(ui32(*this) >> value); return *this; }
+
+   inline cui24 operator+(cui24 &value) const { return ui24(ui32(*this) + ui32(value)); }
+   inline cui24 operator-(cui24 &value) const { return ui24(ui32(*this) - ui32(value)); }
+   inline cui24 operator*(cui24 &value) const { return ui24(ui32(*this) * ui32(value)); }
+   inline cui24 operator/(cui24 &value) const { return ui24(ui32(*this) / ui32(value)); }
+   inline cui24 operator%(cui24 &value) const { return ui24(ui32(*this) % ui32(value)); }
+   inline cui24 operator&(cui24 &value) const { return ui24(ui32(*this) & ui32(value)); }
+   inline cui24 operator|(cui24 &value) const { return ui24(ui32(*this) | ui32(value)); }
+   inline cui24 operator^(cui24 &value) const { return ui24(ui32(*this) ^ ui32(value)); }
+   inline cui24 operator+=(cui32 value) { set(ui32(*this) + value); return *this; }
+   inline cui24 operator-=(cui32 value) { set(ui32(*this) - value); return *this; }
+   inline cui24 operator*=(cui32 value) { set(ui32(*this) * value); return *this; }
+   inline cui24 operator/=(cui32 value) { set(ui32(*this) / value); return *this; }
+   inline cui24 operator%=(cui32 value) { set(ui32(*this) % value); return *this; }
+   inline cui24 operator&=(cui32 value) { set(ui32(*this) & value); return *this; }
+   inline cui24 operator|=(cui32 value) { set(ui32(*this) | value); return *this; }
+   inline cui24 operator^=(cui32 value) { set(ui32(*this) ^ value); return *this; }
+};
+
+// 24-bit, signed : Range of -8388608~8388607; arithmetic wraps modulo 2^24
+struct si24 {
+   typedef const si24 csi24;
+
+   ui8 data[3];
+
+   inline void set(cui32 value) { data[0] = ui8(value); data[1] = ui8(value >> 8); data[2] = ui8(value >> 16); }
+
+   si24(void) = default;
+   // Integers keep their low 24 bits, & floats truncate toward zero first
+   template<typename T> explicit si24(const T value) { if constexpr (std::is_floating_point_v<T>) set(ui32(si32(value))); else set(ui32(value)); }
+
+   // The top byte is shifted into the sign bit, then arithmetically back down
+   operator csi32(void) const { return si32(ui32(data[0]) << 8 | ui32(data[1]) << 16 | ui32(data[2]) << 24) >> 8; }
+
+   // Assignments from 32-bit integers keep the low 24 bits
+   inline csi24 operator=(csi32 value) { set(ui32(value)); return *this; }
+
+   inline csi24 operator~(void) const { return si24(~si32(*this)); }
+   inline csi24 operator-(void) const { return si24(0u - ui32(si32(*this))); }
+
+   inline csi24 operator++(void) { set(ui32(si32(*this)) + 1); return *this; }
+   inline csi24 operator++(int) { csi24 temp = *this; set(ui32(si32(temp)) + 1); return temp; }
+   inline csi24 operator--(void) { set(ui32(si32(*this)) - 1); return *this; }
+   inline csi24 operator--(int) { csi24 temp = *this; set(ui32(si32(temp)) - 1); return temp; }
+
+   inline csi24 operator<<(csi32 &value) const { return si24(ui32(si32(*this)) << value); }
+   inline csi24 operator>>(csi32 &value) const { return si24(si32(*this) >> value); }
+   inline csi24 operator<<=(csi32 &value) { return *this = *this << value; }
+   inline csi24 operator>>=(csi32 &value) { return *this = *this >> value; }
+
+   inline csi24 operator+(csi24 &value) const { return si24(ui32(si32(*this)) + ui32(si32(value))); }
+   inline csi24 operator-(csi24 &value) const { return si24(ui32(si32(*this)) - ui32(si32(value))); }
+   inline csi24 operator*(csi24 &value) const { return si24(ui32(si32(*this)) * ui32(si32(value))); }
+   inline csi24 operator/(csi24 &value) const { return si24(si32(*this) / si32(value)); }
+   inline csi24 operator%(csi24 &value) const { return si24(si32(*this) % si32(value)); }
+   inline csi24 operator&(csi24 &value) const { return si24(si32(*this) & si32(value)); }
+   inline csi24 operator|(csi24 &value) const { return si24(si32(*this) | si32(value)); }
+   inline csi24 operator^(csi24 &value) const { return si24(si32(*this) ^ si32(value)); }
+   inline csi24 operator+=(csi32 value) { set(ui32(si32(*this)) + ui32(value)); return *this; }
+   inline csi24 operator-=(csi32 value) { set(ui32(si32(*this)) - ui32(value)); return *this; }
+   inline csi24 operator*=(csi32 value) { set(ui32(si32(*this)) * ui32(value)); return *this; }
+   inline csi24 operator/=(csi32 value) { set(ui32(si32(*this) / value)); return *this; }
+   inline csi24 operator%=(csi32 value) { set(ui32(si32(*this) % value)); return *this; }
+   inline csi24 operator&=(csi32 value) { set(ui32(si32(*this) & value)); return *this; }
+   inline csi24 operator|=(csi32 value) { set(ui32(si32(*this) | value)); return *this; }
+   inline csi24 operator^=(csi32 value) { set(ui32(si32(*this) ^ value)); return *this; }
+};
+
+typedef const ui24 cui24;
+typedef const si24 csi24;
+
+// 16x 24-bit, packed into 48 bytes
+struct ui24x16 { ui24 data[16]; inline ui24 &operator[](csize_t i) { return data[i]; } inline cui24 &operator[](csize_t i) const { return data[i]; } };
+struct si24x16 { si24 data[16]; inline si24 &operator[](csize_t i) { return data[i]; } inline csi24 &operator[](csize_t i) const { return data[i]; } };
+
+typedef const ui24x16 cui24x16;
+typedef const si24x16 csi24x16;
+
+/*************
+ *  Kernels  *
+ *************/
+
+// Byte i of each 32-bit lane from packed codes; signed codes land in the top 3 bytes, to be shifted down arithmetically
+static cui128 _i24_unpackU = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+static cui128 _i24_unpackS = _mm_setr_epi8(-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11);
+static cui128 _i24_pack = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+
+template<cbool sign> static inline cui32 _i24_widen(cui8 *src) {
+   cui32 code = ui32(src[0]) | ui32(src[1]) << 8 | ui32(src[2]) << 16;
+   return sign ? ui32(si32(code << 8) >> 8) : code;
+}
+
+static inline void _i24_narrow1(ui8 *dest, cui32 value) { dest[0] = ui8(value); dest[1] = ui8(value >> 8); dest[2] = ui8(value >> 16); }
+
+template<cbool sign> static inline csi128 _i24_widen4(csi128 packed) {
+   csi128 value = _mm_shuffle_epi8(packed, sign ? _i24_unpackS : _i24_unpackU);
+   return sign ? _mm_srai_epi32(value, 8) : value;
+}
+
+// 3 loads of 16 bytes hold 16 codes; the middle 2 groups of 12 bytes straddle them, so are realigned
+template<cbool sign> static inline void _i24_load16SSE(si128 (&dest)[4], cui8 *src) {
+   csi128 a = _mm_loadu_si128((csi128 *)src), b = _mm_loadu_si128((csi128 *)&src[16]), c = _mm_loadu_si128((csi128 *)&src[32]);
+
+   dest[0] = _i24_widen4<sign>(a);
+   dest[1] = _i24_widen4<sign>(_mm_alignr_epi8(b, a, 12));
+   dest[2] = _i24_widen4<sign>(_mm_alignr_epi8(c, b, 8));
+   dest[3] = _i24_widen4<sign>(_mm_srli_si128(c, 4));
+}
+
+static inline void _i24_store16SSE(ui8 *dest, csi128 (&src)[4]) {
+   csi128 a = _mm_shuffle_epi8(src[0], _i24_pack), b = _mm_shuffle_epi8(src[1], _i24_pack), c = _mm_shuffle_epi8(src[2], _i24_pack), d = _mm_shuffle_epi8(src[3], _i24_pack);
+
+   _mm_storeu_si128((si128 *)dest, _mm_or_si128(a, _mm_slli_si128(b, 12)));
+   _mm_storeu_si128((si128 *)&dest[16], _mm_or_si128(_mm_srli_si128(b, 4), _mm_slli_si128(c, 8)));
+   _mm_storeu_si128((si128 *)&dest[32], _mm_or_si128(_mm_srli_si128(c, 8), _mm_slli_si128(d, 4)));
+}
+
+template<cbool sign> static inline void _i24_widenSSE(ui32 *dest, cui8 *src, csize_t count) {
+   size_t i = 0;
+
+   for (; i + 16 <= count; i += 16) {
+      si128 value[4];
+
+      _i24_load16SSE<sign>(value, &src[i * 3]);
+      for (ui32 j = 0; j < 4; j++) _mm_storeu_si128((si128 *)&dest[i + j * 4], value[j]);
+   }
+   for (; i < count; i++) dest[i] = _i24_widen<sign>(&src[i * 3]);
+}
+
+template<cbool sign> static inline void _i24_narrowSSE(ui8 *dest, cui32 *src, csize_t count) {
+   size_t i = 0;
+
+   for (; i + 16 <= count; i += 16) {
+      csi128 value[4] = { _mm_loadu_si128((csi128 *)&src[i]), _mm_loadu_si128((csi128 *)&src[i + 4]), _mm_loadu_si128((csi128 *)&src[i + 8]), _mm_loadu_si128((csi128 *)&src[i + 12]) };
+
+      _i24_store16SSE(&dest[i * 3], value);
+   }
+   for (; i < count; i++) _i24_narrow1(&dest[i * 3], src[i]);
+}
+
+#ifdef _FPDT_KERNELS_AVX2_
+// 2 overlapping 32-byte loads, with each lane's 12 bytes of codes permuted into place
+template<cbool sign> static inline _FPDT_TARGET_AVX2_ void _i24_load16AVX2(si256 (&dest)[2], cui8 *src) {
+   cui256 shuffle = _mm256_broadcastsi128_si256(sign ? _i24_unpackS : _i24_unpackU);
+
+   dest[0] = _mm256_shuffle_epi8(_mm256_permutevar8x32_epi32(_mm256_loadu_si256((csi256 *)src), _mm256_setr_epi32(0, 1, 2, 2, 3, 4, 5, 5)), shuffle);
+   dest[1] = _mm256_shuffle_epi8(_mm256_permutevar8x32_epi32(_mm256_loadu_si256((csi256 *)&src[16]), _mm256_setr_epi32(2, 3, 4, 4, 5, 6, 7, 7)), shuffle);
+   if (sign) { dest[0] = _mm256_srai_epi32(dest[0], 8); dest[1] = _mm256_srai_epi32(dest[1], 8); }
+}
+
+// The first 8 codes & 8 bytes of the next fill one 32-byte store; the remaining 16 bytes are a 16-byte store
+static inline _FPDT_TARGET_AVX2_ void _i24_store16AVX2(ui8 *dest, csi256 (&src)[2]) {
+   cui256 shuffle = _mm256_broadcastsi128_si256(_i24_pack);
+   csi256 a = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(src[0], shuffle), _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+   csi256 b = _mm256_shuffle_epi8(src[1], shuffle); // 12 bytes in each lane
+
+   _mm256_storeu_si256((si256 *)dest, _mm256_blend_epi32(a, _mm256_permutevar8x32_epi32(b, _mm256_setr_epi32(0, 0, 0, 0, 0, 0, 0, 1)), 0x0C0));
+   _mm_storeu_si128((si128 *)&dest[32], _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(b, _mm256_setr_epi32(2, 4, 5, 6, 0, 0, 0, 0))));
+}
+
+template<cbool sign> static inline _FPDT_TARGET_AVX2_ void _i24_widenAVX2(ui32 *dest, cui8 *src, csize_t count) {
+   size_t i = 0;
+
+   for (; i + 16 <= count; i += 16) {
+      si256 value[2];
+
+      _i24_load16AVX2<sign>(value, &src[i * 3]);
+      _mm256_storeu_si256((si256 *)&dest[i], value[0]);
+      _mm256_storeu_si256((si256 *)&dest[i + 8], value[1]);
+   }
+   for (; i < count; i++) dest[i] = _i24_widen<sign>(&src[i * 3]);
+}
+
+template<cbool sign> static inline _FPDT_TARGET_AVX2_ void _i24_narrowAVX2(ui8 *dest, cui32 *src, csize_t count) {
+   size_t i = 0;
+
+   for (; i + 16 <= count; i += 16) {
+      csi256 value[2] = { _mm256_loadu_si256((csi256 *)&src[i]), _mm256_loadu_si256((csi256 *)&src[i + 8]) };
+
+      _i24_store16AVX2(&dest[i * 3], value);
+   }
+   for (; i < count; i++) _i24_narrow1(&dest[i * 3], src[i]);
+}
+#endif
+
+#ifdef _FPDT_KERNELS_AVX512_
+// n of 16 codes, loaded & stored under a byte mask, so that a partial block needs no scalar tail
+template<cbool sign> static inline _FPDT_TARGET_AVX512_ csi512 _i24_loadAVX512(cui8 *src, cui32 n) {
+   csi512 value = _mm512_shuffle_epi8(_mm512_permutexvar_epi32(_mm512_setr_epi32(0, 1, 2, 2, 3, 4, 5, 5, 6, 7, 8, 8, 9, 10, 11, 11), _mm512_maskz_loadu_epi8((1ull << (n * 3)) - 1, src)),
+                                      _mm512_broadcast_i32x4(sign ? _i24_unpackS : _i24_unpackU));
+   return sign ? _mm512_srai_epi32(value, 8) : value;
+}
+
+static inline _FPDT_TARGET_AVX512_ void _i24_storeAVX512(ui8 *dest, csi512 value, cui32 n) {
+   csi512 packed = _mm512_permutexvar_epi32(_mm512_setr_epi32(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, 3, 7, 11, 15), _mm512_shuffle_epi8(value, _mm512_broadcast_i32x4(_i24_pack)));
+
+   _mm512_mask_storeu_epi8(dest, (1ull << (n * 3)) - 1, packed);
+}
+
+template<cbool sign> static inline _FPDT_TARGET_AVX512_ void _i24_widenAVX512(ui32 *dest, cui8 *src, csize_t count) {
+   for (size_t i = 0; i < count; i += 16) {
+      cui32 n = count - i < 16 ? ui32(count - i) : 16;
+
+      _mm512_mask_storeu_epi32(&dest[i], __mmask16((1u << n) - 1), _i24_loadAVX512<sign>(&src[i * 3], n));
+   }
+}
+
+template<cbool sign> static inline _FPDT_TARGET_AVX512_ void _i24_narrowAVX512(ui8 *dest, cui32 *src, csize_t count) {
+   for (size_t i = 0; i < count; i += 16) {
+      cui32 n = count - i < 16 ? ui32(count - i) : 16;
+
+      _i24_storeAVX512(&dest[i * 3], _mm512_maskz_loadu_epi32(__mmask16((1u << n) - 1), &src[i]), n);
+   }
+}
+#endif
+
+static decltype(&_i24_widenSSE<false>) const _i24_widenISA[][3] = { _FPDT_KERNELS_T_(_i24_widen, false), _FPDT_KERNELS_T_(_i24_widen, true) };
+static decltype(&_i24_narrowSSE<false>) const _i24_narrowISA[][3] = { _FPDT_KERNELS_T_(_i24_narrow, false), _FPDT_KERNELS_T_(_i24_narrow, true) };
+
+/*************************
+ *  Bulk widen & narrow  *
+ *************************/
+
+// Widen count packed codes to 32-bit integers, sign-extending si24
+inline void fpdtWiden(ui32 *dest, cui24 *src, csize_t count) { _i24_widenISA[0][fpdtISA()](dest, (cui8 *)src, count); }
+inline void fpdtWiden(si32 *dest, csi24 *src, csize_t count) { _i24_widenISA[1][fpdtISA()]((ui32 *)dest, (cui8 *)src, count); }
+
+// Narrow count 32-bit integers to packed codes, keeping the low 24 bits of each
+inline void fpdtNarrow(ui24 *dest, cui32 *src, csize_t count) { _i24_narrowISA[0][fpdtISA()]((ui8 *)dest, src, count); }
+inline void fpdtNarrow(si24 *dest, csi32 *src, csize_t count) { _i24_narrowISA[1][fpdtISA()]((ui8 *)dest, (cui32 *)src, count); }
+
+// As above, for count blocks of 16 codes
+inline void fpdtWiden(ui32 *dest, cui24x16 *src, csize_t count) { fpdtWiden(dest, (cui24 *)src, count * 16); }
+inline void fpdtWiden(si32 *dest, csi24x16 *src, csize_t count) { fpdtWiden(dest, (csi24 *)src, count * 16); }
+inline void fpdtNarrow(ui24x16 *dest, cui32 *src, csize_t count) { fpdtNarrow((ui24 *)dest, src, count * 16); }
+inline void fpdtNarrow(si24x16 *dest, csi32 *src, csize_t count) { fpdtNarrow((si24 *)dest, src, count * 16); }
@@ -0,0 +1,275 @@
+/**********************************************************************
+ * File: Fixed-point CPU dispatch.h               Created: 2024/07/04 *
+ *                                          Last modified: 2024/07/26 *
+ *                                                                    *
+ * Desc: Run-time CPU feature detection & kernel selection. Kernels   *
+ *       are compiled for SSE, AVX2, and AVX512, then the widest set  *
+ *       supported by the host is resolved once, on first use.        *
+ *                                                                    *
+ * Notes: Define FPDT_NO_DISPATCH before including this file to fix   *
+ *        the instruction set at compile time, from __AVX2__ and      *
+ *        __AVX512F/BW/DQ/VL__.                                       *
+ *        SSE4.1, with SSSE3, is the minimum for every kernel: other  *
+ *        compilers stop with an #error without it, & fpdtISA() exits *
+ *        with a message on hosts that lack it.                       *
+ *        fpdtSetISA() lowers the instruction set used by dispatched  *
+ *        kernels; it never raises it above what the host supports.   *
+ *        GCC & Clang compile the AVX2 & AVX512 kernels with          *
+ *        per-function target attributes, so every build holds all    *
+ *        3 sets; other compilers besides MSVC only emit them when    *
+ *        those instruction sets are enabled at compile time.         *
+ *        fpdtCacheSize() returns the size of the last-level cache,   *
+ *        for choosing between cached & streaming stores.             *
+ *                                                                    *
+ * MIT license.                     Copyright (c) David William Bull. *
+ **********************************************************************/
+#pragma once
+
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#include <cstdio>
+#include <cstdlib>
+#include "typedefs.h"
+
+#define _FIXED_POINT_CPU_DISPATCH_
+
+// Instruction sets, in order of width; also indices into kernel tables
+#define FPDT_ISA_SSE    0
+#define FPDT_ISA_AVX2   1
+#define FPDT_ISA_AVX512 2
+
+// CPU feature flags
+#define FPDT_CPU_SSE41  0x01
+#define FPDT_CPU_AVX2   0x02
+#define FPDT_CPU_FMA    0x04
+#define FPDT_CPU_F16C   0x08
+#define FPDT_CPU_BMI2   0x10
+#define FPDT_CPU_AVX512 0x20 // AVX512F, AVX512BW, AVX512DQ, & AVX512VL
+#define FPDT_CPU_VNNI   0x40 // AVX512-VNNI
+#define FPDT_CPU_BF16   0x80 // AVX512-BF16
+#define FPDT_CPU_FP16   0x100 // AVX512-FP16
+
+// The SSE kernels, & the data types themselves, use SSSE3 & SSE4.1 instructions
+#if !defined(_MSC_VER) && !defined(__SSE4_1__)
+#error "Fixed-point kernels require SSE4.1; compile with -msse4.1 or a later instruction set"
+#endif
+
+// The AVX512 kernels use AVX512F, AVX512BW, AVX512DQ, & AVX512VL instructions
+#if defined(__AVX512F__) && defined(__AVX512BW__) && defined(__AVX512DQ__) && defined(__AVX512VL__)
+#define _FPDT_AVX512_ENABLED_
+#endif
+
+// GCC & Clang compile each AVX2 & AVX512 kernel for its own instruction set, whatever the flags of the translation
+// unit, so that _fpdt_detectISA() can select them; MSVC emits any instruction set without being asked. GCC fuses
+// multiplies & adds wherever FMA is enabled, so in a translation unit without it, where the scalar paths are not
+// fused, the kernels are kept from fusing them too
+#if defined(__GNUC__) && !defined(__clang__) && !defined(__FMA__)
+#define _FPDT_TARGET_(isa) __attribute__((target(isa), optimize("fp-contract=off")))
+#elif defined(__GNUC__)
+#define _FPDT_TARGET_(isa) __attribute__((target(isa)))
+#endif
+#ifdef _FPDT_TARGET_
+#define _FPDT_TARGET_AVX2_ _FPDT_TARGET_("avx2,fma,f16c")
+#define _FPDT_TARGET_AVX512_ _FPDT_TARGET_("avx2,fma,f16c,avx512f,avx512bw,avx512dq,avx512vl")
+#else
+#define _FPDT_TARGET_AVX2_
+#define _FPDT_TARGET_AVX512_
+#endif
+
+// Which kernel sets this compiler can emit
+#if defined(_MSC_VER) || defined(__GNUC__) || (defined(__AVX2__) && defined(__FMA__) && defined(__F16C__))
+#define _FPDT_KERNELS_AVX2_
+#endif
+#if defined(_MSC_VER) || defined(__GNUC__) || (defined(_FPDT_KERNELS_AVX2_) && defined(_FPDT_AVX512_ENABLED_))
+#define _FPDT_KERNELS_AVX512_
+#endif
+#if defined(_MSC_VER) || defined(__AVX512VNNI__)
+#define _FPDT_KERNELS_VNNI_
+#endif
+#if defined(_MSC_VER) || defined(__AVX512BF16__)
+#define _FPDT_KERNELS_BF16_
+#endif
+#if defined(_MSC_VER) || defined(__AVX512FP16__)
+#define _FPDT_KERNELS_FP16_
+#endif
+
+#ifdef _FPDT_KERNELS_AVX2_
+#define _FPDT_AVX2_KERNEL_(name) name##AVX2
+#else
+#define _FPDT_AVX2_KERNEL_(name) name##SSE
+#endif
+#ifdef _FPDT_KERNELS_AVX512_
+#define _FPDT_AVX512_KERNEL_(name) name##AVX512
+#else
+#define _FPDT_AVX512_KERNEL_(name) _FPDT_AVX2_KERNEL_(name)
+#endif
+
+// Initialiser for a kernel table indexed by FPDT_ISA_*; missing kernel sets fall back to the next-narrower one
+#define _FPDT_KERNELS_(name) { name##SSE, _FPDT_AVX2_KERNEL_(name), _FPDT_AVX512_KERNEL_(name) }
+
+// As _FPDT_KERNELS_(), for kernels templated on a rounding mode; one row per FPDT_ROUND_* mode
+#define _FPDT_KERNELS_T_(name, arg) { name##SSE<arg>, _FPDT_AVX2_KERNEL_(name)<arg>, _FPDT_AVX512_KERNEL_(name)<arg> }
+#define _FPDT_ROUNDED_KERNELS_(name) { _FPDT_KERNELS_T_(name, 0), _FPDT_KERNELS_T_(name, 1), _FPDT_KERNELS_T_(name, 2) }
+
+static inline void _fpdt_cpuid(si32 (&info)[4], csi32 leaf, csi32 subleaf) {
+#ifdef _MSC_VER
+   __cpuidex(info, leaf, subleaf);
+#else
+   __cpuid_count(leaf, subleaf, info[0], info[1], info[2], info[3]);
+#endif
+}
+
+static inline cui64 _fpdt_xgetbv(void) {
+#ifdef _MSC_VER
+   return _xgetbv(0);
+#else
+   ui32 lo, hi;
+
+   __asm__ volatile ("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+   return (ui64(hi) << 32) | lo;
+#endif
+}
+
+// Query the CPU & operating system for supported features
+static inline cui32 _fpdt_detectCPU(void) {
+   si32 info[4];
+   ui32 features = 0;
+
+   _fpdt_cpuid(info, 0, 0);
+   csi32 maxLeaf = info[0];
+
+   _fpdt_cpuid(info, 1, 0);
+   if ((info[2] & (1 << 9)) && (info[2] & (1 << 19))) features |= FPDT_CPU_SSE41; // SSSE3 & SSE4.1
+   // AVX state must be enabled by the OS (OSXSAVE, then XCR0 bits 1 & 2) before any AVX feature is usable
+   if (!(info[2] & (1 << 27)) || !(info[2] & (1 << 28)) || (_fpdt_xgetbv() & 0x06) != 0x06) return features;
+   if (info[2] & (1 << 12)) features |= FPDT_CPU_FMA;
+   if (info[2] & (1 << 29)) features |= FPDT_CPU_F16C;
+   if (maxLeaf < 7) return features;
+
+   _fpdt_cpuid(info, 7, 0);
+   csi32 maxSubleaf = info[0];
+
+   if (info[1] & (1 << 5)) features |= FPDT_CPU_AVX2;
+   if (info[1] & (1 << 8)) features |= FPDT_CPU_BMI2;
+   // AVX512F, DQ, BW, & VL, plus opmask & upper ZMM state (XCR0 bits 5~7)
+   if ((ui32(info[1]) & 0x0C0030000u) == 0x0C0030000u && (_fpdt_xgetbv() & 0x0E0) == 0x0E0) features |= FPDT_CPU_AVX512;
+   if ((features & FPDT_CPU_AVX512) && (info[2] & (1 << 11))) features |= FPDT_CPU_VNNI;
+   if ((features & FPDT_CPU_AVX512) && (info[3] & (1 << 23))) features |= FPDT_CPU_FP16;
+   if (!(features & FPDT_CPU_AVX512) || maxSubleaf < 1) return features;
+
+   _fpdt_cpuid(info, 7, 1);
+   if (info[0] & (1 << 5)) features |= FPDT_CPU_BF16;
+
+   return features;
+}
+
+// Size assumed when the host does not report its caches
+#define _FPDT_CACHE_DEFAULT_ 0x0800000
+
+// Bytes of the largest data or unified cache, from the deterministic cache parameters of Intel (leaf 4) or AMD
+// (leaf 0x8000001D) CPUs; 0 if neither is reported
+static inline csize_t _fpdt_detectCache(void) {
+   si32 info[4];
+   size_t largest = 0;
+
+   _fpdt_cpuid(info, 0, 0);
+   csi32 maxLeaf = info[0];
+
+   _fpdt_cpuid(info, si32(0x080000000), 0);
+   cui32 maxExtended = ui32(info[0]);
+
+   cui32 leaves[] = { 4u, 0x08000001Du };
+
+   for (cui32 leaf : leaves) {
+      if (largest || (leaf == 4u ? maxLeaf < 4 : maxExtended < leaf)) continue;
+      for (si32 index = 0; index < 16; index++) {
+         _fpdt_cpuid(info, si32(leaf), index);
+
+         cui32 type = ui32(info[0]) & 0x01F;
+         if (!type) break;
+         if (type == 2) continue; // Instruction cache
+
+         // (Ways + 1) * (partitions + 1) * (line size + 1) * (sets + 1)
+         csize_t bytes = size_t((ui32(info[1]) >> 22) + 1) * (((ui32(info[1]) >> 12) & 0x03FF) + 1) * ((ui32(info[1]) & 0x0FFF) + 1) * (size_t(ui32(info[2])) + 1);
+         if (bytes > largest) largest = bytes;
+      }
+   }
+   return largest;
+}
+
+// Widest instruction set that is both supported by the host & compiled in; the AVX2 & AVX512 kernels may also use FMA & F16C
+static inline cui32 _fpdt_detectISA(cui32 features) {
+   cui32 avx2 = FPDT_CPU_AVX2 | FPDT_CPU_FMA | FPDT_CPU_F16C;
+
+#ifdef _FPDT_KERNELS_AVX512_
+   if ((features & (avx2 | FPDT_CPU_AVX512)) == (avx2 | FPDT_CPU_AVX512)) return FPDT_ISA_AVX512;
+#endif
+#ifdef _FPDT_KERNELS_AVX2_
+   if ((features & avx2) == avx2) return FPDT_ISA_AVX2;
+#endif
+   return FPDT_ISA_SSE;
+}
+
+// Resolved on first use; ~0 means not yet detected
+inline vui32 __fpdt_cpu__ = ~0u;
+inline vui32 __fpdt_isa__ = ~0u;
+inline volatile size_t __fpdt_cache__ = 0; // 0 means not yet detected
+
+// Returns the CPU feature flags (FPDT_CPU_*) of the host
+inline cui32 fpdtCPUFeatures(void) {
+   ui32 features = __fpdt_cpu__;
+
+   if (features == ~0u) __fpdt_cpu__ = features = _fpdt_detectCPU();
+   return features;
+}
+
+// Returns the size in bytes of the last-level cache of the host
+inline csize_t fpdtCacheSize(void) {
+   size_t bytes = __fpdt_cache__;
+
+   if (!bytes) {
+      bytes = _fpdt_detectCache();
+      __fpdt_cache__ = bytes = bytes ? bytes : _FPDT_CACHE_DEFAULT_;
+   }
+   return bytes;
+}
+
+// Stops a program on a host without SSE4.1, rather than let it fault on the first kernel
+static inline void _fpdt_unsupportedCPU(void) {
+   fputs("Fixed-point kernels require a CPU with SSSE3 & SSE4.1\n", stderr);
+   abort();
+}
+
+// Returns the instruction set (FPDT_ISA_*) used by dispatched kernels
+inline cui32 fpdtISA(void) {
+#ifdef FPDT_NO_DISPATCH
+#if defined(_FPDT_AVX512_ENABLED_)
+   return FPDT_ISA_AVX512;
+#elif defined(__AVX2__)
+   return FPDT_ISA_AVX2;
+#else
+   return FPDT_ISA_SSE;
+#endif
+#else
+   ui32 isa = __fpdt_isa__;
+
+   if (isa == ~0u) {
+      cui32 features = fpdtCPUFeatures();
+
+      if (!(features & FPDT_CPU_SSE41)) _fpdt_unsupportedCPU();
+      __fpdt_isa__ = isa = _fpdt_detectISA(features);
+   }
+   return isa;
+#endif
+}
+
+// Limit dispatched kernels to an instruction set (FPDT_ISA_*), capped to the widest the host supports
+inline void fpdtSetISA(cui32 isa) {
+   cui32 widest = _fpdt_detectISA(fpdtCPUFeatures());
+
+   __fpdt_isa__ = isa < widest ? isa : widest;
+}
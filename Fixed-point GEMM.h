@@ -0,0 +1,345 @@
+/**********************************************************************
+ * File: Fixed-point GEMM.h                       Created: 2024/07/15 *
+ *                                          Last modified: 2024/07/26 *
+ *                                                                    *
+ * Desc: Matrix multiplies of 8-bit normalised codes, with an origin  *
+ *       & step per row, computed as integer products summed in       *
+ *       32-bit lanes; the ranges are applied once per result, in the *
+ *       epilogue, so the matrices are never decoded to floats.       *
+ *                                                                    *
+ * Notes: fpdtGemm() computes A * B^T, with B stored as n rows of k   *
+ *        codes, as weights usually are; every tile then reads rows   *
+ *        of both matrices in place, without packing.                 *
+ *        Tiles of MR rows of A by NR rows of B are summed in         *
+ *        registers over blocks of _FPDT_GEMM_KC_ codes, which keep   *
+ *        the rows of a tile in L1, for panels of _FPDT_GEMM_NC_ rows *
+ *        of B, which stay in L2, & bands of _FPDT_GEMM_MC_ rows of A;*
+ *        the running sums of a band are kept in an integer buffer,   *
+ *        & converted into dest in the epilogue.                      *
+ *        Products are exact integers over each 65536 codes of k.     *
+ *        Rows of the result are split among threads. Codes are       *
+ *        multiplied as in the dot products, with madd_epi16, or with *
+ *        vpdpbusd when AVX512-VNNI is present.                       *
+ *                                                                    *
+ * MIT license.                     Copyright (c) David William Bull. *
+ **********************************************************************/
+#pragma once
+
+#include <thread>
+#include "Fixed-point bulk conversion.h"
+#include "Fixed-point dot product.h"
+
+#define _FIXED_POINT_GEMM_
+
+// Codes of k per block, rows of B per panel, & rows of A per band; bands are whole tiles
+#define _FPDT_GEMM_KC_ 1024
+#define _FPDT_GEMM_NC_ 256
+#define _FPDT_GEMM_MC_ 64
+
+// Multiply-adds below which one thread is used
+#define _FPDT_GEMM_SERIAL_ (1 << 21)
+
+/******************
+ *  Tile kernels  *
+ ******************/
+
+// Each kernel stores the sums of a[r][i] * b[c][i] over kc codes in tile[r * NR + c]; flip kernels store the sums of a[r][i] * (b[c][i] - 128)
+
+// Sum of four 32-bit lanes, wrapping
+static inline cui32 _fpdt_hadd32(csi128 sums) {
+   csi128 pairs = _mm_add_epi32(sums, _mm_shuffle_epi32(sums, 0x4E));
+
+   return ui32(_mm_cvtsi128_si32(_mm_add_epi32(pairs, _mm_shuffle_epi32(pairs, 0xB1))));
+}
+
+struct _fpdt_tile8SSE {
+   static constexpr ui32 MR = 2, NR = 2;
+   static constexpr bool flip = false;
+
+   static inline void kernel(ui32 *tile, cui8 *const *a, cui8 *const *b, csize_t kc) {
+      csi128 zero = _mm_setzero_si128();
+      si128 acc[MR][NR] = {};
+      size_t i = 0;
+
+      for (; i + 16 <= kc; i += 16) {
+         si128 x[MR][2], y[NR][2];
+
+         for (ui32 r = 0; r < MR; r++) {
+            csi128 codes = _mm_loadu_si128((csi128 *)&a[r][i]);
+
+            x[r][0] = _mm_unpacklo_epi8(codes, zero); x[r][1] = _mm_unpackhi_epi8(codes, zero);
+         }
+         for (ui32 c = 0; c < NR; c++) {
+            csi128 codes = _mm_loadu_si128((csi128 *)&b[c][i]);
+
+            y[c][0] = _mm_unpacklo_epi8(codes, zero); y[c][1] = _mm_unpackhi_epi8(codes, zero);
+         }
+         for (ui32 r = 0; r < MR; r++)
+            for (ui32 c = 0; c < NR; c++) acc[r][c] = _mm_add_epi32(acc[r][c], _mm_add_epi32(_mm_madd_epi16(x[r][0], y[c][0]), _mm_madd_epi16(x[r][1], y[c][1])));
+      }
+      for (ui32 r = 0; r < MR; r++)
+         for (ui32 c = 0; c < NR; c++) {
+            ui32 sum = _fpdt_hadd32(acc[r][c]);
+
+            for (size_t t = i; t < kc; t++) sum += ui32(a[r][t]) * ui32(b[c][t]);
+            tile[r * NR + c] = sum;
+         }
+   }
+};
+
+#ifdef _FPDT_KERNELS_AVX2_
+struct _fpdt_tile8AVX2 {
+   static constexpr ui32 MR = 2, NR = 4;
+   static constexpr bool flip = false;
+
+   static inline _FPDT_TARGET_AVX2_ void kernel(ui32 *tile, cui8 *const *a, cui8 *const *b, csize_t kc) {
+      si256 acc[MR][NR] = {};
+      size_t i = 0;
+
+      for (; i + 16 <= kc; i += 16) {
+         si256 x[MR], y[NR];
+
+         for (ui32 r = 0; r < MR; r++) x[r] = _mm256_cvtepu8_epi16(_mm_loadu_si128((csi128 *)&a[r][i]));
+         for (ui32 c = 0; c < NR; c++) y[c] = _mm256_cvtepu8_epi16(_mm_loadu_si128((csi128 *)&b[c][i]));
+         for (ui32 r = 0; r < MR; r++)
+            for (ui32 c = 0; c < NR; c++) acc[r][c] = _mm256_add_epi32(acc[r][c], _mm256_madd_epi16(x[r], y[c]));
+      }
+      for (ui32 r = 0; r < MR; r++)
+         for (ui32 c = 0; c < NR; c++) {
+            ui32 sum = _fpdt_hadd32(_mm_add_epi32(_mm256_castsi256_si128(acc[r][c]), _mm256_extracti128_si256(acc[r][c], 1)));
+
+            for (size_t t = i; t < kc; t++) sum += ui32(a[r][t]) * ui32(b[c][t]);
+            tile[r * NR + c] = sum;
+         }
+   }
+};
+#endif
+
+#ifdef _FPDT_KERNELS_AVX512_
+struct _fpdt_tile8AVX512 {
+   static constexpr ui32 MR = 4, NR = 4;
+   static constexpr bool flip = false;
+
+   static inline _FPDT_TARGET_AVX512_ void kernel(ui32 *tile, cui8 *const *a, cui8 *const *b, csize_t kc) {
+      si512 acc[MR][NR] = {};
+
+      // Masked-off codes load as 0, so add nothing
+      for (size_t i = 0; i < kc; i += 32) {
+         const __mmask32 mask = kc - i < 32 ? __mmask32((1u << (kc - i)) - 1u) : __mmask32(0x0FFFFFFFF);
+         si512 x[MR], y[NR];
+
+         for (ui32 r = 0; r < MR; r++) x[r] = _mm512_cvtepu8_epi16(_mm256_maskz_loadu_epi8(mask, &a[r][i]));
+         for (ui32 c = 0; c < NR; c++) y[c] = _mm512_cvtepu8_epi16(_mm256_maskz_loadu_epi8(mask, &b[c][i]));
+         for (ui32 r = 0; r < MR; r++)
+            for (ui32 c = 0; c < NR; c++) acc[r][c] = _mm512_add_epi32(acc[r][c], _mm512_madd_epi16(x[r], y[c]));
+      }
+      for (ui32 r = 0; r < MR; r++)
+         for (ui32 c = 0; c < NR; c++) tile[r * NR + c] = ui32(_mm512_reduce_add_epi32(acc[r][c]));
+   }
+};
+#endif
+
+#ifdef _FPDT_KERNELS_VNNI_
+// vpdpbusd multiplies unsigned by signed bytes, so codes of b are flipped to b - 128; the epilogue adds back 128 * the row sums of a
+struct _fpdt_tile8VNNI {
+   static constexpr ui32 MR = 4, NR = 4;
+   static constexpr bool flip = true;
+
+   static inline void kernel(ui32 *tile, cui8 *const *a, cui8 *const *b, csize_t kc) {
+      csi512 flipBits = _mm512_set1_epi8(-128);
+      si512 acc[MR][NR] = {};
+
+      // Masked-off codes of a load as 0, so add nothing
+      for (size_t i = 0; i < kc; i += 64) {
+         const __mmask64 mask = kc - i < 64 ? __mmask64((1ull << (kc - i)) - 1ull) : __mmask64(~0ull);
+         si512 x[MR], y[NR];
+
+         for (ui32 r = 0; r < MR; r++) x[r] = _mm512_maskz_loadu_epi8(mask, &a[r][i]);
+         for (ui32 c = 0; c < NR; c++) y[c] = _mm512_xor_si512(_mm512_maskz_loadu_epi8(mask, &b[c][i]), flipBits);
+         for (ui32 r = 0; r < MR; r++)
+            for (ui32 c = 0; c < NR; c++) acc[r][c] = _mm512_dpbusd_epi32(acc[r][c], x[r], y[c]);
+      }
+      for (ui32 r = 0; r < MR; r++)
+         for (ui32 c = 0; c < NR; c++) tile[r * NR + c] = ui32(_mm512_reduce_add_epi32(acc[r][c]));
+   }
+};
+#endif
+
+/*************
+ *  Drivers  *
+ *************/
+
+// Operands shared by every thread of one multiply; step & origin of row r are step[r * inc] & origin[r * inc]
+struct _fpdt_gemm8Job {
+   fl32 *dest;
+   cui8 *a, *b;
+   csize_t n, k;
+   cfl32 *aOrigin, *aStep;
+   csize_t aInc;
+   cfl32 *bOrigin, *bStep;
+   csize_t bInc;
+   cfl32 *bTerms; // Per 65536 codes of k, bStep * (sum of the codes of B's row) + codes * bOrigin, for each row of B
+};
+
+// Sum of count codes
+static inline cui32 _fpdt_sum8(cui8 *src, csize_t count) {
+   ui32 sum = 0;
+
+   for (size_t i = 0; i < count; i++) sum += src[i];
+   return sum;
+}
+
+// Integer products of rows rowBegin~rowEnd of A with every row of B, over depth codes from each row's start; sums[r * n + c]
+template<typename Tile> static inline void _fpdt_gemm8Sums(ui32 *sums, cui8 *a, cui8 *b, csize_t n, csize_t k, csize_t rowBegin, csize_t rowEnd, csize_t depth) {
+   constexpr ui32 MR = Tile::MR, NR = Tile::NR;
+   __declspec(align(64)) ui32 tile[MR * NR];
+   cui8 *rowsA[MR], *rowsB[NR];
+
+   for (size_t pc = 0; pc < depth; pc += _FPDT_GEMM_KC_) {
+      csize_t kc = depth - pc < _FPDT_GEMM_KC_ ? depth - pc : _FPDT_GEMM_KC_;
+
+      for (size_t jc = 0; jc < n; jc += _FPDT_GEMM_NC_) {
+         csize_t jEnd = n - jc < _FPDT_GEMM_NC_ ? n : jc + _FPDT_GEMM_NC_;
+
+         for (size_t ir = rowBegin; ir < rowEnd; ir += MR) {
+            csize_t mr = rowEnd - ir < MR ? rowEnd - ir : MR;
+
+            // Rows past the end repeat the last row; their sums are discarded
+            for (ui32 r = 0; r < MR; r++) rowsA[r] = &a[(ir + (r < mr ? r : mr - 1)) * k + pc];
+            for (size_t jr = jc; jr < jEnd; jr += NR) {
+               csize_t nr = jEnd - jr < NR ? jEnd - jr : NR;
+
+               for (ui32 c = 0; c < NR; c++) rowsB[c] = &b[(jr + (c < nr ? c : nr - 1)) * k + pc];
+               Tile::kernel(tile, rowsA, rowsB, kc);
+               for (size_t r = 0; r < mr; r++) {
+                  ui32 *row = &sums[(ir - rowBegin + r) * n + jr];
+
+                  for (size_t c = 0; c < nr; c++) row[c] = pc ? row[c] + tile[r * NR + c] : tile[r * NR + c];
+               }
+            }
+         }
+      }
+   }
+}
+
+// Rows rowBegin~rowEnd of the result, a band at a time; the integer sums of a band over each 65536 codes of k are
+// kept in scratch, & the epilogue converts them to floats & adds them to dest
+template<typename Tile> static inline void _fpdt_gemm8Rows(const _fpdt_gemm8Job &job, csize_t rowBegin, csize_t rowEnd) {
+   csize_t n = job.n, k = job.k;
+   csize_t band = rowEnd - rowBegin < _FPDT_GEMM_MC_ ? rowEnd - rowBegin : _FPDT_GEMM_MC_;
+   ui32 *scratch = (ui32 *)_mm_malloc(band * n * sizeof(ui32), 64);
+
+   for (size_t ic = rowBegin; ic < rowEnd; ic += _FPDT_GEMM_MC_) {
+      csize_t icEnd = rowEnd - ic < _FPDT_GEMM_MC_ ? rowEnd : ic + _FPDT_GEMM_MC_;
+
+      for (size_t pc = 0, chunk = 0; pc < k; pc += _FPDT_DOT8_BLOCK_, chunk++) {
+         csize_t depth = k - pc < _FPDT_DOT8_BLOCK_ ? k - pc : _FPDT_DOT8_BLOCK_;
+         cfl32 *terms = &job.bTerms[chunk * n];
+
+         _fpdt_gemm8Sums<Tile>(scratch, &job.a[pc], &job.b[pc], n, k, ic, icEnd, depth);
+
+         // Epilogue: A(r) * B(c) = aStep * (bStep * sum + bOrigin * sum of A's codes) + aOrigin * terms(c)
+         for (size_t r = ic; r < icEnd; r++) {
+            cui32 sumA = _fpdt_sum8(&job.a[r * k + pc], depth);
+            cui32 bias = Tile::flip ? sumA * 128u : 0;
+            cfl32 aStep = job.aStep[r * job.aInc], aOrigin = job.aOrigin[r * job.aInc], fSumA = fl32(sumA);
+            cui32 *row = &scratch[(r - ic) * n];
+            fl32 *out = &job.dest[r * n];
+
+            for (size_t c = 0; c < n; c++) {
+               cfl32 value = aStep * (job.bStep[c * job.bInc] * fl32(ui32(row[c] + bias)) + job.bOrigin[c * job.bInc] * fSumA) + aOrigin * terms[c];
+
+               out[c] = pc ? out[c] + value : value;
+            }
+         }
+      }
+   }
+   _mm_free(scratch);
+}
+
+// Split the rows of the result among threads, in whole tiles
+template<typename Tile> static inline void _fpdt_gemm8Run(const _fpdt_gemm8Job &job, csize_t m, cui32 threads) {
+   csize_t perThread = ((m + threads - 1) / threads + Tile::MR - 1) / Tile::MR * Tile::MR;
+   std::thread *workers = threads > 1 ? new std::thread[threads - 1] : nullptr;
+   ui32 spawned = 0;
+
+   for (size_t begin = perThread; begin < m && spawned < threads - 1; begin += perThread, spawned++)
+      workers[spawned] = std::thread(_fpdt_gemm8Rows<Tile>, std::cref(job), begin, m - begin < perThread ? m : begin + perThread);
+   _fpdt_gemm8Rows<Tile>(job, 0, m < perThread ? m : perThread);
+   for (ui32 t = 0; t < spawned; t++) workers[t].join();
+   delete[] workers;
+}
+
+static decltype(&_fpdt_gemm8Run<_fpdt_tile8SSE>) const _fpdt_gemm8ISA[] = { _fpdt_gemm8Run<_fpdt_tile8SSE>, _fpdt_gemm8Run<_FPDT_AVX2_KERNEL_(_fpdt_tile8)>, _fpdt_gemm8Run<_FPDT_AVX512_KERNEL_(_fpdt_tile8)> };
+
+static inline void _fpdt_gemm8(fl32 *dest, cui8 *a, cfl32 *aOrigin, cfl32 *aStep, csize_t aInc, cui8 *b, cfl32 *bOrigin, cfl32 *bStep, csize_t bInc, csize_t m, csize_t n, csize_t k, ui32 threads) {
+   if (!m || !n) return;
+   if (!k) { for (size_t i = 0; i < m * n; i++) dest[i] = 0.0f; return; }
+
+   // Terms of each row of B that the epilogue scales by aOrigin, per 65536 codes of k
+   csize_t chunks = (k + _FPDT_DOT8_BLOCK_ - 1) / _FPDT_DOT8_BLOCK_;
+   fl32 *bTerms = (fl32 *)_mm_malloc(chunks * n * sizeof(fl32), 64);
+
+   for (size_t pc = 0, chunk = 0; pc < k; pc += _FPDT_DOT8_BLOCK_, chunk++) {
+      csize_t depth = k - pc < _FPDT_DOT8_BLOCK_ ? k - pc : _FPDT_DOT8_BLOCK_;
+
+      for (size_t c = 0; c < n; c++) bTerms[chunk * n + c] = bStep[c * bInc] * fl32(_fpdt_sum8(&b[c * k + pc], depth)) + fl32(depth) * bOrigin[c * bInc];
+   }
+
+   if (!threads) threads = std::thread::hardware_concurrency();
+   if (!threads || fl64(m) * fl64(n) * fl64(k) < fl64(_FPDT_GEMM_SERIAL_)) threads = 1;
+   if (threads > m) threads = ui32(m);
+
+   const _fpdt_gemm8Job job = { dest, a, b, n, k, aOrigin, aStep, aInc, bOrigin, bStep, bInc, bTerms };
+   cui32 isa = fpdtISA();
+
+#ifdef _FPDT_KERNELS_VNNI_
+   if (isa == FPDT_ISA_AVX512 && (fpdtCPUFeatures() & FPDT_CPU_VNNI)) _fpdt_gemm8Run<_fpdt_tile8VNNI>(job, m, threads);
+   else
+#endif
+   _fpdt_gemm8ISA[isa](job, m, threads);
+   _mm_free(bTerms);
+}
+
+/*********************
+ *  Matrix multiply  *
+ *********************/
+
+// dest[i * n + j] = sum over k codes of A(i, x) * B(j, x), for A of m rows & B of n rows, each of k codes stored one after another; row r of A decodes as aOrigin[r] + aStep[r] * code, & likewise for B
+// threads of 0 uses every hardware thread; small multiplies use one thread
+inline void fpdtGemm(fl32 *dest, cui8 *a, cfl32 *aOrigin, cfl32 *aStep, cui8 *b, cfl32 *bOrigin, cfl32 *bStep, csize_t m, csize_t n, csize_t k, cui32 threads = 0) {
+   _fpdt_gemm8(dest, a, aOrigin, aStep, 1, b, bOrigin, bStep, 1, m, n, k, threads);
+}
+
+static cfl32 _fpdt_gemmZero = 0.0f;
+
+inline void fpdtGemm(fl32 *dest, const fp8n0_1 *a, const fp8n0_1 *b, csize_t m, csize_t n, csize_t k, cui32 threads = 0) {
+   _fpdt_gemm8(dest, (cui8 *)a, &_fpdt_gemmZero, &_fpdt_rcp255f, 0, (cui8 *)b, &_fpdt_gemmZero, &_fpdt_rcp255f, 0, m, n, k, threads);
+}
+
+#ifndef FPDT_NO_CUSTOM
+// Both matrices use the current range
+inline void fpdtGemm(fl32 *dest, const fp8n *a, const fp8n *b, csize_t m, csize_t n, csize_t k, cui32 threads = 0) {
+   cfl32 origin = __fpdt_data__.origin8, step = __fpdt_data__.rangeDivMax8;
+
+   _fpdt_gemm8(dest, (cui8 *)a, &origin, &step, 0, (cui8 *)b, &origin, &step, 0, m, n, k, threads);
+}
+#endif
+
+// Quantise rows of cols floats to 8-bit codes, fitting each row's own range; origin[r] & step[r] receive row r's range, as fpdtGemm() takes them
+inline void fpdtToFixedRows(ui8 *dest, fl32 *origin, fl32 *step, cfl32 *src, csize_t rows, csize_t cols, cui32 round = FPDT_ROUND_TRUNCATE) {
+   cui32 isa = fpdtISA();
+
+   for (size_t r = 0; r < rows; r++) {
+      fl32 lo = 3.402823466e+38f, hi = -3.402823466e+38f;
+
+      _fpdt_minMax32ISA[isa](&src[r * cols], cols, lo, hi);
+      if (!(lo <= hi)) lo = hi = 0.0f;
+      cfl32 scale = _fpdt_fitScale(lo, hi, 255.0f);
+
+      // The step is the reciprocal of the scale encoded with, which _fpdt_fitScale() may have lowered from 255 / range
+      origin[r] = lo;
+      step[r] = scale ? 1.0f / scale : 0.0f;
+      _fpdt_encode8ISA[round][isa](&dest[r * cols], &src[r * cols], cols, -lo, scale);
+   }
+}
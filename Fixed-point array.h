@@ -0,0 +1,242 @@
+/**********************************************************************
+ * File: Fixed-point array.h                      Created: 2024/07/11 *
+ *                                          Last modified: 2024/07/26 *
+ *                                                                    *
+ * Desc: FixedArray<T>, an owning array of any 8, 16, or 32-bit       *
+ *       fixed-point type, with whole-array operators. +, -, clamp(), *
+ *       & the multiply of Q-formats run on integer SIMD lanes; other *
+ *       multiplies, divides, & scale() decode blocks to floats with  *
+ *       the bulk conversion kernels, then encode the results.        *
+ *                                                                    *
+ * Notes: Storage is 64-byte aligned & padded to a multiple of 64     *
+ *        bytes, so every loop reads whole registers; the last one is *
+ *        stored only up to count, so padding always has code 0.      *
+ *        Results match the element type's own scalar operators,      *
+ *        except that - adds back the code of 0.0, as the generated   *
+ *        types do, where some hand-written types subtract it.        *
+ *        Binary operators cover the shorter operand's elements.      *
+ *        Types with a user-definable range use the current range.    *
+ *        Q-formats divide element by element, as there is no SIMD    *
+ *        integer divide. 24-bit types are not supported.             *
+ *                                                                    *
+ * MIT license.                     Copyright (c) David William Bull. *
+ **********************************************************************/
+#pragma once
+
+#include <cstring>
+#include "Fixed-point templates.h"
+
+#define _FIXED_POINT_ARRAY_
+
+// Lane layout of each element type: its code of 0.0, & for Q-formats, fraction bits & sign; frac < 0 multiplies as floats
+template<typename T> struct _fpdt_lanes;
+
+#define _FPDT_LANES_(name, size, fraction, isSigned, bias) template<> struct _fpdt_lanes<name> { \
+   typedef _fpdt_code<size>::type code; typedef _fpdt_code<size>::fl fl; \
+   static constexpr si32 frac = fraction; static constexpr bool sign = isSigned; \
+   static inline csi64 zero(void) { return si64(bias); } };
+
+#ifndef FPDT_NO_CUSTOM
+_FPDT_LANES_(fp8n, 8, -1, false, ui8(__fpdt_data__.origin8 * __fpdt_data__.maxDivRange8))
+_FPDT_LANES_(fp16n, 16, -1, false, ui16(__fpdt_data__.origin16 * __fpdt_data__.maxDivRange16))
+_FPDT_LANES_(fp32n, 32, -1, false, ui32(__fpdt_data__.origin32 * __fpdt_data__.maxDivRange32))
+#endif
+_FPDT_LANES_(f0p8, 8, 8, false, 0)
+_FPDT_LANES_(f1p7, 8, 7, false, 0)
+_FPDT_LANES_(f4p4, 8, 4, false, 0)
+_FPDT_LANES_(fp8n0_1, 8, -1, false, 0)
+_FPDT_LANES_(f0p16, 16, 16, false, 0)
+_FPDT_LANES_(fs1p14, 16, 14, true, 32768)
+_FPDT_LANES_(f1p15, 16, 15, false, 0)
+_FPDT_LANES_(f6p10, 16, 10, false, 0)
+_FPDT_LANES_(fs7p8, 16, 8, true, 32768)
+_FPDT_LANES_(f7p9, 16, 9, false, 0)
+_FPDT_LANES_(f8p8, 16, 8, false, 0)
+_FPDT_LANES_(fp16n0_1, 16, -1, false, 0)
+_FPDT_LANES_(fp16n0_2, 16, -1, false, 0)
+_FPDT_LANES_(fp16n0_3, 16, -1, false, 0)
+_FPDT_LANES_(fp16n0_128, 16, -1, false, 0)
+_FPDT_LANES_(fp16n_1_1, 16, -1, false, 32767)
+_FPDT_LANES_(fp16n_128_128, 16, -1, false, 32767)
+_FPDT_LANES_(f0p32, 32, 32, false, 0)
+_FPDT_LANES_(f16p16, 32, 16, false, 0)
+_FPDT_LANES_(fp32n0_1, 32, -1, false, 0)
+_FPDT_LANES_(fp32n_1_1, 32, -1, false, 2147483647)
+
+// Generated types carry their layout as members
+template<typename T> requires requires { T::zero; T::scale; } struct _fpdt_lanes<T> {
+   typedef typename T::code code; typedef typename T::fl fl;
+   static constexpr si32 frac = [] { if constexpr (requires { T::frac; }) return si32(T::frac); else return si32(-1); }();
+   static constexpr bool sign = T::zero != 0;
+   static inline csi64 zero(void) { return T::zero; }
+};
+
+// Clamp each unsigned lane to lo~hi
+template<cui32 bits> static inline csi128 _fpdt_vclamp(csi128 a, cui32 lo, cui32 hi) {
+   if constexpr (bits == 8) return _mm_min_epu8(_mm_max_epu8(a, _mm_set1_epi8(si8(lo))), _mm_set1_epi8(si8(hi)));
+   else if constexpr (bits == 16) return _mm_min_epu16(_mm_max_epu16(a, _mm_set1_epi16(si16(lo))), _mm_set1_epi16(si16(hi)));
+   else return _mm_min_epu32(_mm_max_epu32(a, _mm_set1_epi32(si32(lo))), _mm_set1_epi32(si32(hi)));
+}
+
+#ifdef _FPDT_AVX2_
+template<cui32 bits> static inline csi256 _fpdt_vclamp(csi256 a, cui32 lo, cui32 hi) {
+   if constexpr (bits == 8) return _mm256_min_epu8(_mm256_max_epu8(a, _mm256_set1_epi8(si8(lo))), _mm256_set1_epi8(si8(hi)));
+   else if constexpr (bits == 16) return _mm256_min_epu16(_mm256_max_epu16(a, _mm256_set1_epi16(si16(lo))), _mm256_set1_epi16(si16(hi)));
+   else return _mm256_min_epu32(_mm256_max_epu32(a, _mm256_set1_epi32(si32(lo))), _mm256_set1_epi32(si32(hi)));
+}
+#endif
+
+/********************************
+ *  Aligned fixed-point arrays  *
+ ********************************/
+
+// Owning array of count elements of T, processed a register at a time
+template<typename T> struct FixedArray {
+   typedef _fpdt_lanes<T> lanes;
+   typedef typename lanes::code code; typedef typename lanes::fl fl;
+   typedef const T cT; typedef const fl cfl; typedef const FixedArray cFixedArray;
+
+   static constexpr ui32 bits = sizeof(code) << 3;
+   static constexpr ui32 block = 256; // Elements per float round trip
+   static_assert(sizeof(T) == sizeof(code) && (bits == 8 || bits == 16 || bits == 32), "FixedArray requires an 8, 16, or 32-bit scalar type");
+
+   T      *data = nullptr;
+   size_t  count = 0;
+
+   // Bytes allocated for count elements
+   static inline csize_t padded(csize_t count) { return (count * sizeof(T) + 63) & ~size_t(63); }
+
+   // Apply a lane operation to the first bytes of a & b, writing result; any of them may alias. The last, partial
+   // register is computed whole from the padding, but only its leading bytes are stored, so elements past the
+   // shorter operand's count keep their codes, & padding stays at code 0
+   template<typename Op> static inline void zip(T *result, const T *a, const T *b, csize_t bytes, Op op) {
+      size_t i = 0;
+
+#ifdef _FPDT_AVX2_
+      for (; i + 32 <= bytes; i += 32) _mm256_store_si256((si256 *)((ui8 *)result + i), op(_mm256_load_si256((csi256 *)((cui8 *)a + i)), _mm256_load_si256((csi256 *)((cui8 *)b + i))));
+      if (i < bytes) {
+         __declspec(align(32)) ui8 tail[32];
+
+         _mm256_store_si256((si256 *)tail, op(_mm256_load_si256((csi256 *)((cui8 *)a + i)), _mm256_load_si256((csi256 *)((cui8 *)b + i))));
+         memcpy((ui8 *)result + i, tail, bytes - i);
+      }
+#else
+      for (; i + 16 <= bytes; i += 16) _mm_store_si128((si128 *)((ui8 *)result + i), op(_mm_load_si128((csi128 *)((cui8 *)a + i)), _mm_load_si128((csi128 *)((cui8 *)b + i))));
+      if (i < bytes) {
+         __declspec(align(16)) ui8 tail[16];
+
+         _mm_store_si128((si128 *)tail, op(_mm_load_si128((csi128 *)((cui8 *)a + i)), _mm_load_si128((csi128 *)((cui8 *)b + i))));
+         memcpy((ui8 *)result + i, tail, bytes - i);
+      }
+#endif
+   }
+
+   // Decode blocks of a, & of b if any, apply op(x, y, n) to the floats in x, then encode x to result
+   template<typename Op> static inline void roundTrip(T *result, const T *a, const T *b, csize_t count, Op op) {
+      __declspec(align(64)) fl x[block], y[block];
+
+      for (size_t i = 0; i < count; i += block) {
+         csize_t n = count - i < block ? count - i : block;
+
+         fpdtToFloat(x, a + i, n);
+         if (b) fpdtToFloat(y, b + i, n);
+         op(x, (cfl *)y, n);
+         fpdtToFixed(result + i, (cfl *)x, n);
+      }
+   }
+
+   static inline void add(T *result, const T *a, const T *b, csize_t count) {
+      csi64 zero = lanes::zero();
+
+      zip(result, a, b, count * sizeof(T), [zero](auto x, auto y) { return _fpdt_vbias<bits>(_fpdt_vadd<bits>(x, y), zero); });
+   }
+   static inline void sub(T *result, const T *a, const T *b, csize_t count) {
+      csi64 zero = lanes::zero();
+
+      zip(result, a, b, count * sizeof(T), [zero](auto x, auto y) { return _fpdt_vbias<bits>(_fpdt_vsub<bits>(x, y), -zero); });
+   }
+   // Q-formats multiply in integer lanes, signed ones as two's complement
+   static inline void mul(T *result, const T *a, const T *b, csize_t count) {
+      if constexpr (lanes::frac >= 0)
+         zip(result, a, b, count * sizeof(T), [](auto x, auto y) {
+            if constexpr (lanes::sign) return _fpdt_vflip<bits>(_fpdt_vmul<bits, ui32(lanes::frac), true>(_fpdt_vflip<bits>(x), _fpdt_vflip<bits>(y)));
+            else return _fpdt_vmul<bits, ui32(lanes::frac), false>(x, y);
+         });
+      else roundTrip(result, a, b, count, [](fl *x, cfl *y, csize_t n) { for (size_t i = 0; i < n; i++) x[i] *= y[i]; });
+   }
+   static inline void div(T *result, const T *a, const T *b, csize_t count) {
+      if constexpr (lanes::frac >= 0) for (size_t i = 0; i < count; i++) result[i] = a[i] / b[i];
+      else roundTrip(result, a, b, count, [](fl *x, cfl *y, csize_t n) { for (size_t i = 0; i < n; i++) x[i] /= y[i]; });
+   }
+
+   FixedArray(void) = default;
+   explicit FixedArray(csize_t count) { resize(count); }
+   FixedArray(cT value, csize_t count) { resize(count); fill(value); }
+   FixedArray(cfl *values, csize_t count, cui32 round = FPDT_ROUND_TRUNCATE) { resize(count); toFixed(values, round); }
+   FixedArray(cFixedArray &value) { resize(value.count); memcpy(data, value.data, padded(count)); }
+   FixedArray(FixedArray &&value) { data = value.data; count = value.count; value.data = nullptr; value.count = 0; }
+   ~FixedArray(void) { _mm_free(data); }
+
+   inline FixedArray &operator=(cFixedArray &value) {
+      if (this != &value) { resize(value.count); memcpy(data, value.data, padded(count)); }
+      return *this;
+   }
+   inline FixedArray &operator=(FixedArray &&value) {
+      if (this != &value) { _mm_free(data); data = value.data; count = value.count; value.data = nullptr; value.count = 0; }
+      return *this;
+   }
+
+   // Change the element count, keeping existing elements; new elements & padding have code 0
+   inline void resize(csize_t newCount) {
+      csize_t bytes = padded(newCount), oldBytes = padded(count);
+
+      if (bytes != oldBytes) {
+         T *temp = bytes ? (T *)_mm_malloc(bytes, 64) : nullptr;
+
+         if (bytes) {
+            memset(temp, 0, bytes);
+            if (data) memcpy(temp, data, (newCount < count ? newCount : count) * sizeof(T));
+         }
+         _mm_free(data);
+         data = temp;
+      } else if (newCount < count) memset(data + newCount, 0, (count - newCount) * sizeof(T));
+      count = newCount;
+   }
+
+   inline csize_t size(void) const { return count; }
+   inline T *begin(void) { return data; }
+   inline T *end(void) { return data + count; }
+   inline const T *begin(void) const { return data; }
+   inline const T *end(void) const { return data + count; }
+   inline T &operator[](csize_t index) { return data[index]; }
+   inline cT &operator[](csize_t index) const { return data[index]; }
+
+   inline void fill(cT value) { for (size_t i = 0; i < count; i++) data[i] = value; }
+
+   // Encode count floats, or decode to count floats, with the bulk conversion kernels
+   inline void toFixed(cfl *values, cui32 round = FPDT_ROUND_TRUNCATE) { fpdtToFixed(data, values, count, round); }
+   inline void toFloat(fl *values) const { fpdtToFloat(values, (const T *)data, count); }
+
+   inline FixedArray operator+(cFixedArray &value) const { FixedArray result(value.count < count ? value.count : count); add(result.data, data, value.data, result.count); return result; }
+   inline FixedArray operator-(cFixedArray &value) const { FixedArray result(value.count < count ? value.count : count); sub(result.data, data, value.data, result.count); return result; }
+   inline FixedArray operator*(cFixedArray &value) const { FixedArray result(value.count < count ? value.count : count); mul(result.data, data, value.data, result.count); return result; }
+   inline FixedArray operator/(cFixedArray &value) const { FixedArray result(value.count < count ? value.count : count); div(result.data, data, value.data, result.count); return result; }
+   inline FixedArray &operator+=(cFixedArray &value) { add(data, data, value.data, value.count < count ? value.count : count); return *this; }
+   inline FixedArray &operator-=(cFixedArray &value) { sub(data, data, value.data, value.count < count ? value.count : count); return *this; }
+   inline FixedArray &operator*=(cFixedArray &value) { mul(data, data, value.data, value.count < count ? value.count : count); return *this; }
+   inline FixedArray &operator/=(cFixedArray &value) { div(data, data, value.data, value.count < count ? value.count : count); return *this; }
+
+   // Multiply every element by a float, as T's operator*=(float) does
+   inline FixedArray &scale(cfl value) {
+      roundTrip(data, data, nullptr, count, [value](fl *x, cfl *, csize_t n) { for (size_t i = 0; i < n; i++) x[i] *= value; });
+      return *this;
+   }
+
+   // Limit every element to floor~ceiling
+   inline FixedArray &clamp(cT floor, cT ceiling) {
+      cui32 lo = (cui32)floor.data, hi = (cui32)ceiling.data;
+
+      zip(data, data, data, count * sizeof(T), [lo, hi](auto x, auto) { return _fpdt_vclamp<bits>(x, lo, hi); });
+      return *this;
+   }
+};
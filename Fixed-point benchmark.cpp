@@ -0,0 +1,351 @@
+/**********************************************************************
+ * File: Fixed-point benchmark.cpp                Created: 2024/07/22 *
+ *                                          Last modified: 2024/07/26 *
+ *                                                                    *
+ * Desc: Micro-benchmarks of every fixed-point & vector type. Times   *
+ *       scalar toFixed & toFloat, the arithmetic operators, & every  *
+ *       bulk kernel at each instruction set the host supports, with  *
+ *       plain floats as a baseline, then the dot products, GEMM,     *
+ *       matrix transforms, colour & sRGB, PCM, block, & FixedArray   *
+ *       kernels. Prints CSV, one row per result:                     *
+ *       build,isa,type,lanes,operation,mode,elements,ns,gbps         *
+ *                                                                    *
+ * Notes: Build the same source with no /arch, /arch:AVX2, &          *
+ *        /arch:AVX512; the build column names the one compiled, &    *
+ *        applies to the scalar, operator, matrix multiply, &         *
+ *        FixedArray rows. Bulk rows run every dispatched kernel set, *
+ *        named in the isa column.                                    *
+ *        ns is per element, i.e. per lane of a vector type, or per   *
+ *        multiply-add of a GEMM; latency rows time a chain of        *
+ *        dependent operations, so ns is that of one operation; that  *
+ *        of toFixed+toFloat is one conversion each way. gbps counts  *
+ *        the bytes read & written.                                   *
+ *        The only argument is the element count of bulk kernels,     *
+ *        65536 by default; raise it past the caches for DRAM rates.  *
+ *                                                                    *
+ * MIT license.                     Copyright (c) David William Bull. *
+ **********************************************************************/
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <type_traits>
+#include "24-bit integers.h"
+#include "vector structures.h"
+#include "Fixed-point bulk conversion.h"
+#include "Half-precision conversion.h"
+#include "Fixed-point dot product.h"
+#include "Fixed-point GEMM.h"
+#include "Matrix transforms.h"
+#include "Fixed-point colour formats.h"
+#include "PCM audio conversion.h"
+#include "Fixed-point blocks.h"
+#include "Fixed-point array.h"
+
+fpdtInitCustom;
+
+#if defined(__AVX512F__)
+#define BENCH_BUILD "AVX512"
+#elif defined(__AVX2__)
+#define BENCH_BUILD "AVX2"
+#else
+#define BENCH_BUILD "SSE"
+#endif
+
+#define BENCH_VALUES  2048 // Values per operator pass, so that 3 arrays of any type stay in L1
+#define BENCH_CHAIN   1024 // Dependent operations per latency pass
+#define BENCH_SAMPLES 7    // Best of, to skip interrupts & clock ramps
+#define BENCH_REPS    (1u << 30) // Most repetitions of one body, should it take no measurable time
+#define BENCH_GEMM    256  // Rows & depth of the GEMM operands
+
+// Every type, with its lanes
+#define BENCH_TYPES(X) \
+   X(fp8n, 1) X(fp16n, 1) X(fp24n, 1) X(fp32n, 1) \
+   X(f0p8, 1) X(f1p7, 1) X(f4p4, 1) X(fp8n0_1, 1) \
+   X(f0p16, 1) X(fs1p14, 1) X(f1p15, 1) X(f6p10, 1) X(fs7p8, 1) X(f7p9, 1) X(f8p8, 1) \
+   X(fp16n0_1, 1) X(fp16n0_2, 1) X(fp16n0_3, 1) X(fp16n0_128, 1) X(fp16n_1_1, 1) X(fp16n_128_128, 1) \
+   X(f0p24, 1) X(f8p16, 1) X(f12p12, 1) X(f16p8, 1) X(fp24n0_1, 1) X(fp24n_1_1, 1) \
+   X(f0p32, 1) X(f16p16, 1) X(fp32n0_1, 1) X(fp32n_1_1, 1) \
+   X(fp8nx4, 4) X(fp16nx4, 4) X(fp8n0_1x4, 4) X(fs7p8x3, 3) X(f1p15x4, 4) X(fp16n0_1x4, 4) X(fp16n0_3x16, 16) \
+   X(f0p8x2, 2) X(f1p7x2, 2) X(f4p4x2, 2) X(fp8n0_1x2, 2) X(f0p16x2, 2) X(fs1p14x2, 2) X(f1p15x2, 2) \
+   X(f6p10x2, 2) X(fs7p8x2, 2) X(f7p9x2, 2) X(f8p8x2, 2) X(fp16n0_1x2, 2) X(fp16n_1_1x2, 2)
+
+static const char * const benchISA[] = { "SSE", "AVX2", "AVX512" };
+static const char * const benchRounding[] = { "fpdtToFixed truncate", "fpdtToFixed nearest", "fpdtToFixed stochastic" };
+
+static volatile ui64 benchSink; // Each pass stores a result here, so that no timed loop is optimised away
+static ui64 benchState = 0x09E3779B97F4A7C15ull;
+
+/*************
+ *  Helpers  *
+ *************/
+
+static inline cui64 benchRandom(void) { benchState ^= benchState << 13; benchState ^= benchState >> 7; benchState ^= benchState << 17; return benchState; }
+
+// Floats holding lanes values, for the scalar conversions of vector types
+template<cui32 lanes> struct benchFloats { typedef fl32 type; };
+template<> struct benchFloats<2> { typedef f32x2 type; };
+template<> struct benchFloats<3> { typedef fl32x4 type; };
+template<> struct benchFloats<4> { typedef fl32x4 type; };
+template<> struct benchFloats<16> { typedef f32x16 type; };
+
+// Floats of the bulk encode of T, 64-bit for the 32-bit types
+template<typename T> struct benchSource { typedef std::conditional_t<requires (T *dest, cfl32 *src) { fpdtToFixed(dest, src, csize_t(0)); }, fl32, fl64> type; };
+
+// count aligned T of random, non-zero bytes, so that integer divides see no zero divisor
+template<typename T> static T *benchCodes(csize_t count) {
+   T *data = (T *)_mm_malloc(count * sizeof(T) + 64, 64);
+
+   for (size_t i = 0; i < count * sizeof(T); i++) ((ui8 *)data)[i] = ui8(benchRandom() | 1);
+   return data;
+}
+
+// count aligned floats of 0.5~1.5, so that chains of multiplies & divides stay normal
+template<typename F> static F *benchFloatArray(csize_t count) {
+   F *data = (F *)_mm_malloc(count * sizeof(F) + 64, 64);
+
+   for (size_t i = 0; i < count; i++) data[i] = F(benchRandom() >> 40) * F(1.0 / 16777216.0) + F(0.5);
+   return data;
+}
+
+// Best time of BENCH_SAMPLES runs of body, in ns; each run repeats body until it lasts 1ms or more, or BENCH_REPS times
+template<class B> static cfl64 benchTime(B &&body) {
+   typedef std::chrono::steady_clock clock;
+   ui64 reps = 1;
+   fl64 best = 1e300;
+
+   for (;;) {
+      const auto start = clock::now();
+
+      for (ui64 i = 0; i < reps; i++) body();
+      if (std::chrono::duration<fl64, std::nano>(clock::now() - start).count() >= 1e6 || reps >= BENCH_REPS) break;
+      reps <<= 1;
+   }
+   for (ui32 sample = 0; sample < BENCH_SAMPLES; sample++) {
+      const auto start = clock::now();
+
+      for (ui64 i = 0; i < reps; i++) body();
+      cfl64 ns = std::chrono::duration<fl64, std::nano>(clock::now() - start).count() / reps;
+
+      best = ns < best ? ns : best;
+   }
+   return best;
+}
+
+// One CSV row; ns is the time of the whole pass, over elements, & bytes those moved by it
+static void benchRow(const char *isa, const char *type, cui32 lanes, const char *operation, const char *mode, csize_t elements, cfl64 ns, csize_t bytes) {
+   printf("%s,%s,%s,%u,%s,%s,%zu,%.4f,%.3f\n", BENCH_BUILD, isa, type, lanes, operation, mode, elements, ns / fl64(elements), fl64(bytes) / ns);
+   fflush(stdout);
+}
+
+/***************
+ *  Operators  *
+ ***************/
+
+// dest = op(a, b) over BENCH_VALUES values; the arrays never alias, so the loop vectorises as a caller's would
+template<typename D, typename S, class Op> static void benchMap(D *__restrict dest, const S *__restrict a, const S *__restrict b, Op op) {
+   for (ui32 i = 0; i < BENCH_VALUES; i++) dest[i] = op(a[i], b[i]);
+   benchSink = *(cui8 *)(dest + BENCH_VALUES - 1);
+}
+
+// Throughput of c = a op b, & latency of x = x op b, for each operator T has
+#define BENCH_OPERATOR(op, name) \
+   if constexpr (requires (T x, T y) { T(x op y); }) { \
+      benchRow(BENCH_BUILD, type, lanes, name, "throughput", BENCH_VALUES * lanes, \
+               benchTime([&] { benchMap(c, a, b, [](const T &x, const T &y) { return T(x op y); }); }), BENCH_VALUES * sizeof(T) * 3); \
+      benchRow(BENCH_BUILD, type, lanes, name, "latency", BENCH_CHAIN, \
+               benchTime([&] { T x = a[0]; for (ui32 i = 0; i < BENCH_CHAIN; i++) x = T(x op b[i & 15]); c[0] = x; benchSink = *(cui8 *)c; }), 0); \
+   }
+
+template<typename T, cui32 lanes> static void benchOperators(const char *type) {
+   typedef typename benchFloats<lanes>::type F;
+   T *a, *b, *c;
+
+   if constexpr (std::is_floating_point_v<T>) {
+      a = benchFloatArray<T>(BENCH_VALUES); b = benchFloatArray<T>(BENCH_VALUES); c = benchFloatArray<T>(BENCH_VALUES);
+      for (ui32 i = 8; i < 16; i++) b[i] = T(1) / b[i - 8]; // Latency chains of 16 multiplies return to x
+   } else { a = benchCodes<T>(BENCH_VALUES); b = benchCodes<T>(BENCH_VALUES); c = benchCodes<T>(BENCH_VALUES); }
+   F *f = (F *)_mm_malloc(BENCH_VALUES * sizeof(F), 64);
+
+   for (ui32 i = 0; i < BENCH_VALUES * sizeof(F) / sizeof(fl32); i++) ((fl32 *)f)[i] = fl32(benchRandom() >> 40) * (1.0f / 16777216.0f);
+   if constexpr (!std::is_floating_point_v<T> && requires (F value) { T(value); }) {
+      benchRow(BENCH_BUILD, type, lanes, "toFixed", "throughput", BENCH_VALUES * lanes,
+               benchTime([&] { benchMap(c, f, f, [](const F &x, const F &) { return T(x); }); }), BENCH_VALUES * (sizeof(F) + sizeof(T)));
+   }
+   if constexpr (!std::is_floating_point_v<T> && requires (T value) { static_cast<F>(value); }) {
+      benchRow(BENCH_BUILD, type, lanes, "toFloat", "throughput", BENCH_VALUES * lanes,
+               benchTime([&] { benchMap(f, a, a, [](const T &x, const T &) { return static_cast<F>(x); }); }), BENCH_VALUES * (sizeof(F) + sizeof(T)));
+   }
+   if constexpr (!std::is_floating_point_v<T> && requires (F value, T code) { T(value); static_cast<F>(code); }) {
+      benchRow(BENCH_BUILD, type, lanes, "toFixed+toFloat", "latency", BENCH_CHAIN,
+               benchTime([&] { F x = f[0]; for (ui32 i = 0; i < BENCH_CHAIN; i++) x = static_cast<F>(T(x)); f[1] = x; benchSink = *(cui8 *)&f[1]; }), 0);
+   }
+   BENCH_OPERATOR(+, "+") BENCH_OPERATOR(-, "-") BENCH_OPERATOR(*, "*") BENCH_OPERATOR(/, "/")
+   if constexpr (requires (T x) { T(-x); }) {
+      benchRow(BENCH_BUILD, type, lanes, "negate", "throughput", BENCH_VALUES * lanes,
+               benchTime([&] { benchMap(c, a, a, [](const T &x, const T &) { return T(-x); }); }), BENCH_VALUES * sizeof(T) * 2);
+   }
+   _mm_free(a); _mm_free(b); _mm_free(c); _mm_free(f);
+}
+
+/******************
+ *  Bulk kernels  *
+ ******************/
+
+// Times body at every instruction set the host supports; elements & bytes are those of one call
+template<class B> static void benchDispatched(const char *type, cui32 lanes, const char *operation, csize_t elements, csize_t bytes, B &&body) {
+   cui32 widest = fpdtISA();
+
+   for (ui32 isa = FPDT_ISA_SSE; isa <= widest; isa++) {
+      fpdtSetISA(isa);
+      benchRow(benchISA[isa], type, lanes, operation, "throughput", elements, benchTime(body), bytes);
+   }
+   fpdtSetISA(widest);
+}
+
+template<typename T, cui32 lanes> static void benchBulk(const char *type, csize_t count) {
+   typedef typename benchSource<T>::type S;
+
+   if constexpr (requires (T *dest, const S *src) { fpdtToFixed(dest, src, count); }) {
+      T *codes = benchCodes<T>(count);
+      S *floats = benchFloatArray<S>(count * lanes);
+      csize_t bytes = count * (lanes * sizeof(S) + sizeof(T));
+
+      for (ui32 round = FPDT_ROUND_TRUNCATE; round <= FPDT_ROUND_STOCHASTIC; round++)
+         benchDispatched(type, lanes, benchRounding[round], count * lanes, bytes, [&] { fpdtToFixed(codes, floats, count, round); benchSink = *(cui8 *)codes; });
+      benchDispatched(type, lanes, "fpdtToFloat", count * lanes, bytes, [&] { fpdtToFloat(floats, codes, count); benchSink = ui64(floats[0]); });
+      _mm_free(codes); _mm_free(floats);
+   }
+}
+
+// The kernels of the other headers: bfloat16, IEEE halves, & 24-bit integers
+static void benchOtherBulk(csize_t count) {
+   fl32  *floats = benchFloatArray<fl32>(count);
+   fl16  *brain = benchCodes<fl16>(count);
+   ieee16 *halves = benchCodes<ieee16>(count);
+   si32  *wide = benchCodes<si32>(count);
+   si24  *packed = benchCodes<si24>(count);
+
+   benchDispatched("fl16", 1, "fpdtToBF16", count, count * 6, [&] { fpdtToBF16(brain, floats, count); benchSink = *(cui16 *)brain; });
+   benchDispatched("fl16", 1, "fpdtToFloat", count, count * 6, [&] { fpdtToFloat(floats, brain, count); benchSink = ui64(floats[0]); });
+   benchDispatched("ieee16", 1, "fpdtToHalf", count, count * 6, [&] { fpdtToHalf(halves, floats, count); benchSink = *(cui16 *)halves; });
+   benchDispatched("ieee16", 1, "fpdtToFloat", count, count * 6, [&] { fpdtToFloat(floats, halves, count); benchSink = ui64(floats[0]); });
+   benchDispatched("si24", 1, "fpdtWiden", count, count * 7, [&] { fpdtWiden(wide, packed, count); benchSink = ui64(wide[0]); });
+   benchDispatched("si24", 1, "fpdtNarrow", count, count * 7, [&] { fpdtNarrow(packed, wide, count); benchSink = *(cui8 *)packed; });
+   _mm_free(floats); _mm_free(brain); _mm_free(halves); _mm_free(wide); _mm_free(packed);
+}
+
+/*******************
+ *  Other kernels  *
+ *******************/
+
+// Dot products & multiply-adds of count codes
+template<typename T> static void benchDot(const char *type, csize_t count) {
+   T    *a = benchCodes<T>(count), *b = benchCodes<T>(count);
+   fl32 *sums = benchFloatArray<fl32>(count);
+
+   benchDispatched(type, 1, "fpdtDot", count, count * sizeof(T) * 2, [&] { benchSink = ui64(fpdtDot(a, b, count)); });
+   benchDispatched(type, 1, "fpdtMac", count, count * (sizeof(T) + 8), [&] { fpdtMac(sums, a, 0.5f, count); benchSink = ui64(sums[0]); });
+   _mm_free(a); _mm_free(b); _mm_free(sums);
+}
+
+// FixedArray operators over count elements
+template<typename T> static void benchArray(const char *type, csize_t count) {
+   typedef typename FixedArray<T>::fl F;
+   F *values = benchFloatArray<F>(count);
+
+   for (size_t i = 0; i < count; i++) values[i] *= F(0.25); // Sums & products stay in range
+   FixedArray<T> a(values, count), b(values, count);
+   const T floor = a[0] < a[1] ? a[0] : a[1], ceiling = a[0] < a[1] ? a[1] : a[0];
+
+   benchRow(BENCH_BUILD, type, 1, "FixedArray +=", "throughput", count, benchTime([&] { a += b; benchSink = *(cui8 *)a.data; }), count * sizeof(T) * 3);
+   benchRow(BENCH_BUILD, type, 1, "FixedArray *=", "throughput", count, benchTime([&] { a *= b; benchSink = *(cui8 *)a.data; }), count * sizeof(T) * 3);
+   benchRow(BENCH_BUILD, type, 1, "FixedArray clamp", "throughput", count, benchTime([&] { a.clamp(floor, ceiling); benchSink = *(cui8 *)a.data; }), count * sizeof(T) * 2);
+   _mm_free(values);
+}
+
+// The dot product, GEMM, matrix, colour, PCM, & block kernels
+static void benchKernels(csize_t count) {
+   benchDot<fp8n0_1>("fp8n0_1", count); benchDot<fs7p8>("fs7p8", count); benchDot<fs1p14>("fs1p14", count);
+
+   {  // One thread, so that rows compare across hosts
+      fp8n0_1 *a = benchCodes<fp8n0_1>(BENCH_GEMM * BENCH_GEMM), *b = benchCodes<fp8n0_1>(BENCH_GEMM * BENCH_GEMM);
+      fl32    *c = benchFloatArray<fl32>(BENCH_GEMM * BENCH_GEMM);
+
+      benchDispatched("fp8n0_1", 1, "fpdtGemm", BENCH_GEMM * BENCH_GEMM * BENCH_GEMM, BENCH_GEMM * BENCH_GEMM * 6,
+                      [&] { fpdtGemm(c, a, b, BENCH_GEMM, BENCH_GEMM, BENCH_GEMM, 1); benchSink = ui64(c[0]); });
+      _mm_free(a); _mm_free(b); _mm_free(c);
+   }
+   {
+      AVXmatrix m;
+      VEC4Df   *colours = (VEC4Df *)benchFloatArray<fl32>(count * 4), *out = (VEC4Df *)benchFloatArray<fl32>(count * 4);
+      VEC3Df   *points = (VEC3Df *)benchFloatArray<fl32>(count * 3);
+
+      for (ui32 i = 0; i < 16; i++) m.fl[i] = i % 5 ? 0.0f : 1.0f;
+      m.fl[12] = 0.5f;
+      benchDispatched("VEC4Df", 4, "MatTransform", count * 4, count * 32, [&] { MatTransform(out, colours, count, m); benchSink = ui64(out[0].x); });
+      benchDispatched("VEC3Df", 3, "MatTransformPoints", count * 3, count * 24, [&] { MatTransformPoints(points, points, count, m); benchSink = ui64(points[0].x); });
+#if defined(_MSC_VER) || defined(__AVX2__)
+      benchRow(BENCH_BUILD, "AVXmatrix", 16, "MatMultiply", "latency", BENCH_CHAIN,
+               benchTime([&] { AVXmatrix x = m; for (ui32 i = 0; i < BENCH_CHAIN; i++) x = MatMultiply(x, m); benchSink = ui64(x.fl[0]); }), 0);
+#endif
+
+      rgb565     *p565 = benchCodes<rgb565>(count);
+      rgb10a2    *p1010 = benchCodes<rgb10a2>(count);
+      r11g11b10f *p111110 = benchCodes<r11g11b10f>(count);
+      fp8n0_1    *srgb = benchCodes<fp8n0_1>(count);
+
+      benchDispatched("rgb565", 4, "fpdtToFixed", count * 4, count * 18, [&] { fpdtToFixed(p565, colours, count); benchSink = *(cui8 *)p565; });
+      benchDispatched("rgb565", 4, "fpdtToFloat", count * 4, count * 18, [&] { fpdtToFloat(out, p565, count); benchSink = ui64(out[0].x); });
+      benchDispatched("rgb10a2", 4, "fpdtToFixed", count * 4, count * 20, [&] { fpdtToFixed(p1010, colours, count); benchSink = *(cui8 *)p1010; });
+      benchDispatched("rgb10a2", 4, "fpdtToFloat", count * 4, count * 20, [&] { fpdtToFloat(out, p1010, count); benchSink = ui64(out[0].x); });
+      benchDispatched("r11g11b10f", 4, "fpdtToFixed", count * 4, count * 20, [&] { fpdtToFixed(p111110, colours, count); benchSink = *(cui8 *)p111110; });
+      benchDispatched("r11g11b10f", 4, "fpdtToFloat", count * 4, count * 20, [&] { fpdtToFloat(out, p111110, count); benchSink = ui64(out[0].x); });
+      benchDispatched("fp8n0_1", 1, "fpdtToFixedSRGB", count, count * 5, [&] { fpdtToFixedSRGB(srgb, (cfl32 *)colours, count); benchSink = *(cui8 *)srgb; });
+      benchDispatched("fp8n0_1", 1, "fpdtToFloatSRGB", count, count * 5, [&] { fpdtToFloatSRGB((fl32 *)out, srgb, count); benchSink = ui64(out[0].x); });
+      _mm_free(colours); _mm_free(out); _mm_free(points); _mm_free(p565); _mm_free(p1010); _mm_free(p111110); _mm_free(srgb);
+   }
+   {  // Stereo streams, a whole number of frames per call
+      csize_t samples = count & ~size_t(1);
+      ui8    *pcm = benchCodes<ui8>(samples * 3);
+      fl32   *floats = benchFloatArray<fl32>(samples);
+      fs1p14 *codes = benchCodes<fs1p14>(samples);
+      PCM24Decoder<fl32> decoder(2); PCM24Decoder<fs1p14> dithered(2, true); PCM24Encoder<fl32> encoder(2);
+
+      benchDispatched("fl32", 1, "PCM24Decoder", samples, samples * 7, [&] { benchSink = decoder.decode(floats, pcm, samples * 3); });
+      benchDispatched("fs1p14", 1, "PCM24Decoder dither", samples, samples * 5, [&] { benchSink = dithered.decode(codes, pcm, samples * 3); });
+      for (size_t i = 0; i < samples; i++) floats[i] = fl32(benchRandom() >> 40) * (2.0f / 16777216.0f) - 1.0f;
+      benchDispatched("fl32", 1, "PCM24Encoder", samples, samples * 7, [&] { benchSink = encoder.encode(pcm, floats, samples); });
+      _mm_free(pcm); _mm_free(floats); _mm_free(codes);
+   }
+   {
+      csize_t blocks = count / 32;
+      fl32    *floats = benchFloatArray<fl32>(blocks * 32);
+      fp8nb32 *b8 = (fp8nb32 *)_mm_malloc(blocks * sizeof(fp8nb32) + 64, 64);
+      fp16nb32 *b16 = (fp16nb32 *)_mm_malloc(blocks * sizeof(fp16nb32) + 64, 64);
+
+      benchDispatched("fp8nb32", 32, "fpdtToFixed", blocks * 32, blocks * (128 + sizeof(fp8nb32)), [&] { fpdtToFixed(b8, floats, blocks); benchSink = *(cui8 *)b8; });
+      benchDispatched("fp8nb32", 32, "fpdtToFloat", blocks * 32, blocks * (128 + sizeof(fp8nb32)), [&] { fpdtToFloat(floats, b8, blocks); benchSink = ui64(floats[0]); });
+      benchDispatched("fp16nb32", 32, "fpdtToFixed", blocks * 32, blocks * (128 + sizeof(fp16nb32)), [&] { fpdtToFixed(b16, floats, blocks); benchSink = *(cui8 *)b16; });
+      benchDispatched("fp16nb32", 32, "fpdtToFloat", blocks * 32, blocks * (128 + sizeof(fp16nb32)), [&] { fpdtToFloat(floats, b16, blocks); benchSink = ui64(floats[0]); });
+      _mm_free(floats); _mm_free(b8); _mm_free(b16);
+   }
+   benchArray<fp8n0_1>("fp8n0_1", count); benchArray<fs7p8>("fs7p8", count); benchArray<fp16n_1_1>("fp16n_1_1", count);
+}
+
+/**********
+ *  Main  *
+ **********/
+
+int main(int argc, char **argv) {
+   csize_t count = argc > 1 ? size_t(strtoull(argv[1], nullptr, 10)) : 65536;
+
+   printf("build,isa,type,lanes,operation,mode,elements,ns,gbps\n");
+   benchOperators<fl32, 1>("fl32");
+#define BENCH_OPERATORS(T, lanes) benchOperators<T, lanes>(#T);
+   BENCH_TYPES(BENCH_OPERATORS)
+#define BENCH_BULK(T, lanes) benchBulk<T, lanes>(#T, count / lanes);
+   BENCH_TYPES(BENCH_BULK)
+   benchOtherBulk(count);
+   benchKernels(count);
+   return 0;
+}
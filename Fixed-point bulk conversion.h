@@ -0,0 +1,1075 @@
+/**********************************************************************
+ * File: Fixed-point bulk conversion.h            Created: 2024/07/02 *
+ *                                          Last modified: 2024/07/26 *
+ *                                                                    *
+ * Desc: Array encode & decode functions for every fixed-point data   *
+ *       type. Each type has an fpdtToFixed(dest, src, count) and an  *
+ *       fpdtToFloat(dest, src, count) overload, which process any    *
+ *       number of elements with SSE/AVX2/AVX512 main loops, chosen   *
+ *       at run time by "Fixed-point CPU dispatch.h".                 *
+ *                                                                    *
+ * Notes: Results are bit-exact with the scalar toFixed & toFloat     *
+ *        member functions for in-range values when truncating, the   *
+ *        default. fpdtToFixed() can also round to nearest even, or   *
+ *        stochastically from a per-thread generator, saturating at   *
+ *        code 0 & the top code; see FPDT_ROUND_* & fpdtSeed().       *
+ *        32-bit types are converted to/from 64-bit floats, matching  *
+ *        their scalar interfaces.                                    *
+ *        Types with a user-definable range read __fpdt_data__ once   *
+ *        per call, or take an explicit fpdtRange context.            *
+ *        fpdtCalibrate() sets such a context to the range of its     *
+ *        input, found with SIMD min & max, then encodes with it.     *
+ *        AVX512 paths require AVX512F, AVX512BW, and AVX512VL.       *
+ *                                                                    *
+ * MIT license.                     Copyright (c) David William Bull. *
+ **********************************************************************/
+#pragma once
+
+#include "Fixed-point data types.h"
+#include "Fixed-point CPU dispatch.h"
+
+#define _FIXED_POINT_BULK_CONVERSION_
+
+// Rounding modes of fpdtToFixed()
+#define FPDT_ROUND_TRUNCATE   0 // Toward zero, as the scalar toFixed member functions
+#define FPDT_ROUND_NEAREST    1 // To nearest, ties to even
+#define FPDT_ROUND_STOCHASTIC 2 // Up with a probability equal to the discarded fraction, so errors average to 0
+
+/*******************************************
+ *  Floating-point to fixed-point kernels  *
+ *******************************************/
+
+// Each kernel computes dest[i] = (src[i] + offset) * scale, rounded as selected by its FPDT_ROUND_* template
+// argument & clamped to the top code unless truncated, then keeps the low bits
+
+/*
+ *  Rounding
+ */
+
+// Per-thread state of the stochastic rounding generator
+inline thread_local ui32 __fpdt_seed__ = 0x09E3779B9u;
+
+// Seed the stochastic rounding generator of the calling thread, e.g. for reproducible encodes
+inline void fpdtSeed(cui32 seed) { __fpdt_seed__ = seed | 1u; }
+
+// Scalar xorshift32 step
+static inline cui32 _fpdt_xorshift(ui32 &state) { state ^= state << 13; state ^= state >> 17; state ^= state << 5; return state; }
+
+// 4 xorshift32 states, for lanes first~first + 3, hashed from one seed so that lanes are uncorrelated; never 0
+static inline csi128 _fpdt_rngSeed4(cui32 seed, cui32 first) {
+   si128 hash = _mm_add_epi32(_mm_set1_epi32(si32(seed)), _mm_mullo_epi32(_mm_add_epi32(_mm_set1_epi32(si32(first)), _mm_setr_epi32(1, 2, 3, 4)), _mm_set1_epi32(si32(0x09E3779B9))));
+
+   hash = _mm_mullo_epi32(_mm_xor_si128(hash, _mm_srli_epi32(hash, 16)), _mm_set1_epi32(si32(0x085EBCA6B)));
+   hash = _mm_mullo_epi32(_mm_xor_si128(hash, _mm_srli_epi32(hash, 13)), _mm_set1_epi32(si32(0x0C2B2AE35)));
+   return _mm_or_si128(_mm_xor_si128(hash, _mm_srli_epi32(hash, 16)), _mm_set1_epi32(1));
+}
+
+// Generator states for the start of a kernel; unused, & never loaded, unless rounding stochastically
+template<cui32 round> static inline csi128 _fpdt_rngInit4(void) {
+   if constexpr (round == FPDT_ROUND_STOCHASTIC) return _fpdt_rngSeed4(__fpdt_seed__, 0);
+   else return _mm_setzero_si128();
+}
+
+// Store the generator state at the end of a kernel, so the next call continues the sequence
+template<cui32 round> static inline void _fpdt_rngSave(cui32 state) { if constexpr (round == FPDT_ROUND_STOCHASTIC) __fpdt_seed__ = state | 1u; }
+
+// Uniform random floats in [0.0, 1.0), 24 bits per lane
+static inline cfl32x4 _fpdt_uniform4(si128 &state) {
+   state = _mm_xor_si128(state, _mm_slli_epi32(state, 13));
+   state = _mm_xor_si128(state, _mm_srli_epi32(state, 17));
+   state = _mm_xor_si128(state, _mm_slli_epi32(state, 5));
+   return _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(state, 8)), _mm_set1_ps(1.0f / 16777216.0f));
+}
+
+// Uniform random doubles in [0.0, 1.0), 31 bits per lane; uses the low 2 states
+static inline cfl64x2 _fpdt_uniform2d(si128 &state) {
+   state = _mm_xor_si128(state, _mm_slli_epi32(state, 13));
+   state = _mm_xor_si128(state, _mm_srli_epi32(state, 17));
+   state = _mm_xor_si128(state, _mm_slli_epi32(state, 5));
+   return _mm_mul_pd(_mm_cvtepi32_pd(_mm_srli_epi32(state, 1)), _mm_set1_pd(1.0 / 2147483648.0));
+}
+
+// Round before a truncating conversion: to nearest even, or up when uniform noise is below the fraction, so that
+// the expected result is the exact value. Comparing, rather than adding the noise & flooring, is exact; a sum
+// could round up to the next integer, & an integral value, e.g. a top code, must never round up
+template<cui32 round> static inline cfl32x4 _fpdt_round4(cfl32x4 value, si128 &state) {
+   if constexpr (round == FPDT_ROUND_NEAREST) return _mm_round_ps(value, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+   else if constexpr (round == FPDT_ROUND_STOCHASTIC) {
+      cfl32x4 whole = _mm_floor_ps(value);
+
+      return _mm_add_ps(whole, _mm_and_ps(_mm_cmplt_ps(_fpdt_uniform4(state), _mm_sub_ps(value, whole)), _mm_set1_ps(1.0f)));
+   } else return value;
+}
+
+// As _fpdt_round4(), but truncation floors, since the unsigned conversion that follows needs integral values
+template<cui32 round> static inline cfl64x2 _fpdt_round2d(cfl64x2 value, si128 &state) {
+   if constexpr (round == FPDT_ROUND_NEAREST) return _mm_round_pd(value, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+   else if constexpr (round == FPDT_ROUND_STOCHASTIC) {
+      cfl64x2 whole = _mm_floor_pd(value);
+
+      return _mm_add_pd(whole, _mm_and_pd(_mm_cmplt_pd(_fpdt_uniform2d(state), _mm_sub_pd(value, whole)), _mm_set1_pd(1.0)));
+   } else return _mm_floor_pd(value);
+}
+
+// Scalar forms, for kernel tails
+template<cui32 round> static inline cfl32 _fpdt_round1(cfl32 value, ui32 &state) {
+   if constexpr (round == FPDT_ROUND_NEAREST) { cfl32x4 temp = _mm_set_ss(value); return _mm_cvtss_f32(_mm_round_ss(temp, temp, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)); }
+   else if constexpr (round == FPDT_ROUND_STOCHASTIC) {
+      cfl32x4 temp = _mm_set_ss(value);
+      cfl32   whole = _mm_cvtss_f32(_mm_floor_ss(temp, temp));
+
+      return fl32(_fpdt_xorshift(state) >> 8) * (1.0f / 16777216.0f) < value - whole ? whole + 1.0f : whole;
+   }
+   else return value;
+}
+
+template<cui32 round> static inline cfl64 _fpdt_round1d(cfl64 value, ui32 &state) {
+   if constexpr (round == FPDT_ROUND_NEAREST) { cfl64x2 temp = _mm_set_sd(value); return _mm_cvtsd_f64(_mm_round_sd(temp, temp, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)); }
+   else if constexpr (round == FPDT_ROUND_STOCHASTIC) {
+      cfl64x2 temp = _mm_set_sd(value);
+      cfl64   whole = _mm_cvtsd_f64(_mm_floor_sd(temp, temp));
+
+      return fl64(_fpdt_xorshift(state) >> 1) * (1.0 / 2147483648.0) < value - whole ? whole + 1.0 : whole;
+   }
+   else return value;
+}
+
+// Rounding up can carry a value within a step of the top code to top + 1, whose low bits are 0, so rounded values
+// are clamped to 0~top; truncation keeps the low bits, as the scalar toFixed member functions do
+template<cui32 round> static inline cfl32x4 _fpdt_clamp4(cfl32x4 value, cfl32x4 top) {
+   if constexpr (round == FPDT_ROUND_TRUNCATE) return value;
+   else return _mm_min_ps(_mm_max_ps(value, _mm_setzero_ps()), top);
+}
+
+template<cui32 round> static inline cfl64x2 _fpdt_clamp2d(cfl64x2 value, cfl64x2 top) {
+   if constexpr (round == FPDT_ROUND_TRUNCATE) return value;
+   else return _mm_min_pd(_mm_max_pd(value, _mm_setzero_pd()), top);
+}
+
+template<cui32 round> static inline cfl32 _fpdt_clamp1(cfl32 value, cfl32 top) {
+   if constexpr (round == FPDT_ROUND_TRUNCATE) return value;
+   else return value > 0.0f ? (value < top ? value : top) : 0.0f;
+}
+
+template<cui32 round> static inline cfl64 _fpdt_clamp1d(cfl64 value, cfl64 top) {
+   if constexpr (round == FPDT_ROUND_TRUNCATE) return value;
+   else return value > 0.0 ? (value < top ? value : top) : 0.0;
+}
+
+#ifdef _FPDT_KERNELS_AVX2_
+template<cui32 round> static inline _FPDT_TARGET_AVX2_ csi256 _fpdt_rngInit8(void) {
+   if constexpr (round == FPDT_ROUND_STOCHASTIC) return _mm256_setr_m128i(_fpdt_rngSeed4(__fpdt_seed__, 0), _fpdt_rngSeed4(__fpdt_seed__, 4));
+   else return _mm256_setzero_si256();
+}
+
+static inline _FPDT_TARGET_AVX2_ cfl32x8 _fpdt_uniform8(si256 &state) {
+   state = _mm256_xor_si256(state, _mm256_slli_epi32(state, 13));
+   state = _mm256_xor_si256(state, _mm256_srli_epi32(state, 17));
+   state = _mm256_xor_si256(state, _mm256_slli_epi32(state, 5));
+   return _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(state, 8)), _mm256_set1_ps(1.0f / 16777216.0f));
+}
+
+static inline _FPDT_TARGET_AVX2_ cfl64x4 _fpdt_uniform4d(si128 &state) {
+   state = _mm_xor_si128(state, _mm_slli_epi32(state, 13));
+   state = _mm_xor_si128(state, _mm_srli_epi32(state, 17));
+   state = _mm_xor_si128(state, _mm_slli_epi32(state, 5));
+   return _mm256_mul_pd(_mm256_cvtepi32_pd(_mm_srli_epi32(state, 1)), _mm256_set1_pd(1.0 / 2147483648.0));
+}
+
+template<cui32 round> static inline _FPDT_TARGET_AVX2_ cfl32x8 _fpdt_round8(cfl32x8 value, si256 &state) {
+   if constexpr (round == FPDT_ROUND_NEAREST) return _mm256_round_ps(value, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+   else if constexpr (round == FPDT_ROUND_STOCHASTIC) {
+      cfl32x8 whole = _mm256_floor_ps(value);
+
+      return _mm256_add_ps(whole, _mm256_and_ps(_mm256_cmp_ps(_fpdt_uniform8(state), _mm256_sub_ps(value, whole), _CMP_LT_OQ), _mm256_set1_ps(1.0f)));
+   }
+   else return value;
+}
+
+template<cui32 round> static inline _FPDT_TARGET_AVX2_ cfl64x4 _fpdt_round4d(cfl64x4 value, si128 &state) {
+   if constexpr (round == FPDT_ROUND_NEAREST) return _mm256_round_pd(value, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+   else if constexpr (round == FPDT_ROUND_STOCHASTIC) {
+      cfl64x4 whole = _mm256_floor_pd(value);
+
+      return _mm256_add_pd(whole, _mm256_and_pd(_mm256_cmp_pd(_fpdt_uniform4d(state), _mm256_sub_pd(value, whole), _CMP_LT_OQ), _mm256_set1_pd(1.0)));
+   }
+   else return _mm256_floor_pd(value);
+}
+
+template<cui32 round> static inline _FPDT_TARGET_AVX2_ cfl32x8 _fpdt_clamp8(cfl32x8 value, cfl32x8 top) {
+   if constexpr (round == FPDT_ROUND_TRUNCATE) return value;
+   else return _mm256_min_ps(_mm256_max_ps(value, _mm256_setzero_ps()), top);
+}
+
+template<cui32 round> static inline _FPDT_TARGET_AVX2_ cfl64x4 _fpdt_clamp4d(cfl64x4 value, cfl64x4 top) {
+   if constexpr (round == FPDT_ROUND_TRUNCATE) return value;
+   else return _mm256_min_pd(_mm256_max_pd(value, _mm256_setzero_pd()), top);
+}
+#endif
+
+#ifdef _FPDT_KERNELS_AVX512_
+template<cui32 round> static inline _FPDT_TARGET_AVX512_ csi512 _fpdt_rngInit16(void) {
+   if constexpr (round == FPDT_ROUND_STOCHASTIC) {
+      cui32 seed = __fpdt_seed__;
+
+      return _mm512_inserti64x4(_mm512_castsi256_si512(_mm256_setr_m128i(_fpdt_rngSeed4(seed, 0), _fpdt_rngSeed4(seed, 4))),
+                                _mm256_setr_m128i(_fpdt_rngSeed4(seed, 8), _fpdt_rngSeed4(seed, 12)), 1);
+   } else return _mm512_setzero_si512();
+}
+
+static inline _FPDT_TARGET_AVX512_ cfl32x16 _fpdt_uniform16(si512 &state) {
+   state = _mm512_xor_si512(state, _mm512_slli_epi32(state, 13));
+   state = _mm512_xor_si512(state, _mm512_srli_epi32(state, 17));
+   state = _mm512_xor_si512(state, _mm512_slli_epi32(state, 5));
+   return _mm512_mul_ps(_mm512_cvtepi32_ps(_mm512_srli_epi32(state, 8)), _mm512_set1_ps(1.0f / 16777216.0f));
+}
+
+static inline _FPDT_TARGET_AVX512_ cfl64x8 _fpdt_uniform8d(si512 &state) {
+   state = _mm512_xor_si512(state, _mm512_slli_epi32(state, 13));
+   state = _mm512_xor_si512(state, _mm512_srli_epi32(state, 17));
+   state = _mm512_xor_si512(state, _mm512_slli_epi32(state, 5));
+   return _mm512_mul_pd(_mm512_cvtepi32_pd(_mm512_castsi512_si256(_mm512_srli_epi32(state, 1))), _mm512_set1_pd(1.0 / 2147483648.0));
+}
+
+template<cui32 round> static inline _FPDT_TARGET_AVX512_ cfl32x16 _fpdt_round16(cfl32x16 value, si512 &state) {
+   if constexpr (round == FPDT_ROUND_NEAREST) return _mm512_roundscale_ps(value, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+   else if constexpr (round == FPDT_ROUND_STOCHASTIC) {
+      cfl32x16 whole = _mm512_roundscale_ps(value, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+
+      return _mm512_mask_add_ps(whole, _mm512_cmp_ps_mask(_fpdt_uniform16(state), _mm512_sub_ps(value, whole), _CMP_LT_OQ), whole, _mm512_set1_ps(1.0f));
+   }
+   else return value;
+}
+
+// Truncation is left to _mm512_cvttpd_epu32()
+template<cui32 round> static inline _FPDT_TARGET_AVX512_ cfl64x8 _fpdt_round8d(cfl64x8 value, si512 &state) {
+   if constexpr (round == FPDT_ROUND_NEAREST) return _mm512_roundscale_pd(value, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+   else if constexpr (round == FPDT_ROUND_STOCHASTIC) {
+      cfl64x8 whole = _mm512_roundscale_pd(value, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+
+      return _mm512_mask_add_pd(whole, _mm512_cmp_pd_mask(_fpdt_uniform8d(state), _mm512_sub_pd(value, whole), _CMP_LT_OQ), whole, _mm512_set1_pd(1.0));
+   }
+   else return value;
+}
+
+template<cui32 round> static inline _FPDT_TARGET_AVX512_ cfl32x16 _fpdt_clamp16(cfl32x16 value, cfl32x16 top) {
+   if constexpr (round == FPDT_ROUND_TRUNCATE) return value;
+   else return _mm512_min_ps(_mm512_max_ps(value, _mm512_setzero_ps()), top);
+}
+
+template<cui32 round> static inline _FPDT_TARGET_AVX512_ cfl64x8 _fpdt_clamp8d(cfl64x8 value, cfl64x8 top) {
+   if constexpr (round == FPDT_ROUND_TRUNCATE) return value;
+   else return _mm512_min_pd(_mm512_max_pd(value, _mm512_setzero_pd()), top);
+}
+#endif
+
+/*
+ *  Kernels
+ */
+
+// 32-bit floats to 8-bit fixeds
+template<cui32 round> static inline void _fpdt_encode8SSE(ui8 *dest, cfl32 *src, csize_t count, cfl32 offset, cfl32 scale) {
+   cfl32x4 off = _mm_set_ps1(offset), mul = _mm_set_ps1(scale), top = _mm_set_ps1(255.0f);
+   cui128  mask = _mm_set1_epi32(0x0FF);
+   si128   rng = _fpdt_rngInit4<round>();
+   size_t  i = 0;
+
+   for (; i + 16 <= count; i += 16) {
+      csi128 a = _mm_and_si128(_mm_cvttps_epi32(_fpdt_clamp4<round>(_fpdt_round4<round>(_mm_mul_ps(_mm_add_ps(_mm_loadu_ps(&src[i]), off), mul), rng), top)), mask);
+      csi128 b = _mm_and_si128(_mm_cvttps_epi32(_fpdt_clamp4<round>(_fpdt_round4<round>(_mm_mul_ps(_mm_add_ps(_mm_loadu_ps(&src[i + 4]), off), mul), rng), top)), mask);
+      csi128 c = _mm_and_si128(_mm_cvttps_epi32(_fpdt_clamp4<round>(_fpdt_round4<round>(_mm_mul_ps(_mm_add_ps(_mm_loadu_ps(&src[i + 8]), off), mul), rng), top)), mask);
+      csi128 d = _mm_and_si128(_mm_cvttps_epi32(_fpdt_clamp4<round>(_fpdt_round4<round>(_mm_mul_ps(_mm_add_ps(_mm_loadu_ps(&src[i + 12]), off), mul), rng), top)), mask);
+
+      _mm_storeu_si128((si128 *)&dest[i], _mm_packus_epi16(_mm_packus_epi32(a, b), _mm_packus_epi32(c, d)));
+   }
+   ui32 state = ui32(_mm_cvtsi128_si32(rng));
+
+   for (; i < count; i++) dest[i] = ui8(si32(_fpdt_clamp1<round>(_fpdt_round1<round>((src[i] + offset) * scale, state), 255.0f)));
+   _fpdt_rngSave<round>(state);
+}
+
+// 32-bit floats to 16-bit fixeds
+template<cui32 round> static inline void _fpdt_encode16SSE(ui16 *dest, cfl32 *src, csize_t count, cfl32 offset, cfl32 scale) {
+   cfl32x4 off = _mm_set_ps1(offset), mul = _mm_set_ps1(scale), top = _mm_set_ps1(65535.0f);
+   cui128  mask = _mm_set1_epi32(0x0FFFF);
+   si128   rng = _fpdt_rngInit4<round>();
+   size_t  i = 0;
+
+   for (; i + 8 <= count; i += 8) {
+      csi128 a = _mm_and_si128(_mm_cvttps_epi32(_fpdt_clamp4<round>(_fpdt_round4<round>(_mm_mul_ps(_mm_add_ps(_mm_loadu_ps(&src[i]), off), mul), rng), top)), mask);
+      csi128 b = _mm_and_si128(_mm_cvttps_epi32(_fpdt_clamp4<round>(_fpdt_round4<round>(_mm_mul_ps(_mm_add_ps(_mm_loadu_ps(&src[i + 4]), off), mul), rng), top)), mask);
+
+      _mm_storeu_si128((si128 *)&dest[i], _mm_packus_epi32(a, b));
+   }
+   ui32 state = ui32(_mm_cvtsi128_si32(rng));
+
+   for (; i < count; i++) dest[i] = ui16(si32(_fpdt_clamp1<round>(_fpdt_round1<round>((src[i] + offset) * scale, state), 65535.0f)));
+   _fpdt_rngSave<round>(state);
+}
+
+#ifdef _24BIT_INTEGERS_
+static cui128 _fpdt_shuffle24s = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+
+// 32-bit floats to packed 24-bit fixeds
+template<cui32 round> static inline void _fpdt_encode24SSE(ui8 *dest, cfl32 *src, csize_t count, cfl32 offset, cfl32 scale) {
+   cfl32x4 off = _mm_set_ps1(offset), mul = _mm_set_ps1(scale), top = _mm_set_ps1(16777215.0f);
+   si128   rng = _fpdt_rngInit4<round>();
+   size_t  i = 0;
+
+   // The 16-byte store writes 4 bytes past each group of 12, so the final group goes through the scalar tail
+   for (; i + 6 <= count; i += 4)
+      _mm_storeu_si128((si128 *)&dest[i * 3], _mm_shuffle_epi8(_mm_cvttps_epi32(_fpdt_clamp4<round>(_fpdt_round4<round>(_mm_mul_ps(_mm_add_ps(_mm_loadu_ps(&src[i]), off), mul), rng), top)), _fpdt_shuffle24s));
+   ui32 state = ui32(_mm_cvtsi128_si32(rng));
+
+   for (; i < count; i++) {
+      cui32 temp = ui32(si32(_fpdt_clamp1<round>(_fpdt_round1<round>((src[i] + offset) * scale, state), 16777215.0f)));
+
+      dest[i * 3] = ui8(temp); dest[i * 3 + 1] = ui8(temp >> 8); dest[i * 3 + 2] = ui8(temp >> 16);
+   }
+   _fpdt_rngSave<round>(state);
+}
+#endif
+
+// 64-bit floats to 32-bit fixeds
+template<cui32 round> static inline void _fpdt_encode32SSE(ui32 *dest, cfl64 *src, csize_t count, cfl64 offset, cfl64 scale) {
+   cfl64x2 off = _mm_set1_pd(offset), mul = _mm_set1_pd(scale), top = _mm_set1_pd(4294967295.0), bias = _mm_set1_pd(2147483648.0);
+   cui128  sign = _mm_set1_epi32(0x080000000);
+   si128   rng = _fpdt_rngInit4<round>();
+   size_t  i = 0;
+
+   // Unsigned conversion: round to an integral value, shift into signed range, convert, then flip the sign bit back
+   for (; i + 4 <= count; i += 4) {
+      csi128 a = _mm_cvttpd_epi32(_mm_sub_pd(_fpdt_clamp2d<round>(_fpdt_round2d<round>(_mm_mul_pd(_mm_add_pd(_mm_loadu_pd(&src[i]), off), mul), rng), top), bias));
+      csi128 b = _mm_cvttpd_epi32(_mm_sub_pd(_fpdt_clamp2d<round>(_fpdt_round2d<round>(_mm_mul_pd(_mm_add_pd(_mm_loadu_pd(&src[i + 2]), off), mul), rng), top), bias));
+
+      _mm_storeu_si128((si128 *)&dest[i], _mm_xor_si128(_mm_unpacklo_epi64(a, b), sign));
+   }
+   ui32 state = ui32(_mm_cvtsi128_si32(rng));
+
+   for (; i < count; i++) dest[i] = ui32(_fpdt_clamp1d<round>(_fpdt_round1d<round>((src[i] + offset) * scale, state), 4294967295.0));
+   _fpdt_rngSave<round>(state);
+}
+
+#ifdef _FPDT_KERNELS_AVX2_
+// 32-bit floats to 8-bit fixeds
+template<cui32 round> static inline _FPDT_TARGET_AVX2_ void _fpdt_encode8AVX2(ui8 *dest, cfl32 *src, csize_t count, cfl32 offset, cfl32 scale) {
+   cfl32x8 off = _mm256_set1_ps(offset), mul = _mm256_set1_ps(scale), top = _mm256_set1_ps(255.0f);
+   cui256  mask = _mm256_set1_epi32(0x0FF);
+   cui256  order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+   si256   rng = _fpdt_rngInit8<round>();
+   size_t  i = 0;
+
+   for (; i + 32 <= count; i += 32) {
+      csi256 a = _mm256_and_si256(_mm256_cvttps_epi32(_fpdt_clamp8<round>(_fpdt_round8<round>(_mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(&src[i]), off), mul), rng), top)), mask);
+      csi256 b = _mm256_and_si256(_mm256_cvttps_epi32(_fpdt_clamp8<round>(_fpdt_round8<round>(_mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(&src[i + 8]), off), mul), rng), top)), mask);
+      csi256 c = _mm256_and_si256(_mm256_cvttps_epi32(_fpdt_clamp8<round>(_fpdt_round8<round>(_mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(&src[i + 16]), off), mul), rng), top)), mask);
+      csi256 d = _mm256_and_si256(_mm256_cvttps_epi32(_fpdt_clamp8<round>(_fpdt_round8<round>(_mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(&src[i + 24]), off), mul), rng), top)), mask);
+
+      // In-lane packing leaves the 4-byte groups interleaved by lane; one cross-lane permute restores the order
+      _mm256_storeu_si256((si256 *)&dest[i], _mm256_permutevar8x32_epi32(_mm256_packus_epi16(_mm256_packus_epi32(a, b), _mm256_packus_epi32(c, d)), order));
+   }
+   _fpdt_rngSave<round>(ui32(_mm_cvtsi128_si32(_mm256_castsi256_si128(rng))));
+   _fpdt_encode8SSE<round>(&dest[i], &src[i], count - i, offset, scale);
+}
+
+// 32-bit floats to 16-bit fixeds
+template<cui32 round> static inline _FPDT_TARGET_AVX2_ void _fpdt_encode16AVX2(ui16 *dest, cfl32 *src, csize_t count, cfl32 offset, cfl32 scale) {
+   cfl32x8 off = _mm256_set1_ps(offset), mul = _mm256_set1_ps(scale), top = _mm256_set1_ps(65535.0f);
+   cui256  mask = _mm256_set1_epi32(0x0FFFF);
+   si256   rng = _fpdt_rngInit8<round>();
+   size_t  i = 0;
+
+   for (; i + 16 <= count; i += 16) {
+      csi256 a = _mm256_and_si256(_mm256_cvttps_epi32(_fpdt_clamp8<round>(_fpdt_round8<round>(_mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(&src[i]), off), mul), rng), top)), mask);
+      csi256 b = _mm256_and_si256(_mm256_cvttps_epi32(_fpdt_clamp8<round>(_fpdt_round8<round>(_mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(&src[i + 8]), off), mul), rng), top)), mask);
+
+      _mm256_storeu_si256((si256 *)&dest[i], _mm256_permute4x64_epi64(_mm256_packus_epi32(a, b), 0x0D8));
+   }
+   _fpdt_rngSave<round>(ui32(_mm_cvtsi128_si32(_mm256_castsi256_si128(rng))));
+   _fpdt_encode16SSE<round>(&dest[i], &src[i], count - i, offset, scale);
+}
+
+#ifdef _24BIT_INTEGERS_
+// 32-bit floats to packed 24-bit fixeds
+template<cui32 round> static inline _FPDT_TARGET_AVX2_ void _fpdt_encode24AVX2(ui8 *dest, cfl32 *src, csize_t count, cfl32 offset, cfl32 scale) {
+   cfl32x8 off = _mm256_set1_ps(offset), mul = _mm256_set1_ps(scale), top = _mm256_set1_ps(16777215.0f);
+   cui256  shuffle = _mm256_broadcastsi128_si256(_fpdt_shuffle24s);
+   cui256  order = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7);
+   si256   rng = _fpdt_rngInit8<round>();
+   size_t  i = 0;
+
+   for (; i + 11 <= count; i += 8)
+      _mm256_storeu_si256((si256 *)&dest[i * 3], _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(_mm256_cvttps_epi32(_fpdt_clamp8<round>(_fpdt_round8<round>(_mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(&src[i]), off), mul), rng), top)), shuffle), order));
+   _fpdt_rngSave<round>(ui32(_mm_cvtsi128_si32(_mm256_castsi256_si128(rng))));
+   _fpdt_encode24SSE<round>(&dest[i * 3], &src[i], count - i, offset, scale);
+}
+#endif
+
+// 64-bit floats to 32-bit fixeds
+template<cui32 round> static inline _FPDT_TARGET_AVX2_ void _fpdt_encode32AVX2(ui32 *dest, cfl64 *src, csize_t count, cfl64 offset, cfl64 scale) {
+   cfl64x4 off = _mm256_set1_pd(offset), mul = _mm256_set1_pd(scale), top = _mm256_set1_pd(4294967295.0), bias = _mm256_set1_pd(2147483648.0);
+   cui256  sign = _mm256_set1_epi32(0x080000000);
+   si128   rng = _fpdt_rngInit4<round>();
+   size_t  i = 0;
+
+   for (; i + 8 <= count; i += 8) {
+      csi128 a = _mm256_cvttpd_epi32(_mm256_sub_pd(_fpdt_clamp4d<round>(_fpdt_round4d<round>(_mm256_mul_pd(_mm256_add_pd(_mm256_loadu_pd(&src[i]), off), mul), rng), top), bias));
+      csi128 b = _mm256_cvttpd_epi32(_mm256_sub_pd(_fpdt_clamp4d<round>(_fpdt_round4d<round>(_mm256_mul_pd(_mm256_add_pd(_mm256_loadu_pd(&src[i + 4]), off), mul), rng), top), bias));
+
+      _mm256_storeu_si256((si256 *)&dest[i], _mm256_xor_si256(_mm256_inserti128_si256(_mm256_castsi128_si256(a), b, 1), sign));
+   }
+   _fpdt_rngSave<round>(ui32(_mm_cvtsi128_si32(rng)));
+   _fpdt_encode32SSE<round>(&dest[i], &src[i], count - i, offset, scale);
+}
+#endif
+
+#ifdef _FPDT_KERNELS_AVX512_
+// 32-bit floats to 8-bit fixeds
+template<cui32 round> static inline _FPDT_TARGET_AVX512_ void _fpdt_encode8AVX512(ui8 *dest, cfl32 *src, csize_t count, cfl32 offset, cfl32 scale) {
+   cfl32x16 off = _mm512_set1_ps(offset), mul = _mm512_set1_ps(scale), top = _mm512_set1_ps(255.0f);
+   si512    rng = _fpdt_rngInit16<round>();
+   size_t   i = 0;
+
+   for (; i + 16 <= count; i += 16)
+      _mm_storeu_si128((si128 *)&dest[i], _mm512_cvtepi32_epi8(_mm512_cvttps_epi32(_fpdt_clamp16<round>(_fpdt_round16<round>(_mm512_mul_ps(_mm512_add_ps(_mm512_loadu_ps(&src[i]), off), mul), rng), top))));
+   if (i < count) {
+      const __mmask16 mask = __mmask16((1u << (count - i)) - 1u);
+
+      _mm512_mask_cvtepi32_storeu_epi8(&dest[i], mask, _mm512_cvttps_epi32(_fpdt_clamp16<round>(_fpdt_round16<round>(_mm512_mul_ps(_mm512_add_ps(_mm512_maskz_loadu_ps(mask, &src[i]), off), mul), rng), top)));
+   }
+   _fpdt_rngSave<round>(ui32(_mm_cvtsi128_si32(_mm512_castsi512_si128(rng))));
+}
+
+// 32-bit floats to 16-bit fixeds
+template<cui32 round> static inline _FPDT_TARGET_AVX512_ void _fpdt_encode16AVX512(ui16 *dest, cfl32 *src, csize_t count, cfl32 offset, cfl32 scale) {
+   cfl32x16 off = _mm512_set1_ps(offset), mul = _mm512_set1_ps(scale), top = _mm512_set1_ps(65535.0f);
+   si512    rng = _fpdt_rngInit16<round>();
+   size_t   i = 0;
+
+   for (; i + 16 <= count; i += 16)
+      _mm256_storeu_si256((si256 *)&dest[i], _mm512_cvtepi32_epi16(_mm512_cvttps_epi32(_fpdt_clamp16<round>(_fpdt_round16<round>(_mm512_mul_ps(_mm512_add_ps(_mm512_loadu_ps(&src[i]), off), mul), rng), top))));
+   if (i < count) {
+      const __mmask16 mask = __mmask16((1u << (count - i)) - 1u);
+
+      _mm512_mask_cvtepi32_storeu_epi16(&dest[i], mask, _mm512_cvttps_epi32(_fpdt_clamp16<round>(_fpdt_round16<round>(_mm512_mul_ps(_mm512_add_ps(_mm512_maskz_loadu_ps(mask, &src[i]), off), mul), rng), top)));
+   }
+   _fpdt_rngSave<round>(ui32(_mm_cvtsi128_si32(_mm512_castsi512_si128(rng))));
+}
+
+#ifdef _24BIT_INTEGERS_
+// 32-bit floats to packed 24-bit fixeds
+template<cui32 round> static inline _FPDT_TARGET_AVX512_ void _fpdt_encode24AVX512(ui8 *dest, cfl32 *src, csize_t count, cfl32 offset, cfl32 scale) {
+   cfl32x16 off = _mm512_set1_ps(offset), mul = _mm512_set1_ps(scale), top = _mm512_set1_ps(16777215.0f);
+   cui512   shuffle = _mm512_broadcast_i32x4(_fpdt_shuffle24s);
+   cui512   order = _mm512_setr_epi32(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, 3, 7, 11, 15);
+   si512    rng = _fpdt_rngInit16<round>();
+   size_t   i = 0;
+
+   for (; i < count; i += 16) {
+      csize_t   remain = (count - i) < 16 ? count - i : 16;
+      const __mmask16 mask = __mmask16((1u << remain) - 1u);
+      const __mmask64 mask8 = remain == 16 ? 0x0FFFFFFFFFFFFu : (1ull << (remain * 3)) - 1ull;
+
+      _mm512_mask_storeu_epi8(&dest[i * 3], mask8, _mm512_permutexvar_epi32(order, _mm512_shuffle_epi8(_mm512_cvttps_epi32(_fpdt_clamp16<round>(_fpdt_round16<round>(_mm512_mul_ps(_mm512_add_ps(_mm512_maskz_loadu_ps(mask, &src[i]), off), mul), rng), top)), shuffle)));
+   }
+   _fpdt_rngSave<round>(ui32(_mm_cvtsi128_si32(_mm512_castsi512_si128(rng))));
+}
+#endif
+
+// 64-bit floats to 32-bit fixeds
+template<cui32 round> static inline _FPDT_TARGET_AVX512_ void _fpdt_encode32AVX512(ui32 *dest, cfl64 *src, csize_t count, cfl64 offset, cfl64 scale) {
+   cfl64x8 off = _mm512_set1_pd(offset), mul = _mm512_set1_pd(scale), top = _mm512_set1_pd(4294967295.0);
+   si512   rng = _fpdt_rngInit16<round>();
+   size_t  i = 0;
+
+   for (; i + 8 <= count; i += 8)
+      _mm256_storeu_si256((si256 *)&dest[i], _mm512_cvttpd_epu32(_fpdt_clamp8d<round>(_fpdt_round8d<round>(_mm512_mul_pd(_mm512_add_pd(_mm512_loadu_pd(&src[i]), off), mul), rng), top)));
+   if (i < count) {
+      const __mmask8 mask = __mmask8((1u << (count - i)) - 1u);
+
+      _mm256_mask_storeu_epi32(&dest[i], mask, _mm512_cvttpd_epu32(_fpdt_clamp8d<round>(_fpdt_round8d<round>(_mm512_mul_pd(_mm512_add_pd(_mm512_maskz_loadu_pd(mask, &src[i]), off), mul), rng), top)));
+   }
+   _fpdt_rngSave<round>(ui32(_mm_cvtsi128_si32(_mm512_castsi512_si128(rng))));
+}
+#endif
+
+/*******************************************
+ *  Fixed-point to floating-point kernels  *
+ *******************************************/
+
+// Each kernel computes dest[i] = float(src[i]) * scale + offset, without fusing the multiply & add
+
+// 8-bit fixeds to 32-bit floats
+static inline void _fpdt_decode8SSE(fl32 *dest, cui8 *src, csize_t count, cfl32 scale, cfl32 offset) {
+   cfl32x4 mul = _mm_set_ps1(scale), off = _mm_set_ps1(offset);
+   size_t  i = 0;
+
+   for (; i + 4 <= count; i += 4)
+      _mm_storeu_ps(&dest[i], _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(*(si32 *)&src[i]))), mul), off));
+   for (; i < count; i++) dest[i] = fl32(src[i]) * scale + offset;
+}
+
+// 16-bit fixeds to 32-bit floats
+static inline void _fpdt_decode16SSE(fl32 *dest, cui16 *src, csize_t count, cfl32 scale, cfl32 offset) {
+   cfl32x4 mul = _mm_set_ps1(scale), off = _mm_set_ps1(offset);
+   size_t  i = 0;
+
+   for (; i + 4 <= count; i += 4)
+      _mm_storeu_ps(&dest[i], _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtepu16_epi32(_mm_loadl_epi64((csi128 *)&src[i]))), mul), off));
+   for (; i < count; i++) dest[i] = fl32(src[i]) * scale + offset;
+}
+
+#ifdef _24BIT_INTEGERS_
+static cui128 _fpdt_unshuffle24s = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+
+// Packed 24-bit fixeds to 32-bit floats
+static inline void _fpdt_decode24SSE(fl32 *dest, cui8 *src, csize_t count, cfl32 scale, cfl32 offset) {
+   cfl32x4 mul = _mm_set_ps1(scale), off = _mm_set_ps1(offset);
+   size_t  i = 0;
+
+   // The 16-byte load reads 4 bytes past each group of 12, so the final group goes through the scalar tail
+   for (; i + 6 <= count; i += 4)
+      _mm_storeu_ps(&dest[i], _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_shuffle_epi8(_mm_loadu_si128((csi128 *)&src[i * 3]), _fpdt_unshuffle24s)), mul), off));
+   for (; i < count; i++)
+      dest[i] = fl32(ui32(src[i * 3]) | (ui32(src[i * 3 + 1]) << 8) | (ui32(src[i * 3 + 2]) << 16)) * scale + offset;
+}
+#endif
+
+// 32-bit fixeds to 64-bit floats
+static inline void _fpdt_decode32SSE(fl64 *dest, cui32 *src, csize_t count, cfl64 scale, cfl64 offset) {
+   cfl64x2 mul = _mm_set1_pd(scale), off = _mm_set1_pd(offset), bias = _mm_set1_pd(2147483648.0);
+   cui128  sign = _mm_set1_epi32(0x080000000);
+   size_t  i = 0;
+
+   for (; i + 2 <= count; i += 2)
+      _mm_storeu_pd(&dest[i], _mm_add_pd(_mm_mul_pd(_mm_add_pd(_mm_cvtepi32_pd(_mm_xor_si128(_mm_loadl_epi64((csi128 *)&src[i]), sign)), bias), mul), off));
+   for (; i < count; i++) dest[i] = fl64(src[i]) * scale + offset;
+}
+
+#ifdef _FPDT_KERNELS_AVX2_
+// 8-bit fixeds to 32-bit floats
+static inline _FPDT_TARGET_AVX2_ void _fpdt_decode8AVX2(fl32 *dest, cui8 *src, csize_t count, cfl32 scale, cfl32 offset) {
+   cfl32x8 mul = _mm256_set1_ps(scale), off = _mm256_set1_ps(offset);
+   size_t  i = 0;
+
+   for (; i + 8 <= count; i += 8)
+      _mm256_storeu_ps(&dest[i], _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64((csi128 *)&src[i]))), mul), off));
+   _fpdt_decode8SSE(&dest[i], &src[i], count - i, scale, offset);
+}
+
+// 16-bit fixeds to 32-bit floats
+static inline _FPDT_TARGET_AVX2_ void _fpdt_decode16AVX2(fl32 *dest, cui16 *src, csize_t count, cfl32 scale, cfl32 offset) {
+   cfl32x8 mul = _mm256_set1_ps(scale), off = _mm256_set1_ps(offset);
+   size_t  i = 0;
+
+   for (; i + 8 <= count; i += 8)
+      _mm256_storeu_ps(&dest[i], _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(_mm_loadu_si128((csi128 *)&src[i]))), mul), off));
+   _fpdt_decode16SSE(&dest[i], &src[i], count - i, scale, offset);
+}
+
+#ifdef _24BIT_INTEGERS_
+// Packed 24-bit fixeds to 32-bit floats
+static inline _FPDT_TARGET_AVX2_ void _fpdt_decode24AVX2(fl32 *dest, cui8 *src, csize_t count, cfl32 scale, cfl32 offset) {
+   cfl32x8 mul = _mm256_set1_ps(scale), off = _mm256_set1_ps(offset);
+   cui256  shuffle = _mm256_broadcastsi128_si256(_fpdt_unshuffle24s);
+   size_t  i = 0;
+
+   for (; i + 11 <= count; i += 8) {
+      csi256 packed = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((csi128 *)&src[i * 3])), _mm_loadu_si128((csi128 *)&src[i * 3 + 12]), 1);
+
+      _mm256_storeu_ps(&dest[i], _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_shuffle_epi8(packed, shuffle)), mul), off));
+   }
+   _fpdt_decode24SSE(&dest[i], &src[i * 3], count - i, scale, offset);
+}
+#endif
+
+// 32-bit fixeds to 64-bit floats
+static inline _FPDT_TARGET_AVX2_ void _fpdt_decode32AVX2(fl64 *dest, cui32 *src, csize_t count, cfl64 scale, cfl64 offset) {
+   cfl64x4 mul = _mm256_set1_pd(scale), off = _mm256_set1_pd(offset), bias = _mm256_set1_pd(2147483648.0);
+   cui128  sign = _mm_set1_epi32(0x080000000);
+   size_t  i = 0;
+
+   for (; i + 4 <= count; i += 4)
+      _mm256_storeu_pd(&dest[i], _mm256_add_pd(_mm256_mul_pd(_mm256_add_pd(_mm256_cvtepi32_pd(_mm_xor_si128(_mm_loadu_si128((csi128 *)&src[i]), sign)), bias), mul), off));
+   _fpdt_decode32SSE(&dest[i], &src[i], count - i, scale, offset);
+}
+#endif
+
+#ifdef _FPDT_KERNELS_AVX512_
+// 8-bit fixeds to 32-bit floats
+static inline _FPDT_TARGET_AVX512_ void _fpdt_decode8AVX512(fl32 *dest, cui8 *src, csize_t count, cfl32 scale, cfl32 offset) {
+   cfl32x16 mul = _mm512_set1_ps(scale), off = _mm512_set1_ps(offset);
+   size_t   i = 0;
+
+   for (; i + 16 <= count; i += 16)
+      _mm512_storeu_ps(&dest[i], _mm512_add_ps(_mm512_mul_ps(_mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(_mm_loadu_si128((csi128 *)&src[i]))), mul), off));
+   if (i < count) {
+      const __mmask16 mask = __mmask16((1u << (count - i)) - 1u);
+
+      _mm512_mask_storeu_ps(&dest[i], mask, _mm512_add_ps(_mm512_mul_ps(_mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(_mm_maskz_loadu_epi8(mask, &src[i]))), mul), off));
+   }
+}
+
+// 16-bit fixeds to 32-bit floats
+static inline _FPDT_TARGET_AVX512_ void _fpdt_decode16AVX512(fl32 *dest, cui16 *src, csize_t count, cfl32 scale, cfl32 offset) {
+   cfl32x16 mul = _mm512_set1_ps(scale), off = _mm512_set1_ps(offset);
+   size_t   i = 0;
+
+   for (; i + 16 <= count; i += 16)
+      _mm512_storeu_ps(&dest[i], _mm512_add_ps(_mm512_mul_ps(_mm512_cvtepi32_ps(_mm512_cvtepu16_epi32(_mm256_loadu_si256((csi256 *)&src[i]))), mul), off));
+   if (i < count) {
+      const __mmask16 mask = __mmask16((1u << (count - i)) - 1u);
+
+      _mm512_mask_storeu_ps(&dest[i], mask, _mm512_add_ps(_mm512_mul_ps(_mm512_cvtepi32_ps(_mm512_cvtepu16_epi32(_mm256_maskz_loadu_epi16(mask, &src[i]))), mul), off));
+   }
+}
+
+#ifdef _24BIT_INTEGERS_
+// Packed 24-bit fixeds to 32-bit floats
+static inline _FPDT_TARGET_AVX512_ void _fpdt_decode24AVX512(fl32 *dest, cui8 *src, csize_t count, cfl32 scale, cfl32 offset) {
+   cfl32x16 mul = _mm512_set1_ps(scale), off = _mm512_set1_ps(offset);
+   cui512   shuffle = _mm512_broadcast_i32x4(_fpdt_unshuffle24s);
+   cui512   order = _mm512_setr_epi32(0, 1, 2, 0, 3, 4, 5, 0, 6, 7, 8, 0, 9, 10, 11, 0);
+   size_t   i = 0;
+
+   for (; i < count; i += 16) {
+      csize_t   remain = (count - i) < 16 ? count - i : 16;
+      const __mmask16 mask = __mmask16((1u << remain) - 1u);
+      const __mmask64 mask8 = remain == 16 ? 0x0FFFFFFFFFFFFu : (1ull << (remain * 3)) - 1ull;
+      csi512    packed = _mm512_permutexvar_epi32(order, _mm512_maskz_loadu_epi8(mask8, &src[i * 3]));
+
+      _mm512_mask_storeu_ps(&dest[i], mask, _mm512_add_ps(_mm512_mul_ps(_mm512_cvtepi32_ps(_mm512_shuffle_epi8(packed, shuffle)), mul), off));
+   }
+}
+#endif
+
+// 32-bit fixeds to 64-bit floats
+static inline _FPDT_TARGET_AVX512_ void _fpdt_decode32AVX512(fl64 *dest, cui32 *src, csize_t count, cfl64 scale, cfl64 offset) {
+   cfl64x8 mul = _mm512_set1_pd(scale), off = _mm512_set1_pd(offset);
+   size_t  i = 0;
+
+   for (; i + 8 <= count; i += 8)
+      _mm512_storeu_pd(&dest[i], _mm512_add_pd(_mm512_mul_pd(_mm512_cvtepu32_pd(_mm256_loadu_si256((csi256 *)&src[i])), mul), off));
+   if (i < count) {
+      const __mmask8 mask = __mmask8((1u << (count - i)) - 1u);
+
+      _mm512_mask_storeu_pd(&dest[i], mask, _mm512_add_pd(_mm512_mul_pd(_mm512_cvtepu32_pd(_mm256_maskz_loadu_epi32(mask, &src[i])), mul), off));
+   }
+}
+#endif
+
+/*******************
+ *  Range kernels  *
+ *******************/
+
+// Each kernel widens lo~hi to the smallest & largest of count floats; NaNs are skipped
+
+// 32-bit floats
+static inline void _fpdt_minMax32SSE(cfl32 *src, csize_t count, fl32 &lo, fl32 &hi) {
+   fl32x4 minA = _mm_set_ps1(lo), maxA = _mm_set_ps1(hi), minB = minA, maxB = maxA;
+   size_t i = 0;
+
+   // minps & maxps return their second operand when either is NaN, so the accumulators go second
+   for (; i + 8 <= count; i += 8) {
+      cfl32x4 a = _mm_loadu_ps(&src[i]), b = _mm_loadu_ps(&src[i + 4]);
+
+      minA = _mm_min_ps(a, minA); maxA = _mm_max_ps(a, maxA);
+      minB = _mm_min_ps(b, minB); maxB = _mm_max_ps(b, maxB);
+   }
+   minA = _mm_min_ps(minA, minB); maxA = _mm_max_ps(maxA, maxB);
+   minA = _mm_min_ps(minA, _mm_movehl_ps(minA, minA)); maxA = _mm_max_ps(maxA, _mm_movehl_ps(maxA, maxA));
+   lo = _mm_cvtss_f32(_mm_min_ss(minA, _mm_shuffle_ps(minA, minA, 1)));
+   hi = _mm_cvtss_f32(_mm_max_ss(maxA, _mm_shuffle_ps(maxA, maxA, 1)));
+   for (; i < count; i++) {
+      if (src[i] < lo) lo = src[i];
+      if (src[i] > hi) hi = src[i];
+   }
+}
+
+// 64-bit floats
+static inline void _fpdt_minMax64SSE(cfl64 *src, csize_t count, fl64 &lo, fl64 &hi) {
+   fl64x2 minA = _mm_set1_pd(lo), maxA = _mm_set1_pd(hi), minB = minA, maxB = maxA;
+   size_t i = 0;
+
+   for (; i + 4 <= count; i += 4) {
+      cfl64x2 a = _mm_loadu_pd(&src[i]), b = _mm_loadu_pd(&src[i + 2]);
+
+      minA = _mm_min_pd(a, minA); maxA = _mm_max_pd(a, maxA);
+      minB = _mm_min_pd(b, minB); maxB = _mm_max_pd(b, maxB);
+   }
+   minA = _mm_min_pd(minA, minB); maxA = _mm_max_pd(maxA, maxB);
+   lo = _mm_cvtsd_f64(_mm_min_sd(minA, _mm_unpackhi_pd(minA, minA)));
+   hi = _mm_cvtsd_f64(_mm_max_sd(maxA, _mm_unpackhi_pd(maxA, maxA)));
+   for (; i < count; i++) {
+      if (src[i] < lo) lo = src[i];
+      if (src[i] > hi) hi = src[i];
+   }
+}
+
+#ifdef _FPDT_KERNELS_AVX2_
+// 32-bit floats
+static inline _FPDT_TARGET_AVX2_ void _fpdt_minMax32AVX2(cfl32 *src, csize_t count, fl32 &lo, fl32 &hi) {
+   fl32x8 minA = _mm256_set1_ps(lo), maxA = _mm256_set1_ps(hi), minB = minA, maxB = maxA;
+   size_t i = 0;
+
+   for (; i + 16 <= count; i += 16) {
+      cfl32x8 a = _mm256_loadu_ps(&src[i]), b = _mm256_loadu_ps(&src[i + 8]);
+
+      minA = _mm256_min_ps(a, minA); maxA = _mm256_max_ps(a, maxA);
+      minB = _mm256_min_ps(b, minB); maxB = _mm256_max_ps(b, maxB);
+   }
+   minA = _mm256_min_ps(minA, minB); maxA = _mm256_max_ps(maxA, maxB);
+   fl32x4 minC = _mm_min_ps(_mm256_castps256_ps128(minA), _mm256_extractf128_ps(minA, 1));
+   fl32x4 maxC = _mm_max_ps(_mm256_castps256_ps128(maxA), _mm256_extractf128_ps(maxA, 1));
+   minC = _mm_min_ps(minC, _mm_movehl_ps(minC, minC)); maxC = _mm_max_ps(maxC, _mm_movehl_ps(maxC, maxC));
+   lo = _mm_cvtss_f32(_mm_min_ss(minC, _mm_shuffle_ps(minC, minC, 1)));
+   hi = _mm_cvtss_f32(_mm_max_ss(maxC, _mm_shuffle_ps(maxC, maxC, 1)));
+   _fpdt_minMax32SSE(&src[i], count - i, lo, hi);
+}
+
+// 64-bit floats
+static inline _FPDT_TARGET_AVX2_ void _fpdt_minMax64AVX2(cfl64 *src, csize_t count, fl64 &lo, fl64 &hi) {
+   fl64x4 minA = _mm256_set1_pd(lo), maxA = _mm256_set1_pd(hi), minB = minA, maxB = maxA;
+   size_t i = 0;
+
+   for (; i + 8 <= count; i += 8) {
+      cfl64x4 a = _mm256_loadu_pd(&src[i]), b = _mm256_loadu_pd(&src[i + 4]);
+
+      minA = _mm256_min_pd(a, minA); maxA = _mm256_max_pd(a, maxA);
+      minB = _mm256_min_pd(b, minB); maxB = _mm256_max_pd(b, maxB);
+   }
+   minA = _mm256_min_pd(minA, minB); maxA = _mm256_max_pd(maxA, maxB);
+   cfl64x2 minC = _mm_min_pd(_mm256_castpd256_pd128(minA), _mm256_extractf128_pd(minA, 1));
+   cfl64x2 maxC = _mm_max_pd(_mm256_castpd256_pd128(maxA), _mm256_extractf128_pd(maxA, 1));
+   lo = _mm_cvtsd_f64(_mm_min_sd(minC, _mm_unpackhi_pd(minC, minC)));
+   hi = _mm_cvtsd_f64(_mm_max_sd(maxC, _mm_unpackhi_pd(maxC, maxC)));
+   _fpdt_minMax64SSE(&src[i], count - i, lo, hi);
+}
+#endif
+
+#ifdef _FPDT_KERNELS_AVX512_
+// 32-bit floats
+static inline _FPDT_TARGET_AVX512_ void _fpdt_minMax32AVX512(cfl32 *src, csize_t count, fl32 &lo, fl32 &hi) {
+   fl32x16 minA = _mm512_set1_ps(lo), maxA = _mm512_set1_ps(hi), minB = minA, maxB = maxA;
+   size_t  i = 0;
+
+   for (; i + 32 <= count; i += 32) {
+      cfl32x16 a = _mm512_loadu_ps(&src[i]), b = _mm512_loadu_ps(&src[i + 16]);
+
+      minA = _mm512_min_ps(a, minA); maxA = _mm512_max_ps(a, maxA);
+      minB = _mm512_min_ps(b, minB); maxB = _mm512_max_ps(b, maxB);
+   }
+   for (; i < count; i += 16) {
+      const __mmask16 mask = count - i < 16 ? __mmask16((1u << (count - i)) - 1u) : __mmask16(0x0FFFF);
+      cfl32x16 a = _mm512_maskz_loadu_ps(mask, &src[i]);
+
+      minA = _mm512_mask_min_ps(minA, mask, a, minA); maxA = _mm512_mask_max_ps(maxA, mask, a, maxA);
+   }
+   lo = _mm512_reduce_min_ps(_mm512_min_ps(minA, minB));
+   hi = _mm512_reduce_max_ps(_mm512_max_ps(maxA, maxB));
+}
+
+// 64-bit floats
+static inline _FPDT_TARGET_AVX512_ void _fpdt_minMax64AVX512(cfl64 *src, csize_t count, fl64 &lo, fl64 &hi) {
+   fl64x8 minA = _mm512_set1_pd(lo), maxA = _mm512_set1_pd(hi), minB = minA, maxB = maxA;
+   size_t i = 0;
+
+   for (; i + 16 <= count; i += 16) {
+      cfl64x8 a = _mm512_loadu_pd(&src[i]), b = _mm512_loadu_pd(&src[i + 8]);
+
+      minA = _mm512_min_pd(a, minA); maxA = _mm512_max_pd(a, maxA);
+      minB = _mm512_min_pd(b, minB); maxB = _mm512_max_pd(b, maxB);
+   }
+   for (; i < count; i += 8) {
+      const __mmask8 mask = count - i < 8 ? __mmask8((1u << (count - i)) - 1u) : __mmask8(0x0FF);
+      cfl64x8 a = _mm512_maskz_loadu_pd(mask, &src[i]);
+
+      minA = _mm512_mask_min_pd(minA, mask, a, minA); maxA = _mm512_mask_max_pd(maxA, mask, a, maxA);
+   }
+   lo = _mm512_reduce_min_pd(_mm512_min_pd(minA, minB));
+   hi = _mm512_reduce_max_pd(_mm512_max_pd(maxA, maxB));
+}
+#endif
+
+/*
+ *  Kernel tables, indexed by rounding mode (encodes only), then by fpdtISA()
+ */
+
+static decltype(&_fpdt_encode8SSE<FPDT_ROUND_TRUNCATE>) const _fpdt_encode8ISA[][3] = _FPDT_ROUNDED_KERNELS_(_fpdt_encode8);
+static decltype(&_fpdt_encode16SSE<FPDT_ROUND_TRUNCATE>) const _fpdt_encode16ISA[][3] = _FPDT_ROUNDED_KERNELS_(_fpdt_encode16);
+#ifdef _24BIT_INTEGERS_
+static decltype(&_fpdt_encode24SSE<FPDT_ROUND_TRUNCATE>) const _fpdt_encode24ISA[][3] = _FPDT_ROUNDED_KERNELS_(_fpdt_encode24);
+#endif
+static decltype(&_fpdt_encode32SSE<FPDT_ROUND_TRUNCATE>) const _fpdt_encode32ISA[][3] = _FPDT_ROUNDED_KERNELS_(_fpdt_encode32);
+static decltype(&_fpdt_decode8SSE) const _fpdt_decode8ISA[] = _FPDT_KERNELS_(_fpdt_decode8);
+static decltype(&_fpdt_decode16SSE) const _fpdt_decode16ISA[] = _FPDT_KERNELS_(_fpdt_decode16);
+#ifdef _24BIT_INTEGERS_
+static decltype(&_fpdt_decode24SSE) const _fpdt_decode24ISA[] = _FPDT_KERNELS_(_fpdt_decode24);
+#endif
+static decltype(&_fpdt_decode32SSE) const _fpdt_decode32ISA[] = _FPDT_KERNELS_(_fpdt_decode32);
+static decltype(&_fpdt_minMax32SSE) const _fpdt_minMax32ISA[] = _FPDT_KERNELS_(_fpdt_minMax32);
+static decltype(&_fpdt_minMax64SSE) const _fpdt_minMax64ISA[] = _FPDT_KERNELS_(_fpdt_minMax64);
+
+static inline void _fpdt_encode8(ui8 *dest, cfl32 *src, csize_t count, cfl32 offset, cfl32 scale, cui32 round) { _fpdt_encode8ISA[round][fpdtISA()](dest, src, count, offset, scale); }
+static inline void _fpdt_encode16(ui16 *dest, cfl32 *src, csize_t count, cfl32 offset, cfl32 scale, cui32 round) { _fpdt_encode16ISA[round][fpdtISA()](dest, src, count, offset, scale); }
+#ifdef _24BIT_INTEGERS_
+static inline void _fpdt_encode24(ui8 *dest, cfl32 *src, csize_t count, cfl32 offset, cfl32 scale, cui32 round) { _fpdt_encode24ISA[round][fpdtISA()](dest, src, count, offset, scale); }
+#endif
+static inline void _fpdt_encode32(ui32 *dest, cfl64 *src, csize_t count, cfl64 offset, cfl64 scale, cui32 round) { _fpdt_encode32ISA[round][fpdtISA()](dest, src, count, offset, scale); }
+
+static inline void _fpdt_decode8(fl32 *dest, cui8 *src, csize_t count, cfl32 scale, cfl32 offset) { _fpdt_decode8ISA[fpdtISA()](dest, src, count, scale, offset); }
+static inline void _fpdt_decode16(fl32 *dest, cui16 *src, csize_t count, cfl32 scale, cfl32 offset) { _fpdt_decode16ISA[fpdtISA()](dest, src, count, scale, offset); }
+#ifdef _24BIT_INTEGERS_
+static inline void _fpdt_decode24(fl32 *dest, cui8 *src, csize_t count, cfl32 scale, cfl32 offset) { _fpdt_decode24ISA[fpdtISA()](dest, src, count, scale, offset); }
+#endif
+static inline void _fpdt_decode32(fl64 *dest, cui32 *src, csize_t count, cfl64 scale, cfl64 offset) { _fpdt_decode32ISA[fpdtISA()](dest, src, count, scale, offset); }
+
+static inline void _fpdt_minMax32(cfl32 *src, csize_t count, fl32 &lo, fl32 &hi) { _fpdt_minMax32ISA[fpdtISA()](src, count, lo, hi); }
+static inline void _fpdt_minMax64(cfl64 *src, csize_t count, fl64 &lo, fl64 &hi) { _fpdt_minMax64ISA[fpdtISA()](src, count, lo, hi); }
+
+/*********************************************
+ *  Floating-point to fixed-point functions  *
+ *********************************************/
+
+/*
+ *  User-definable range
+ */
+
+#ifndef FPDT_NO_CUSTOM
+inline void fpdtToFixed(fp8n *dest, cfl32 *src, csize_t count, const fpdtRange &range, cui32 round = FPDT_ROUND_TRUNCATE) { _fpdt_encode8((ui8 *)dest, src, count, -range.origin8, range.maxDivRange8, round); }
+inline void fpdtToFixed(fp8n *dest, cfl32 *src, csize_t count, cui32 round = FPDT_ROUND_TRUNCATE) { fpdtToFixed(dest, src, count, __fpdt_data__, round); }
+inline void fpdtToFixed(fp8nx4 *dest, cfl32 *src, csize_t count, const fpdtRange &range, cui32 round = FPDT_ROUND_TRUNCATE) { _fpdt_encode8((ui8 *)dest, src, count << 2, -range.origin8, range.maxDivRange8, round); }
+inline void fpdtToFixed(fp8nx4 *dest, cfl32 *src, csize_t count, cui32 round = FPDT_ROUND_TRUNCATE) { fpdtToFixed(dest, src, count, __fpdt_data__, round); }
+inline void fpdtToFixed(fp16n *dest, cfl32 *src, csize_t count, const fpdtRange &range, cui32 round = FPDT_ROUND_TRUNCATE) { _fpdt_encode16((ui16 *)dest, src, count, -range.origin16, range.maxDivRange16, round); }
+inline void fpdtToFixed(fp16n *dest, cfl32 *src, csize_t count, cui32 round = FPDT_ROUND_TRUNCATE) { fpdtToFixed(dest, src, count, __fpdt_data__, round); }
+inline void fpdtToFixed(fp16nx4 *dest, cfl32 *src, csize_t count, const fpdtRange &range, cui32 round = FPDT_ROUND_TRUNCATE) { _fpdt_encode16((ui16 *)dest, src, count << 2, -range.origin16, range.maxDivRange16, round); }
+inline void fpdtToFixed(fp16nx4 *dest, cfl32 *src, csize_t count, cui32 round = FPDT_ROUND_TRUNCATE) { fpdtToFixed(dest, src, count, __fpdt_data__, round); }
+#ifdef _24BIT_INTEGERS_
+inline void fpdtToFixed(fp24n *dest, cfl32 *src, csize_t count, const fpdtRange &range, cui32 round = FPDT_ROUND_TRUNCATE) { _fpdt_encode24((ui8 *)dest, src, count, -range.origin24, range.maxDivRange24, round); }
+inline void fpdtToFixed(fp24n *dest, cfl32 *src, csize_t count, cui32 round = FPDT_ROUND_TRUNCATE) { fpdtToFixed(dest, src, count, __fpdt_data__, round); }
+#endif
+inline void fpdtToFixed(fp32n *dest, cfl64 *src, csize_t count, const fpdtRange &range, cui32 round = FPDT_ROUND_TRUNCATE) { _fpdt_encode32((ui32 *)dest, src, count, -range.origin32, range.maxDivRange32, round); }
+inline void fpdtToFixed(fp32n *dest, cfl64 *src, csize_t count, cui32 round = FPDT_ROUND_TRUNCATE) { fpdtToFixed(dest, src, count, __fpdt_data__, round); }
+#endif
+
+/*
+ *  8-bit
+ */
+
+inline void fpdtToFixed(f0p8 *dest, cfl32 *src, csize_t count, cui32 round = FPDT_ROUND_TRUNCATE) { _fpdt_encode8((ui8 *)dest, src, count, 0.0f, 256.0f, round); }
+inline void fpdtToFixed(f1p7 *dest, cfl32 *src, csize_t count, cui32 round = FPDT_ROUND_TRUNCATE) { _fpdt_encode8((ui8 *)dest, src, count, 0.0f, 128.0f, round); }
+inline void fpdtToFixed(f4p4 *dest, cfl32 *src, csize_t count, cui32 round = FPDT_ROUND_TRUNCATE) { _fpdt_encode8((ui8 *)dest, src, count, 0.0f, 16.0f, round); }
+inline void fpdtToFixed(fp8n0_1 *dest, cfl32 *src, csize_t count, cui32 round = FPDT_ROUND_TRUNCATE) { _fpdt_encode8((ui8 *)dest, src, count, 0.0f, 255.0f, round); }
+inline void fpdtToFixed(fp8n0_1x4 *dest, cfl32 *src, csize_t count, cui32 round = FPDT_ROUND_TRUNCATE) { _fpdt_encode8((ui8 *)dest, src, count << 2, 0.0f, 255.0f, round); }
+
+/*
+ *  16-bit
+ */
+
+inline void fpdtToFixed(f0p16 *dest, cfl32 *src, csize_t count, cui32 round = FPDT_ROUND_TRUNCATE) { _fpdt_encode16((ui16 *)dest, src, count, 0.0f, 65536.0f, round); }
+inline void fpdtToFixed(fs1p14 *dest, cfl32 *src, csize_t count, cui32 round = FPDT_ROUND_TRUNCATE) { _fpdt_encode16((ui16 *)dest, src, count, 2.0f, 16384.0f, round); }
+inline void fpdtToFixed(f1p15 *dest, cfl32 *src, csize_t count, cui32 round = FPDT_ROUND_TRUNCATE) { _fpdt_encode16((ui16 *)dest, src, count, 0.0f, 32768.0f, round); }
+inline void fpdtToFixed(f6p10 *dest, cfl32 *src, csize_t count, cui32 round = FPDT_ROUND_TRUNCATE) { _fpdt_encode16((ui16 *)dest, src, count, 0.0f, 1024.0f, round); }
+inline void fpdtToFixed(fs7p8 *dest, cfl32 *src, csize_t count, cui32 round = FPDT_ROUND_TRUNCATE) { _fpdt_encode16((ui16 *)dest, src, count, 128.0f, 256.0f, round); }
+inline void fpdtToFixed(f7p9 *dest, cfl32 *src, csize_t count, cui32 round = FPDT_ROUND_TRUNCATE) { _fpdt_encode16((ui16 *)dest, src, count, 0.0f, 512.0f, round); }
+inline void fpdtToFixed(f8p8 *dest, cfl32 *src, csize_t count, cui32 round = FPDT_ROUND_TRUNCATE) { _fpdt_encode16((ui16 *)dest, src, count, 0.0f, 256.0f, round); }
+inline void fpdtToFixed(fp16n0_1 *dest, cfl32 *src, csize_t count, cui32 round = FPDT_ROUND_TRUNCATE) { _fpdt_encode16((ui16 *)dest, src, count, 0.0f, 65535.0f, round); }
+inline void fpdtToFixed(fp16n0_2 *dest, cfl32 *src, csize_t count, cui32 round = FPDT_ROUND_TRUNCATE) { _fpdt_encode16((ui16 *)dest, src, count, 0.0f, 32767.5f, round); }
+inline void fpdtToFixed(fp16n0_3 *dest, cfl32 *src, csize_t count, cui32 round = FPDT_ROUND_TRUNCATE) { _fpdt_encode16((ui16 *)dest, src, count, 0.0f, 21845.0f, round); }
+inline void fpdtToFixed(fp16n0_128 *dest, cfl32 *src, csize_t count, cui32 round = FPDT_ROUND_TRUNCATE) { _fpdt_encode16((ui16 *)dest, src, count, 0.0f, _fpdt_65535div128f, round); }
+inline void fpdtToFixed(fp16n_1_1 *dest, cfl32 *src, csize_t count, cui32 round = FPDT_ROUND_TRUNCATE) { _fpdt_encode16((ui16 *)dest, src, count, 1.0f, _fpdt_65535div2f, round); }
+inline void fpdtToFixed(fp16n_128_128 *dest, cfl32 *src, csize_t count, cui32 round = FPDT_ROUND_TRUNCATE) { _fpdt_encode16((ui16 *)dest, src, count, 128.0f, _fpdt_65535div256f, round); }
+inline void fpdtToFixed(fs7p8x3 *dest, cfl32 *src, csize_t count, cui32 round = FPDT_ROUND_TRUNCATE) { _fpdt_encode16((ui16 *)dest, src, count * 3, 128.0f, 256.0f, round); }
+inline void fpdtToFixed(f1p15x4 *dest, cfl32 *src, csize_t count, cui32 round = FPDT_ROUND_TRUNCATE) { _fpdt_encode16((ui16 *)dest, src, count << 2, 0.0f, 32768.0f, round); }
+inline void fpdtToFixed(fp16n0_1x4 *dest, cfl32 *src, csize_t count, cui32 round = FPDT_ROUND_TRUNCATE) { _fpdt_encode16((ui16 *)dest, src, count << 2, 0.0f, 65535.0f, round); }
+inline void fpdtToFixed(fp16n0_3x16 *dest, cfl32 *src, csize_t count, cui32 round = FPDT_ROUND_TRUNCATE) { _fpdt_encode16((ui16 *)dest, src, count << 4, 0.0f, 21845.0f, round); }
+
+/*
+ *  24-bit
+ */
+
+#ifdef _24BIT_INTEGERS_
+inline void fpdtToFixed(f0p24 *dest, cfl32 *src, csize_t count, cui32 round = FPDT_ROUND_TRUNCATE) { _fpdt_encode24((ui8 *)dest, src, count, 0.0f, 16777216.0f, round); }
+inline void fpdtToFixed(f8p16 *dest, cfl32 *src, csize_t count, cui32 round = FPDT_ROUND_TRUNCATE) { _fpdt_encode24((ui8 *)dest, src, count, 0.0f, 65536.0f, round); }
+inline void fpdtToFixed(f12p12 *dest, cfl32 *src, csize_t count, cui32 round = FPDT_ROUND_TRUNCATE) { _fpdt_encode24((ui8 *)dest, src, count, 0.0f, 4096.0f, round); }
+inline void fpdtToFixed(f16p8 *dest, cfl32 *src, csize_t count, cui32 round = FPDT_ROUND_TRUNCATE) { _fpdt_encode24((ui8 *)dest, src, count, 0.0f, 256.0f, round); }
+inline void fpdtToFixed(fp24n0_1 *dest, cfl32 *src, csize_t count, cui32 round = FPDT_ROUND_TRUNCATE) { _fpdt_encode24((ui8 *)dest, src, count, 0.0f, 16777215.0f, round); }
+inline void fpdtToFixed(fp24n_1_1 *dest, cfl32 *src, csize_t count, cui32 round = FPDT_ROUND_TRUNCATE) { _fpdt_encode24((ui8 *)dest, src, count, 1.0f, 8388607.5f, round); }
+#endif
+
+/*
+ *  32-bit
+ */
+
+inline void fpdtToFixed(f0p32 *dest, cfl64 *src, csize_t count, cui32 round = FPDT_ROUND_TRUNCATE) { _fpdt_encode32((ui32 *)dest, src, count, 0.0, 4294967296.0, round); }
+inline void fpdtToFixed(f16p16 *dest, cfl64 *src, csize_t count, cui32 round = FPDT_ROUND_TRUNCATE) { _fpdt_encode32((ui32 *)dest, src, count, 0.0, 65536.0, round); }
+inline void fpdtToFixed(fp32n0_1 *dest, cfl64 *src, csize_t count, cui32 round = FPDT_ROUND_TRUNCATE) { _fpdt_encode32((ui32 *)dest, src, count, 0.0, 4294967295.0, round); }
+inline void fpdtToFixed(fp32n_1_1 *dest, cfl64 *src, csize_t count, cui32 round = FPDT_ROUND_TRUNCATE) { _fpdt_encode32((ui32 *)dest, src, count, 1.0, 2147483647.5, round); }
+
+/*********************************************
+ *  Fixed-point to floating-point functions  *
+ *********************************************/
+
+/*
+ *  User-definable range
+ */
+
+#ifndef FPDT_NO_CUSTOM
+inline void fpdtToFloat(fl32 *dest, const fp8n *src, csize_t count, const fpdtRange &range) { _fpdt_decode8(dest, (cui8 *)src, count, range.rangeDivMax8, range.origin8); }
+inline void fpdtToFloat(fl32 *dest, const fp8n *src, csize_t count) { fpdtToFloat(dest, src, count, __fpdt_data__); }
+inline void fpdtToFloat(fl32 *dest, const fp8nx4 *src, csize_t count, const fpdtRange &range) { _fpdt_decode8(dest, (cui8 *)src, count << 2, range.rangeDivMax8, range.origin8); }
+inline void fpdtToFloat(fl32 *dest, const fp8nx4 *src, csize_t count) { fpdtToFloat(dest, src, count, __fpdt_data__); }
+inline void fpdtToFloat(fl32 *dest, const fp16n *src, csize_t count, const fpdtRange &range) { _fpdt_decode16(dest, (cui16 *)src, count, range.rangeDivMax16, range.origin16); }
+inline void fpdtToFloat(fl32 *dest, const fp16n *src, csize_t count) { fpdtToFloat(dest, src, count, __fpdt_data__); }
+inline void fpdtToFloat(fl32 *dest, const fp16nx4 *src, csize_t count, const fpdtRange &range) { _fpdt_decode16(dest, (cui16 *)src, count << 2, range.rangeDivMax16, range.origin16); }
+inline void fpdtToFloat(fl32 *dest, const fp16nx4 *src, csize_t count) { fpdtToFloat(dest, src, count, __fpdt_data__); }
+#ifdef _24BIT_INTEGERS_
+inline void fpdtToFloat(fl32 *dest, const fp24n *src, csize_t count, const fpdtRange &range) { _fpdt_decode24(dest, (cui8 *)src, count, range.rangeDivMax24, range.origin24); }
+inline void fpdtToFloat(fl32 *dest, const fp24n *src, csize_t count) { fpdtToFloat(dest, src, count, __fpdt_data__); }
+#endif
+inline void fpdtToFloat(fl64 *dest, const fp32n *src, csize_t count, const fpdtRange &range) { _fpdt_decode32(dest, (cui32 *)src, count, range.rangeDivMax32, range.origin32); }
+inline void fpdtToFloat(fl64 *dest, const fp32n *src, csize_t count) { fpdtToFloat(dest, src, count, __fpdt_data__); }
+#endif
+
+/*
+ *  8-bit
+ */
+
+inline void fpdtToFloat(fl32 *dest, const f0p8 *src, csize_t count) { _fpdt_decode8(dest, (cui8 *)src, count, _fpdt_rcp256f, 0.0f); }
+inline void fpdtToFloat(fl32 *dest, const f1p7 *src, csize_t count) { _fpdt_decode8(dest, (cui8 *)src, count, _fpdt_rcp128f, 0.0f); }
+inline void fpdtToFloat(fl32 *dest, const f4p4 *src, csize_t count) { _fpdt_decode8(dest, (cui8 *)src, count, _fpdt_rcp16f, 0.0f); }
+inline void fpdtToFloat(fl32 *dest, const fp8n0_1 *src, csize_t count) { _fpdt_decode8(dest, (cui8 *)src, count, _fpdt_rcp255f, 0.0f); }
+inline void fpdtToFloat(fl32 *dest, const fp8n0_1x4 *src, csize_t count) { _fpdt_decode8(dest, (cui8 *)src, count << 2, _fpdt_rcp255f, 0.0f); }
+
+/*
+ *  16-bit
+ */
+
+inline void fpdtToFloat(fl32 *dest, const f0p16 *src, csize_t count) { _fpdt_decode16(dest, (cui16 *)src, count, _fpdt_rcp65536f, 0.0f); }
+inline void fpdtToFloat(fl32 *dest, const fs1p14 *src, csize_t count) { _fpdt_decode16(dest, (cui16 *)src, count, _fpdt_rcp16384f, -2.0f); }
+inline void fpdtToFloat(fl32 *dest, const f1p15 *src, csize_t count) { _fpdt_decode16(dest, (cui16 *)src, count, _fpdt_rcp32768f, 0.0f); }
+inline void fpdtToFloat(fl32 *dest, const f6p10 *src, csize_t count) { _fpdt_decode16(dest, (cui16 *)src, count, _fpdt_rcp1024f, 0.0f); }
+inline void fpdtToFloat(fl32 *dest, const fs7p8 *src, csize_t count) { _fpdt_decode16(dest, (cui16 *)src, count, _fpdt_rcp256f, -128.0f); }
+inline void fpdtToFloat(fl32 *dest, const f7p9 *src, csize_t count) { _fpdt_decode16(dest, (cui16 *)src, count, _fpdt_rcp512f, 0.0f); }
+inline void fpdtToFloat(fl32 *dest, const f8p8 *src, csize_t count) { _fpdt_decode16(dest, (cui16 *)src, count, _fpdt_rcp256f, 0.0f); }
+inline void fpdtToFloat(fl32 *dest, const fp16n0_1 *src, csize_t count) { _fpdt_decode16(dest, (cui16 *)src, count, _fpdt_rcp65535f, 0.0f); }
+inline void fpdtToFloat(fl32 *dest, const fp16n0_2 *src, csize_t count) { _fpdt_decode16(dest, (cui16 *)src, count, _fpdt_2div65535f, 0.0f); }
+inline void fpdtToFloat(fl32 *dest, const fp16n0_3 *src, csize_t count) { _fpdt_decode16(dest, (cui16 *)src, count, _fpdt_3div65535f, 0.0f); }
+inline void fpdtToFloat(fl32 *dest, const fp16n0_128 *src, csize_t count) { _fpdt_decode16(dest, (cui16 *)src, count, _fpdt_128div65535f, 0.0f); }
+inline void fpdtToFloat(fl32 *dest, const fp16n_1_1 *src, csize_t count) { _fpdt_decode16(dest, (cui16 *)src, count, _fpdt_2div65535f, -1.0f); }
+inline void fpdtToFloat(fl32 *dest, const fp16n_128_128 *src, csize_t count) { _fpdt_decode16(dest, (cui16 *)src, count, _fpdt_256div65535f, -128.0f); }
+inline void fpdtToFloat(fl32 *dest, const fs7p8x3 *src, csize_t count) { _fpdt_decode16(dest, (cui16 *)src, count * 3, _fpdt_rcp256f, -128.0f); }
+inline void fpdtToFloat(fl32 *dest, const f1p15x4 *src, csize_t count) { _fpdt_decode16(dest, (cui16 *)src, count << 2, _fpdt_rcp32768f, 0.0f); }
+inline void fpdtToFloat(fl32 *dest, const fp16n0_1x4 *src, csize_t count) { _fpdt_decode16(dest, (cui16 *)src, count << 2, _fpdt_rcp65535f, 0.0f); }
+inline void fpdtToFloat(fl32 *dest, const fp16n0_3x16 *src, csize_t count) { _fpdt_decode16(dest, (cui16 *)src, count << 4, _fpdt_3div65535f, 0.0f); }
+
+/*
+ *  24-bit
+ */
+
+#ifdef _24BIT_INTEGERS_
+inline void fpdtToFloat(fl32 *dest, const f0p24 *src, csize_t count) { _fpdt_decode24(dest, (cui8 *)src, count, _fpdt_rcp2p24f, 0.0f); }
+inline void fpdtToFloat(fl32 *dest, const f8p16 *src, csize_t count) { _fpdt_decode24(dest, (cui8 *)src, count, _fpdt_rcp65536f, 0.0f); }
+inline void fpdtToFloat(fl32 *dest, const f12p12 *src, csize_t count) { _fpdt_decode24(dest, (cui8 *)src, count, _fpdt_rcp4096f, 0.0f); }
+inline void fpdtToFloat(fl32 *dest, const f16p8 *src, csize_t count) { _fpdt_decode24(dest, (cui8 *)src, count, _fpdt_rcp256f, 0.0f); }
+inline void fpdtToFloat(fl32 *dest, const fp24n0_1 *src, csize_t count) { _fpdt_decode24(dest, (cui8 *)src, count, _fpdt_rcp2p24_1f, 0.0f); }
+inline void fpdtToFloat(fl32 *dest, const fp24n_1_1 *src, csize_t count) { _fpdt_decode24(dest, (cui8 *)src, count, _fpdt_2div2p24_1f, -1.0f); }
+#endif
+
+/*
+ *  32-bit
+ */
+
+inline void fpdtToFloat(fl64 *dest, const f0p32 *src, csize_t count) { _fpdt_decode32(dest, (cui32 *)src, count, _fpdt_rcp2p32, 0.0); }
+inline void fpdtToFloat(fl64 *dest, const f16p16 *src, csize_t count) { _fpdt_decode32(dest, (cui32 *)src, count, _fpdt_rcp65536, 0.0); }
+inline void fpdtToFloat(fl64 *dest, const fp32n0_1 *src, csize_t count) { _fpdt_decode32(dest, (cui32 *)src, count, _fpdt_rcp2p32_1, 0.0); }
+inline void fpdtToFloat(fl64 *dest, const fp32n_1_1 *src, csize_t count) { _fpdt_decode32(dest, (cui32 *)src, count, _fpdt_2div2p32_1, -1.0); }
+
+/***********************
+ *  Range calibration  *
+ ***********************/
+
+// Scale of top / (ceiling - floor), lowered until the ceiling's code, as the encode kernels compute it, is no more
+// than top; otherwise float rounding could leave it a fraction above, which rounding up would carry past the top code
+static inline cfl32 _fpdt_fitScale(cfl32 floor, cfl32 ceiling, cfl32 top) {
+   cfl32 range = ceiling - floor;
+   fl32  scale = range > 0.0f ? top / range : 0.0f;
+
+   while (range * scale > top) scale *= 0.99999988f;
+   return scale;
+}
+
+#ifndef FPDT_NO_CUSTOM
+// Turns the min & max found by _fpdt_minMax32() into a range; a constant, empty, or all-NaN input gets floor~floor + 1 + |floor|
+static inline void _fpdt_settle32(fl32 &floor, fl32 &ceiling) {
+   if (!(floor <= ceiling)) floor = ceiling = 0.0f;
+   if (ceiling == floor) ceiling = floor + 1.0f + (floor < 0.0f ? -floor : floor);
+}
+
+// As _fpdt_settle32(), with the ceiling raised by 2 codes or more, since setRange32() maps it to 2^32
+static inline void _fpdt_settle64(fl64 &floor, fl64 &ceiling) {
+   if (!(floor <= ceiling)) floor = ceiling = 0.0;
+   if (ceiling == floor) ceiling = floor + 1.0 + (floor < 0.0 ? -floor : floor);
+
+   fl64 step = (ceiling - floor) * _fpdt_rcp2p32 * 2.0;
+
+   while (ceiling + step == ceiling) step += step;
+   ceiling += step;
+}
+
+// Range of count floats; NaNs are skipped
+static inline void _fpdt_bounds32(cfl32 *src, csize_t count, fl32 &floor, fl32 &ceiling) {
+   floor = 3.402823466e+38f; ceiling = -3.402823466e+38f;
+   _fpdt_minMax32(src, count, floor, ceiling);
+   _fpdt_settle32(floor, ceiling);
+}
+
+static inline void _fpdt_bounds64(cfl64 *src, csize_t count, fl64 &floor, fl64 &ceiling) {
+   floor = 1.7976931348623157e+308; ceiling = -1.7976931348623157e+308;
+   _fpdt_minMax64(src, count, floor, ceiling);
+   _fpdt_settle64(floor, ceiling);
+}
+
+// Each function finds the range of src with SIMD min & max, stores it in range, & encodes src with it; the smallest
+// value gets code 0 & the largest the top code or, when truncating, the one below. Without a range, the current one is set
+inline void fpdtCalibrate(fp8n *dest, cfl32 *src, csize_t count, fpdtRange &range, cui32 round = FPDT_ROUND_TRUNCATE) {
+   fl32 floor, ceiling;
+
+   _fpdt_bounds32(src, count, floor, ceiling);
+   range.setRange8(floor, ceiling);
+   range.maxDivRange8 = _fpdt_fitScale(floor, ceiling, 255.0f);
+   fpdtToFixed(dest, src, count, range, round);
+}
+inline void fpdtCalibrate(fp8n *dest, cfl32 *src, csize_t count, cui32 round = FPDT_ROUND_TRUNCATE) { fpdtCalibrate(dest, src, count, __fpdt_data__, round); }
+
+inline void fpdtCalibrate(fp16n *dest, cfl32 *src, csize_t count, fpdtRange &range, cui32 round = FPDT_ROUND_TRUNCATE) {
+   fl32 floor, ceiling;
+
+   _fpdt_bounds32(src, count, floor, ceiling);
+   range.setRange16(floor, ceiling);
+   range.maxDivRange16 = _fpdt_fitScale(floor, ceiling, 65535.0f);
+   fpdtToFixed(dest, src, count, range, round);
+}
+inline void fpdtCalibrate(fp16n *dest, cfl32 *src, csize_t count, cui32 round = FPDT_ROUND_TRUNCATE) { fpdtCalibrate(dest, src, count, __fpdt_data__, round); }
+
+#ifdef _24BIT_INTEGERS_
+inline void fpdtCalibrate(fp24n *dest, cfl32 *src, csize_t count, fpdtRange &range, cui32 round = FPDT_ROUND_TRUNCATE) {
+   fl32 floor, ceiling;
+
+   _fpdt_bounds32(src, count, floor, ceiling);
+   range.setRange24(floor, ceiling);
+   range.maxDivRange24 = _fpdt_fitScale(floor, ceiling, 16777215.0f);
+   fpdtToFixed(dest, src, count, range, round);
+}
+inline void fpdtCalibrate(fp24n *dest, cfl32 *src, csize_t count, cui32 round = FPDT_ROUND_TRUNCATE) { fpdtCalibrate(dest, src, count, __fpdt_data__, round); }
+#endif
+
+inline void fpdtCalibrate(fp32n *dest, cfl64 *src, csize_t count, fpdtRange &range, cui32 round = FPDT_ROUND_TRUNCATE) {
+   fl64 floor, ceiling;
+
+   _fpdt_bounds64(src, count, floor, ceiling);
+   range.setRange32(floor, ceiling);
+   fpdtToFixed(dest, src, count, range, round);
+}
+inline void fpdtCalibrate(fp32n *dest, cfl64 *src, csize_t count, cui32 round = FPDT_ROUND_TRUNCATE) { fpdtCalibrate(dest, src, count, __fpdt_data__, round); }
+#endif
@@ -0,0 +1,634 @@
+/**********************************************************************
+ * File: Fixed-point colour formats.h             Created: 2024/07/17 *
+ *                                          Last modified: 2024/07/26 *
+ *                                                                    *
+ * Desc: Packed colour types, & bulk encode & decode between arrays   *
+ *       of 4-float colours (range 0.0~1.0) & packed pixels, for      *
+ *       R8G9B7A8, RGB565, RGB10A2, & R11G11B10F, & between linear    *
+ *       floats & the sRGB codes of fp8n0_1 & fp8n0_1x4.              *
+ *       R8G9B7A8 is the format of Fix8978() in "Fixed-point math.h". *
+ *                                                                    *
+ * Notes: Encodes multiply, convert, mask, & shift every channel of   *
+ *        a colour in one register, then merge the channels of 4, 8,  *
+ *        or 16 colours with horizontal adds or two-source permutes;  *
+ *        channels never overlap, so adding them ORs them.            *
+ *        Decodes broadcast each pixel to 4 lanes, then shift, mask,  *
+ *        convert, & scale them.                                      *
+ *        Normalised channels truncate, as Fix8978(); the 11 & 10-bit *
+ *        unsigned floats of R11G11B10F round to nearest even, clamp  *
+ *        to 65024 & 64512, & encode negative values as 0.            *
+ *        Formats without alpha decode it as 1.0.                     *
+ *        sRGB decodes gather from a 256-entry table; encodes are a   *
+ *        rational approximation, corrected with one gathered code    *
+ *        threshold, so codes are rounded exactly as the sRGB curve.  *
+ *        Kernels are SSE, AVX2, or AVX512, chosen by fpdtISA(), with *
+ *        scalar tails, & match the scalar conversions exactly.       *
+ *                                                                    *
+ * MIT license.                     Copyright (c) David William Bull. *
+ **********************************************************************/
+#pragma once
+
+#include <cmath>
+#include "vector structures.h"
+#include "Fixed-point data types.h"
+#include "Fixed-point CPU dispatch.h"
+
+#define _FIXED_POINT_COLOUR_FORMATS_
+
+/*************************
+ *  Normalised channels  *
+ *************************/
+
+// Packed channels of R, G, B, & A bits, from bit 0 upward; A may be 0
+template<typename T, cui32 R, cui32 G, cui32 B, cui32 A> struct _fpc_unorm {
+   typedef T packed;
+
+   static_assert(!A || R + G + B + A == 32, "_fpc_unorm requires alpha to be the top bits of a 32-bit pixel");
+
+   static constexpr ui32 width[4] = { R, G, B, A };
+   static constexpr ui32 channels = A ? 4 : 3;
+
+   static constexpr ui32 top(cui32 i) { return width[i] ? (1u << width[i]) - 1u : 0; }   // Code of 1.0
+   static constexpr ui32 shift(cui32 i) { return i == 0 ? 0 : i == 1 ? R : i == 2 ? R + G : A ? R + G + B : 32; }
+   static constexpr fl32 rcp(cui32 i) { return width[i] ? 1.0f / fl32(top(i)) : 0.0f; }
+   static constexpr fl32 one(cui32 i) { return width[i] ? 0.0f : 1.0f; }          // Added to decoded channels, so a missing alpha is 1.0
+
+   static inline cui32 fix(cfl32 *c) {
+      ui32 p = 0;
+      for (ui32 i = 0; i < channels; i++) p |= (ui32(c[i] * fl32(top(i))) & top(i)) << shift(i);
+      return p;
+   }
+
+   static inline void toFloat(fl32 *c, cui32 p) {
+      for (ui32 i = 0; i < channels; i++) c[i] = fl32((p >> shift(i)) & top(i)) * (1.0f / fl32(top(i)));
+      if constexpr (!A) c[3] = 1.0f;
+   }
+
+   static inline cfl32x4 scale4(void) { return _mm_setr_ps(fl32(top(0)), fl32(top(1)), fl32(top(2)), fl32(top(3))); }
+   static inline csi128 mask4(void) { return _mm_setr_epi32(top(0), top(1), top(2), top(3)); }
+   static inline csi128 shift4(void) { return _mm_setr_epi32(shift(0), shift(1), shift(2), shift(3)); }
+   static inline cfl32x4 rcp4(void) { return _mm_setr_ps(rcp(0), rcp(1), rcp(2), rcp(3)); }
+   static inline cfl32x4 one4(void) { return _mm_setr_ps(one(0), one(1), one(2), one(3)); }
+
+   // SSE has no variable shifts: encodes multiply by powers of 2; decodes mask channels in place & scale by their shifts too, apart from the top channel, which is shifted down so it converts as unsigned
+   static inline csi128 fieldsSSE(cfl32x4 v) {
+      return _mm_mullo_epi32(_mm_and_si128(_mm_cvttps_epi32(_mm_mul_ps(v, scale4())), mask4()), _mm_setr_epi32(1, 1 << shift(1), 1 << shift(2), A ? 1 << shift(3) : 0));
+   }
+
+   static inline cfl32x4 floatsSSE(csi128 p) {
+      csi128 fields = _mm_blend_epi16(_mm_and_si128(p, _mm_setr_epi32(top(0), top(1) << shift(1), top(2) << shift(2), 0)), _mm_srli_epi32(p, shift(3)), 0x0C0);
+      return _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(fields), _mm_setr_ps(rcp(0), rcp(1) / fl32(1u << shift(1)), rcp(2) / fl32(1u << shift(2)), rcp(3))), one4());
+   }
+
+#ifdef _FPDT_KERNELS_AVX2_
+   static inline _FPDT_TARGET_AVX2_ csi256 fieldsAVX2(cfl32x8 v) {
+      return _mm256_sllv_epi32(_mm256_and_si256(_mm256_cvttps_epi32(_mm256_mul_ps(v, _mm256_setr_m128(scale4(), scale4()))), _mm256_broadcastsi128_si256(mask4())), _mm256_broadcastsi128_si256(shift4()));
+   }
+
+   static inline _FPDT_TARGET_AVX2_ cfl32x8 floatsAVX2(csi256 p) {
+      csi256 fields = _mm256_and_si256(_mm256_srlv_epi32(p, _mm256_broadcastsi128_si256(shift4())), _mm256_broadcastsi128_si256(mask4()));
+      return _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(fields), _mm256_setr_m128(rcp4(), rcp4())), _mm256_setr_m128(one4(), one4()));
+   }
+#endif
+
+#ifdef _FPDT_KERNELS_AVX512_
+   static inline _FPDT_TARGET_AVX512_ csi512 fieldsAVX512(cfl32x16 v) {
+      return _mm512_sllv_epi32(_mm512_and_si512(_mm512_cvttps_epi32(_mm512_mul_ps(v, _mm512_broadcast_f32x4(scale4()))), _mm512_broadcast_i32x4(mask4())), _mm512_broadcast_i32x4(shift4()));
+   }
+
+   static inline _FPDT_TARGET_AVX512_ cfl32x16 floatsAVX512(csi512 p) {
+      csi512 fields = _mm512_and_si512(_mm512_srlv_epi32(p, _mm512_broadcast_i32x4(shift4())), _mm512_broadcast_i32x4(mask4()));
+      return _mm512_add_ps(_mm512_mul_ps(_mm512_cvtepi32_ps(fields), _mm512_broadcast_f32x4(rcp4())), _mm512_broadcast_f32x4(one4()));
+   }
+#endif
+};
+
+typedef _fpc_unorm<ui32, 8, 9, 7, 8> _fpc_8978;
+typedef _fpc_unorm<ui16, 5, 6, 5, 0> _fpc_565;
+typedef _fpc_unorm<ui32, 10, 10, 10, 2> _fpc_10a2;
+
+/***************************
+ *  Small unsigned floats  *
+ ***************************/
+
+// Unsigned float of a 5-bit exponent & mantissa bits: NaN stays NaN, +infinity stays infinity, finite values round to nearest even & clamp to the largest finite value, & negative values become 0
+static inline cui32 _fpc_packFloat(cfl32 value, cui32 mantissa) {
+   cui32 bits = (ui32 &)value, shift = 23 - mantissa;
+
+   if ((bits & 0x07FFFFFFF) > 0x07F800000) return (0x020 << mantissa) - 1;
+   if (bits >> 31) return 0;
+   if (bits == 0x07F800000) return 0x01F << mantissa;
+   if (bits < 0x038800000) { // Below 2^-14, denormal: adding a float whose step is the denormal step rounds to it
+      cui32 magicBits = (136 - mantissa) << 23;
+      cfl32 magic = (fl32 &)magicBits, sum = value + magic;
+
+      return (ui32 &)sum - magicBits;
+   }
+   cui32 rebased = bits - (112 << 23), code = (rebased + (1 << (shift - 1)) - 1 + ((rebased >> shift) & 1)) >> shift;
+   return code < (0x01F << mantissa) - 1 ? code : (0x01F << mantissa) - 1;
+}
+
+// Codes are shifted to the top of a float's mantissa, then rebiased; denormals add 2^-14 as a normal, & subtract it
+static inline cfl32 _fpc_unpackFloat(cui32 code, cui32 mantissa) {
+   cui32 bits = code << (23 - mantissa), exponent = bits & 0x0F800000;
+
+   if (!exponent) { cui32 temp = bits + (113 << 23); return (fl32 &)temp - 6.103515625e-05f; }
+   cui32 temp = bits + (exponent == 0x0F800000 ? 224 << 23 : 112 << 23);
+   return (fl32 &)temp;
+}
+
+// R11G11B10F: 6-bit mantissas in lanes 0 & 1, & a 5-bit mantissa in lane 2; lane 3 is encoded as lane 0, then discarded
+struct _fpc_111110 {
+   typedef ui32 packed;
+
+   static inline cui32 fix(cfl32 *c) { return _fpc_packFloat(c[0], 6) | (_fpc_packFloat(c[1], 6) << 11) | (_fpc_packFloat(c[2], 5) << 22); }
+
+   static inline void toFloat(fl32 *c, cui32 p) {
+      c[0] = _fpc_unpackFloat(p & 0x07FF, 6); c[1] = _fpc_unpackFloat((p >> 11) & 0x07FF, 6);
+      c[2] = _fpc_unpackFloat(p >> 22, 5); c[3] = 1.0f;
+   }
+
+   static inline cfl32x4 magic4(void) { return _mm_setr_ps(8.0f, 8.0f, 16.0f, 8.0f); }
+   static inline csi128 largest4(void) { return _mm_setr_epi32(0x07BF, 0x07BF, 0x03DF, 0x07BF); }
+   static inline csi128 infinity4(void) { return _mm_setr_epi32(0x07C0, 0x07C0, 0x03E0, 0x07C0); }
+   static inline csi128 nan4(void) { return _mm_setr_epi32(0x07FF, 0x07FF, 0x03FF, 0x07FF); }
+   static inline csi128 round4(void) { return _mm_setr_epi32(17, 17, 18, 17); }
+
+   // As _fpc_packFloat()
+   static inline csi128 codesSSE(cfl32x4 v) {
+      csi128 bits = _mm_castps_si128(v), rebased = _mm_sub_epi32(bits, _mm_set1_epi32(112 << 23));
+      csi128 code6 = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(rebased, _mm_set1_epi32(0x0FFFF)), _mm_and_si128(_mm_srli_epi32(rebased, 17), _mm_set1_epi32(1))), 17);
+      csi128 code5 = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(rebased, _mm_set1_epi32(0x01FFFF)), _mm_and_si128(_mm_srli_epi32(rebased, 18), _mm_set1_epi32(1))), 18);
+      csi128 denormal = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(v, magic4())), _mm_castps_si128(magic4()));
+      si128 code = _mm_min_epu32(_mm_blend_epi16(code6, code5, 0x030), largest4());
+
+      code = _mm_blendv_epi8(code, denormal, _mm_cmplt_epi32(bits, _mm_set1_epi32(0x038800000)));
+      code = _mm_blendv_epi8(code, infinity4(), _mm_cmpeq_epi32(bits, _mm_set1_epi32(0x07F800000)));
+      code = _mm_andnot_si128(_mm_srai_epi32(bits, 31), code);
+      return _mm_or_si128(code, _mm_and_si128(_mm_cmpgt_epi32(_mm_and_si128(bits, _mm_set1_epi32(0x07FFFFFFF)), _mm_set1_epi32(0x07F800000)), nan4()));
+   }
+
+   // As _fpc_unpackFloat(), from codes shifted to the top of each mantissa
+   static inline cfl32x4 valuesSSE(csi128 bits) {
+      csi128 exponent = _mm_and_si128(bits, _mm_set1_epi32(0x0F800000));
+      csi128 special = _mm_and_si128(_mm_cmpeq_epi32(exponent, _mm_set1_epi32(0x0F800000)), _mm_set1_epi32(112 << 23));
+      cfl32x4 normal = _mm_castsi128_ps(_mm_add_epi32(_mm_add_epi32(bits, _mm_set1_epi32(112 << 23)), special));
+      cfl32x4 denormal = _mm_sub_ps(_mm_castsi128_ps(_mm_add_epi32(bits, _mm_set1_epi32(113 << 23))), _mm_set1_ps(6.103515625e-05f));
+
+      return _mm_blendv_ps(normal, denormal, _mm_castsi128_ps(_mm_cmpeq_epi32(exponent, _mm_setzero_si128())));
+   }
+
+   static inline csi128 fieldsSSE(cfl32x4 v) { return _mm_mullo_epi32(codesSSE(v), _mm_setr_epi32(1, 1 << 11, 1 << 22, 0)); }
+
+   static inline cfl32x4 floatsSSE(csi128 p) {
+      csi128 bits = _mm_and_si128(_mm_blend_epi16(_mm_mullo_epi32(p, _mm_setr_epi32(1 << 17, 1 << 6, 0, 0)), _mm_srli_epi32(p, 4), 0x030), _mm_setr_epi32(0x0FFE0000, 0x0FFE0000, 0x0FFC0000, 0));
+      return _mm_blend_ps(valuesSSE(bits), _mm_set1_ps(1.0f), 0x08);
+   }
+
+#ifdef _FPDT_KERNELS_AVX2_
+   static inline _FPDT_TARGET_AVX2_ csi256 codesAVX2(cfl32x8 v) {
+      csi256 bits = _mm256_castps_si256(v), rebased = _mm256_sub_epi32(bits, _mm256_set1_epi32(112 << 23)), shift = _mm256_broadcastsi128_si256(round4());
+      csi256 bias = _mm256_sub_epi32(_mm256_sllv_epi32(_mm256_set1_epi32(1), _mm256_sub_epi32(shift, _mm256_set1_epi32(1))), _mm256_set1_epi32(1));
+      csi256 rounded = _mm256_srlv_epi32(_mm256_add_epi32(_mm256_add_epi32(rebased, bias), _mm256_and_si256(_mm256_srlv_epi32(rebased, shift), _mm256_set1_epi32(1))), shift);
+      cfl32x8 magic = _mm256_setr_m128(magic4(), magic4());
+      csi256 denormal = _mm256_sub_epi32(_mm256_castps_si256(_mm256_add_ps(v, magic)), _mm256_castps_si256(magic));
+      si256 code = _mm256_min_epu32(rounded, _mm256_broadcastsi128_si256(largest4()));
+
+      code = _mm256_blendv_epi8(code, denormal, _mm256_cmpgt_epi32(_mm256_set1_epi32(0x038800000), bits));
+      code = _mm256_blendv_epi8(code, _mm256_broadcastsi128_si256(infinity4()), _mm256_cmpeq_epi32(bits, _mm256_set1_epi32(0x07F800000)));
+      code = _mm256_andnot_si256(_mm256_srai_epi32(bits, 31), code);
+      return _mm256_or_si256(code, _mm256_and_si256(_mm256_cmpgt_epi32(_mm256_and_si256(bits, _mm256_set1_epi32(0x07FFFFFFF)), _mm256_set1_epi32(0x07F800000)), _mm256_broadcastsi128_si256(nan4())));
+   }
+
+   static inline _FPDT_TARGET_AVX2_ cfl32x8 valuesAVX2(csi256 bits) {
+      csi256 exponent = _mm256_and_si256(bits, _mm256_set1_epi32(0x0F800000));
+      csi256 special = _mm256_and_si256(_mm256_cmpeq_epi32(exponent, _mm256_set1_epi32(0x0F800000)), _mm256_set1_epi32(112 << 23));
+      cfl32x8 normal = _mm256_castsi256_ps(_mm256_add_epi32(_mm256_add_epi32(bits, _mm256_set1_epi32(112 << 23)), special));
+      cfl32x8 denormal = _mm256_sub_ps(_mm256_castsi256_ps(_mm256_add_epi32(bits, _mm256_set1_epi32(113 << 23))), _mm256_set1_ps(6.103515625e-05f));
+
+      return _mm256_blendv_ps(normal, denormal, _mm256_castsi256_ps(_mm256_cmpeq_epi32(exponent, _mm256_setzero_si256())));
+   }
+
+   static inline _FPDT_TARGET_AVX2_ csi256 fieldsAVX2(cfl32x8 v) { return _mm256_sllv_epi32(codesAVX2(v), _mm256_setr_epi32(0, 11, 22, 32, 0, 11, 22, 32)); }
+
+   static inline _FPDT_TARGET_AVX2_ cfl32x8 floatsAVX2(csi256 p) {
+      csi256 codes = _mm256_and_si256(_mm256_srlv_epi32(p, _mm256_setr_epi32(0, 11, 22, 32, 0, 11, 22, 32)), _mm256_setr_epi32(0x07FF, 0x07FF, 0x03FF, 0, 0x07FF, 0x07FF, 0x03FF, 0));
+      return _mm256_blend_ps(valuesAVX2(_mm256_sllv_epi32(codes, _mm256_broadcastsi128_si256(round4()))), _mm256_set1_ps(1.0f), 0x088);
+   }
+#endif
+
+#ifdef _FPDT_KERNELS_AVX512_
+   static inline _FPDT_TARGET_AVX512_ csi512 codesAVX512(cfl32x16 v) {
+      csi512 bits = _mm512_castps_si512(v), rebased = _mm512_sub_epi32(bits, _mm512_set1_epi32(112 << 23)), shift = _mm512_broadcast_i32x4(round4());
+      csi512 bias = _mm512_sub_epi32(_mm512_sllv_epi32(_mm512_set1_epi32(1), _mm512_sub_epi32(shift, _mm512_set1_epi32(1))), _mm512_set1_epi32(1));
+      csi512 rounded = _mm512_srlv_epi32(_mm512_add_epi32(_mm512_add_epi32(rebased, bias), _mm512_and_si512(_mm512_srlv_epi32(rebased, shift), _mm512_set1_epi32(1))), shift);
+      cfl32x16 magic = _mm512_broadcast_f32x4(magic4());
+      csi512 denormal = _mm512_sub_epi32(_mm512_castps_si512(_mm512_add_ps(v, magic)), _mm512_castps_si512(magic));
+      si512 code = _mm512_min_epu32(rounded, _mm512_broadcast_i32x4(largest4()));
+
+      code = _mm512_mask_mov_epi32(code, _mm512_cmplt_epi32_mask(bits, _mm512_set1_epi32(0x038800000)), denormal);
+      code = _mm512_mask_mov_epi32(code, _mm512_cmpeq_epi32_mask(bits, _mm512_set1_epi32(0x07F800000)), _mm512_broadcast_i32x4(infinity4()));
+      code = _mm512_maskz_mov_epi32(_mm512_cmpge_epi32_mask(bits, _mm512_setzero_si512()), code);
+      return _mm512_mask_mov_epi32(code, _mm512_cmpgt_epi32_mask(_mm512_and_si512(bits, _mm512_set1_epi32(0x07FFFFFFF)), _mm512_set1_epi32(0x07F800000)), _mm512_broadcast_i32x4(nan4()));
+   }
+
+   static inline _FPDT_TARGET_AVX512_ cfl32x16 valuesAVX512(csi512 bits) {
+      csi512 exponent = _mm512_and_si512(bits, _mm512_set1_epi32(0x0F800000));
+      csi512 normal = _mm512_add_epi32(bits, _mm512_set1_epi32(112 << 23));
+      csi512 value = _mm512_mask_add_epi32(normal, _mm512_cmpeq_epi32_mask(exponent, _mm512_set1_epi32(0x0F800000)), normal, _mm512_set1_epi32(112 << 23));
+      cfl32x16 denormal = _mm512_sub_ps(_mm512_castsi512_ps(_mm512_add_epi32(bits, _mm512_set1_epi32(113 << 23))), _mm512_set1_ps(6.103515625e-05f));
+
+      return _mm512_mask_mov_ps(_mm512_castsi512_ps(value), _mm512_cmpeq_epi32_mask(exponent, _mm512_setzero_si512()), denormal);
+   }
+
+   static inline _FPDT_TARGET_AVX512_ csi512 fieldsAVX512(cfl32x16 v) { return _mm512_sllv_epi32(codesAVX512(v), _mm512_broadcast_i32x4(_mm_setr_epi32(0, 11, 22, 32))); }
+
+   static inline _FPDT_TARGET_AVX512_ cfl32x16 floatsAVX512(csi512 p) {
+      csi512 codes = _mm512_and_si512(_mm512_srlv_epi32(p, _mm512_broadcast_i32x4(_mm_setr_epi32(0, 11, 22, 32))), _mm512_broadcast_i32x4(_mm_setr_epi32(0x07FF, 0x07FF, 0x03FF, 0)));
+      return _mm512_mask_mov_ps(valuesAVX512(_mm512_sllv_epi32(codes, _mm512_broadcast_i32x4(round4()))), 0x08888, _mm512_set1_ps(1.0f));
+   }
+#endif
+};
+
+/*************
+ *  Kernels  *
+ *************/
+
+// Stores & loads of merged 32-bit pixels, narrowed to or widened from 16-bit pixels when the format is 16-bit
+static inline void _fpc_store4(ui32 *dest, csi128 p) { _mm_storeu_si128((si128 *)dest, p); }
+static inline void _fpc_store4(ui16 *dest, csi128 p) { _mm_storel_epi64((si128 *)dest, _mm_packus_epi32(p, p)); }
+
+template<class F> static inline void _fpc_encodeSSE(typename F::packed *dest, cVEC4Df *src, csize_t count) {
+   size_t i = 0;
+
+   for (; i + 4 <= count; i += 4) {
+      csi128 p01 = _mm_hadd_epi32(F::fieldsSSE(_mm_loadu_ps(src[i]._fl32)), F::fieldsSSE(_mm_loadu_ps(src[i + 1]._fl32)));
+      csi128 p23 = _mm_hadd_epi32(F::fieldsSSE(_mm_loadu_ps(src[i + 2]._fl32)), F::fieldsSSE(_mm_loadu_ps(src[i + 3]._fl32)));
+
+      _fpc_store4(&dest[i], _mm_hadd_epi32(p01, p23));
+   }
+   for (; i < count; i++) dest[i] = typename F::packed(F::fix(src[i]._fl32));
+}
+
+template<class F> static inline void _fpc_decodeSSE(VEC4Df *dest, const typename F::packed *src, csize_t count) {
+   for (size_t i = 0; i < count; i++) _mm_storeu_ps(dest[i]._fl32, F::floatsSSE(_mm_set1_epi32(si32(src[i]))));
+}
+
+#ifdef _FPDT_KERNELS_AVX2_
+static inline _FPDT_TARGET_AVX2_ void _fpc_store8(ui32 *dest, csi256 p) { _mm256_storeu_si256((si256 *)dest, p); }
+static inline _FPDT_TARGET_AVX2_ void _fpc_store8(ui16 *dest, csi256 p) { _mm_storeu_si128((si128 *)dest, _mm256_castsi256_si128(_mm256_permute4x64_epi64(_mm256_packus_epi32(p, p), 0x08))); }
+static inline _FPDT_TARGET_AVX2_ csi256 _fpc_load8(cui32 *src) { return _mm256_loadu_si256((csi256 *)src); }
+static inline _FPDT_TARGET_AVX2_ csi256 _fpc_load8(cui16 *src) { return _mm256_cvtepu16_epi32(_mm_loadu_si128((csi128 *)src)); }
+
+// Two colours per register; the adds leave colours 0, 2, 4, 6 in the low lane & 1, 3, 5, 7 in the high lane
+template<class F> static inline _FPDT_TARGET_AVX2_ void _fpc_encodeAVX2(typename F::packed *dest, cVEC4Df *src, csize_t count) {
+   csi256 order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+   size_t i = 0;
+
+   for (; i + 8 <= count; i += 8) {
+      csi256 p01 = _mm256_hadd_epi32(F::fieldsAVX2(_mm256_loadu_ps(src[i]._fl32)), F::fieldsAVX2(_mm256_loadu_ps(src[i + 2]._fl32)));
+      csi256 p23 = _mm256_hadd_epi32(F::fieldsAVX2(_mm256_loadu_ps(src[i + 4]._fl32)), F::fieldsAVX2(_mm256_loadu_ps(src[i + 6]._fl32)));
+
+      _fpc_store8(&dest[i], _mm256_permutevar8x32_epi32(_mm256_hadd_epi32(p01, p23), order));
+   }
+   _fpc_encodeSSE<F>(&dest[i], &src[i], count - i);
+}
+
+template<class F> static inline _FPDT_TARGET_AVX2_ void _fpc_decodeAVX2(VEC4Df *dest, const typename F::packed *src, csize_t count) {
+   csi256 spread = _mm256_setr_epi32(0, 0, 0, 0, 1, 1, 1, 1);
+   size_t i = 0;
+
+   for (; i + 8 <= count; i += 8) {
+      csi256 packed = _fpc_load8(&src[i]);
+
+      for (ui32 pair = 0; pair < 4; pair++)
+         _mm256_storeu_ps(dest[i + pair * 2]._fl32, F::floatsAVX2(_mm256_permutevar8x32_epi32(packed, _mm256_add_epi32(spread, _mm256_set1_epi32(pair * 2)))));
+   }
+   _fpc_decodeSSE<F>(&dest[i], &src[i], count - i);
+}
+#endif
+
+#ifdef _FPDT_KERNELS_AVX512_
+static inline _FPDT_TARGET_AVX512_ void _fpc_store16(ui32 *dest, csi512 p) { _mm512_storeu_si512(dest, p); }
+static inline _FPDT_TARGET_AVX512_ void _fpc_store16(ui16 *dest, csi512 p) { _mm256_storeu_si256((si256 *)dest, _mm512_cvtepi32_epi16(p)); }
+static inline _FPDT_TARGET_AVX512_ csi512 _fpc_load16(cui32 *src) { return _mm512_loadu_si512(src); }
+static inline _FPDT_TARGET_AVX512_ csi512 _fpc_load16(cui16 *src) { return _mm512_cvtepu16_epi32(_mm256_loadu_si256((csi256 *)src)); }
+
+// Four colours per register; each merge ORs neighbouring channels of two registers, halving the channels per colour
+template<class F> static inline _FPDT_TARGET_AVX512_ void _fpc_encodeAVX512(typename F::packed *dest, cVEC4Df *src, csize_t count) {
+   csi512 even = _mm512_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30), odd = _mm512_add_epi32(even, _mm512_set1_epi32(1));
+   const auto fields = [](cVEC4Df *c) _FPDT_TARGET_AVX512_ { return F::fieldsAVX512(_mm512_loadu_ps(c->_fl32)); };
+   const auto merge = [&](csi512 a, csi512 b) _FPDT_TARGET_AVX512_ { return _mm512_or_si512(_mm512_permutex2var_epi32(a, even, b), _mm512_permutex2var_epi32(a, odd, b)); };
+   size_t i = 0;
+
+   for (; i + 16 <= count; i += 16)
+      _fpc_store16(&dest[i], merge(merge(fields(&src[i]), fields(&src[i + 4])), merge(fields(&src[i + 8]), fields(&src[i + 12]))));
+   _fpc_encodeSSE<F>(&dest[i], &src[i], count - i);
+}
+
+template<class F> static inline _FPDT_TARGET_AVX512_ void _fpc_decodeAVX512(VEC4Df *dest, const typename F::packed *src, csize_t count) {
+   csi512 spread = _mm512_setr_epi32(0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3);
+   size_t i = 0;
+
+   for (; i + 16 <= count; i += 16) {
+      csi512 packed = _fpc_load16(&src[i]);
+
+      for (ui32 quad = 0; quad < 4; quad++)
+         _mm512_storeu_ps(dest[i + quad * 4]._fl32, F::floatsAVX512(_mm512_permutexvar_epi32(_mm512_add_epi32(spread, _mm512_set1_epi32(quad * 4)), packed)));
+   }
+   _fpc_decodeSSE<F>(&dest[i], &src[i], count - i);
+}
+#endif
+
+/*
+ *  Kernel tables, indexed by fpdtISA()
+ */
+
+static decltype(&_fpc_encodeSSE<_fpc_8978>) const _fpc_encode8978ISA[] = _FPDT_KERNELS_T_(_fpc_encode, _fpc_8978);
+static decltype(&_fpc_decodeSSE<_fpc_8978>) const _fpc_decode8978ISA[] = _FPDT_KERNELS_T_(_fpc_decode, _fpc_8978);
+static decltype(&_fpc_encodeSSE<_fpc_565>) const _fpc_encode565ISA[] = _FPDT_KERNELS_T_(_fpc_encode, _fpc_565);
+static decltype(&_fpc_decodeSSE<_fpc_565>) const _fpc_decode565ISA[] = _FPDT_KERNELS_T_(_fpc_decode, _fpc_565);
+static decltype(&_fpc_encodeSSE<_fpc_10a2>) const _fpc_encode10a2ISA[] = _FPDT_KERNELS_T_(_fpc_encode, _fpc_10a2);
+static decltype(&_fpc_decodeSSE<_fpc_10a2>) const _fpc_decode10a2ISA[] = _FPDT_KERNELS_T_(_fpc_decode, _fpc_10a2);
+static decltype(&_fpc_encodeSSE<_fpc_111110>) const _fpc_encode111110ISA[] = _FPDT_KERNELS_T_(_fpc_encode, _fpc_111110);
+static decltype(&_fpc_decodeSSE<_fpc_111110>) const _fpc_decode111110ISA[] = _FPDT_KERNELS_T_(_fpc_decode, _fpc_111110);
+
+/****************
+ *  Data types  *
+ ****************/
+
+// 16-bit, R5G6B5 : Decimal range of 0.0~1.0 per channel, without alpha
+struct rgb565 {
+   typedef const rgb565 crgb565;
+
+   ui16 data;
+
+   inline cui16 toFixed(cVEC4Df &value) const { return ui16(_fpc_565::fix(value._fl32)); }
+   inline cVEC4Df toFloat(void) const { VEC4Df temp; _fpc_565::toFloat(temp._fl32, data); return temp; }
+
+   rgb565(void) = default;
+   rgb565(cui16 value) { data = value; }
+   rgb565(cfl32 r, cfl32 g, cfl32 b) { cVEC4Df temp = { r, g, b, 1.0f }; data = toFixed(temp); }
+   rgb565(cVEC4Df value) { data = toFixed(value); }
+   rgb565(cSSE4Df32 value) { data = toFixed(value.vector); }
+
+   operator cVEC4Df(void) const { return toFloat(); }
+};
+
+// 32-bit, R10G10B10A2 : Decimal range of 0.0~1.0 per channel
+struct rgb10a2 {
+   typedef const rgb10a2 crgb10a2;
+
+   ui32 data;
+
+   inline cui32 toFixed(cVEC4Df &value) const { return _fpc_10a2::fix(value._fl32); }
+   inline cVEC4Df toFloat(void) const { VEC4Df temp; _fpc_10a2::toFloat(temp._fl32, data); return temp; }
+
+   rgb10a2(void) = default;
+   rgb10a2(cui32 value) { data = value; }
+   rgb10a2(cfl32 r, cfl32 g, cfl32 b, cfl32 a) { cVEC4Df temp = { r, g, b, a }; data = toFixed(temp); }
+   rgb10a2(cVEC4Df value) { data = toFixed(value); }
+   rgb10a2(cSSE4Df32 value) { data = toFixed(value.vector); }
+
+   operator cVEC4Df(void) const { return toFloat(); }
+};
+
+// 32-bit, unsigned floats R11G11B10 : Decimal range of 0.0~65024.0 for red & green, & 0.0~64512.0 for blue, without alpha
+struct r11g11b10f {
+   typedef const r11g11b10f cr11g11b10f;
+
+   ui32 data;
+
+   inline cui32 toFixed(cVEC4Df &value) const { return _fpc_111110::fix(value._fl32); }
+   inline cVEC4Df toFloat(void) const { VEC4Df temp; _fpc_111110::toFloat(temp._fl32, data); return temp; }
+
+   r11g11b10f(void) = default;
+   r11g11b10f(cui32 value) { data = value; }
+   r11g11b10f(cfl32 r, cfl32 g, cfl32 b) { cVEC4Df temp = { r, g, b, 1.0f }; data = toFixed(temp); }
+   r11g11b10f(cVEC4Df value) { data = toFixed(value); }
+   r11g11b10f(cSSE4Df32 value) { data = toFixed(value.vector); }
+
+   operator cVEC4Df(void) const { return toFloat(); }
+};
+
+typedef const rgb565     crgb565;
+typedef const rgb10a2    crgb10a2;
+typedef const r11g11b10f cr11g11b10f;
+
+/********************
+ *  Bulk functions  *
+ ********************/
+
+// Convert count colours of 4 32-bit floats (range 0.0~1.0) to packed fixed-point colour values: R8G9B7A8
+inline void Fix8978(ui32 *dest, cVEC4Df *src, csize_t count) { _fpc_encode8978ISA[fpdtISA()](dest, src, count); }
+inline void Fix8978(ui32 *dest, cSSE4Df32 *src, csize_t count) { _fpc_encode8978ISA[fpdtISA()](dest, (cVEC4Df *)src, count); }
+
+// Convert count packed fixed-point colour values (R8G9B7A8) to colours of 4 32-bit floats (range 0.0~1.0)
+inline void Float8978(VEC4Df *dest, cui32 *src, csize_t count) { _fpc_decode8978ISA[fpdtISA()](dest, src, count); }
+inline void Float8978(SSE4Df32 *dest, cui32 *src, csize_t count) { _fpc_decode8978ISA[fpdtISA()]((VEC4Df *)dest, src, count); }
+
+// Convert count colours of 4 32-bit floats to packed colours; alpha is discarded by rgb565 & r11g11b10f
+inline void fpdtToFixed(rgb565 *dest, cVEC4Df *src, csize_t count) { _fpc_encode565ISA[fpdtISA()]((ui16 *)dest, src, count); }
+inline void fpdtToFixed(rgb565 *dest, cSSE4Df32 *src, csize_t count) { _fpc_encode565ISA[fpdtISA()]((ui16 *)dest, (cVEC4Df *)src, count); }
+inline void fpdtToFixed(rgb10a2 *dest, cVEC4Df *src, csize_t count) { _fpc_encode10a2ISA[fpdtISA()]((ui32 *)dest, src, count); }
+inline void fpdtToFixed(rgb10a2 *dest, cSSE4Df32 *src, csize_t count) { _fpc_encode10a2ISA[fpdtISA()]((ui32 *)dest, (cVEC4Df *)src, count); }
+inline void fpdtToFixed(r11g11b10f *dest, cVEC4Df *src, csize_t count) { _fpc_encode111110ISA[fpdtISA()]((ui32 *)dest, src, count); }
+inline void fpdtToFixed(r11g11b10f *dest, cSSE4Df32 *src, csize_t count) { _fpc_encode111110ISA[fpdtISA()]((ui32 *)dest, (cVEC4Df *)src, count); }
+
+// Convert count packed colours to colours of 4 32-bit floats; alpha is 1.0 for rgb565 & r11g11b10f
+inline void fpdtToFloat(VEC4Df *dest, crgb565 *src, csize_t count) { _fpc_decode565ISA[fpdtISA()](dest, (cui16 *)src, count); }
+inline void fpdtToFloat(SSE4Df32 *dest, crgb565 *src, csize_t count) { _fpc_decode565ISA[fpdtISA()]((VEC4Df *)dest, (cui16 *)src, count); }
+inline void fpdtToFloat(VEC4Df *dest, crgb10a2 *src, csize_t count) { _fpc_decode10a2ISA[fpdtISA()](dest, (cui32 *)src, count); }
+inline void fpdtToFloat(SSE4Df32 *dest, crgb10a2 *src, csize_t count) { _fpc_decode10a2ISA[fpdtISA()]((VEC4Df *)dest, (cui32 *)src, count); }
+inline void fpdtToFloat(VEC4Df *dest, cr11g11b10f *src, csize_t count) { _fpc_decode111110ISA[fpdtISA()](dest, (cui32 *)src, count); }
+inline void fpdtToFloat(SSE4Df32 *dest, cr11g11b10f *src, csize_t count) { _fpc_decode111110ISA[fpdtISA()]((VEC4Df *)dest, (cui32 *)src, count); }
+
+/**********
+ *  sRGB  *
+ **********/
+
+// Linear value of each sRGB code, & the smallest linear value that encodes to each code, from the exact curves in double precision
+struct _fpc_srgbTables {
+   al64 fl32 linear[256];
+   al64 fl32 threshold[256];
+
+   static inline cfl64 encode(cfl64 x) { return x <= 0.0031308 ? x * 12.92 : 1.055 * std::pow(x, 1.0 / 2.4) - 0.055; }
+   static inline cfl64 decode(cfl64 s) { return s <= 0.04045 ? s / 12.92 : std::pow((s + 0.055) / 1.055, 2.4); }
+   static inline cui32 code(cfl32 x) { return ui32(encode(x) * 255.0 + 0.5); }
+
+   _fpc_srgbTables(void) {
+      for (ui32 i = 0; i < 256; i++) linear[i] = fl32(decode(i / 255.0));
+
+      // Binary search of the bit patterns of 0.0~1.0, which order as their values
+      threshold[0] = 0.0f;
+      for (ui32 i = 1; i < 256; i++) {
+         ui32 low = 0, high = 0x03F800000;
+         while (low < high) {
+            cui32 mid = (low + high) >> 1;
+            if (code((fl32 &)mid) >= i) high = mid; else low = mid + 1;
+         }
+         threshold[i] = (fl32 &)low;
+      }
+   }
+};
+
+// Built on first use, once per program
+inline const _fpc_srgbTables &_fpc_srgb(void) { static const _fpc_srgbTables tables; return tables; }
+
+// Encodes approximate the curve with a rational function of sqrt(x), to within 0.05 of a code, truncate, then add 1 if x reaches the next code's threshold, so codes are exactly rounded
+#define _FPC_SRGB_P0_ -0.043643548f
+#define _FPC_SRGB_P1_  1.438089476f
+#define _FPC_SRGB_P2_  4.489830547f
+#define _FPC_SRGB_Q1_  4.506533951f
+#define _FPC_SRGB_Q2_  0.378746569f
+
+static inline cui8 _fpc_srgb8(cfl32 value, cfl32 *threshold) {
+   cfl32 x = value > 0.0f ? (value < 1.0f ? value : 1.0f) : 0.0f, t = std::sqrt(x);
+   cfl32 s = x <= 0.0031308f ? x * 12.92f : (_FPC_SRGB_P0_ + t * (_FPC_SRGB_P1_ + t * _FPC_SRGB_P2_)) / (1.0f + t * (_FPC_SRGB_Q1_ + t * _FPC_SRGB_Q2_));
+   ui32 code = ui32(s > 0.0f ? s * 255.0f : 0.0f);
+
+   if (code > 254) code = 254;
+   return ui8(code + (x >= threshold[code + 1]));
+}
+
+// Alpha saturates to 0~255, as the packs of the kernels
+static inline cui8 _fpc_alpha8(cfl32 value) {
+   csi32 code = _mm_cvttss_si32(_mm_set_ss(value * 255.0f));
+   return ui8(code < 0 ? 0 : code > 255 ? 255 : code);
+}
+
+static inline cfl32x4 _fpc_gatherSSE(cfl32 *table, csi128 index) {
+   return _mm_setr_ps(table[_mm_cvtsi128_si32(index)], table[_mm_extract_epi32(index, 1)], table[_mm_extract_epi32(index, 2)], table[_mm_extract_epi32(index, 3)]);
+}
+
+static inline csi128 _fpc_srgbCodesSSE(cfl32x4 value, cfl32 *threshold) {
+   cfl32x4 x = _mm_min_ps(_mm_max_ps(value, _mm_setzero_ps()), _mm_set1_ps(1.0f)), t = _mm_sqrt_ps(x);
+   cfl32x4 p = _mm_add_ps(_mm_set1_ps(_FPC_SRGB_P0_), _mm_mul_ps(t, _mm_add_ps(_mm_set1_ps(_FPC_SRGB_P1_), _mm_mul_ps(t, _mm_set1_ps(_FPC_SRGB_P2_)))));
+   cfl32x4 q = _mm_add_ps(_mm_set1_ps(1.0f), _mm_mul_ps(t, _mm_add_ps(_mm_set1_ps(_FPC_SRGB_Q1_), _mm_mul_ps(t, _mm_set1_ps(_FPC_SRGB_Q2_)))));
+   cfl32x4 s = _mm_blendv_ps(_mm_div_ps(p, q), _mm_mul_ps(x, _mm_set1_ps(12.92f)), _mm_cmple_ps(x, _mm_set1_ps(0.0031308f)));
+   csi128 code = _mm_min_epi32(_mm_cvttps_epi32(_mm_mul_ps(s, _mm_set1_ps(255.0f))), _mm_set1_epi32(254));
+
+   return _mm_sub_epi32(code, _mm_castps_si128(_mm_cmpge_ps(x, _fpc_gatherSSE(threshold, _mm_add_epi32(code, _mm_set1_epi32(1))))));
+}
+
+// With alpha, every 4th value is alpha, which is linear & truncated, as fp8n0_1, then saturated
+template<cbool alpha> static inline void _fpc_encodeSRGBSSE(ui8 *dest, cfl32 *src, csize_t count) {
+   cfl32 *threshold = _fpc_srgb().threshold;
+   size_t i = 0;
+
+   for (; i + 4 <= count; i += 4) {
+      cfl32x4 value = _mm_loadu_ps(&src[i]);
+      si128 code = _fpc_srgbCodesSSE(value, threshold);
+
+      if constexpr (alpha) code = _mm_blend_epi16(code, _mm_cvttps_epi32(_mm_mul_ps(value, _mm_set1_ps(255.0f))), 0x0C0);
+      code = _mm_packus_epi16(_mm_packus_epi32(code, code), code);
+      *(ui32 *)&dest[i] = ui32(_mm_cvtsi128_si32(code));
+   }
+   for (; i < count; i++) dest[i] = alpha && (i & 3) == 3 ? _fpc_alpha8(src[i]) : _fpc_srgb8(src[i], threshold);
+}
+
+template<cbool alpha> static inline void _fpc_decodeSRGBSSE(fl32 *dest, cui8 *src, csize_t count) {
+   cfl32 *linear = _fpc_srgb().linear;
+
+   for (size_t i = 0; i < count; i++) dest[i] = alpha && (i & 3) == 3 ? fl32(src[i]) * (1.0f / 255.0f) : linear[src[i]];
+}
+
+#ifdef _FPDT_KERNELS_AVX2_
+static inline _FPDT_TARGET_AVX2_ csi256 _fpc_srgbCodesAVX2(cfl32x8 value, cfl32 *threshold) {
+   cfl32x8 x = _mm256_min_ps(_mm256_max_ps(value, _mm256_setzero_ps()), _mm256_set1_ps(1.0f)), t = _mm256_sqrt_ps(x);
+   cfl32x8 p = _mm256_fmadd_ps(t, _mm256_fmadd_ps(t, _mm256_set1_ps(_FPC_SRGB_P2_), _mm256_set1_ps(_FPC_SRGB_P1_)), _mm256_set1_ps(_FPC_SRGB_P0_));
+   cfl32x8 q = _mm256_fmadd_ps(t, _mm256_fmadd_ps(t, _mm256_set1_ps(_FPC_SRGB_Q2_), _mm256_set1_ps(_FPC_SRGB_Q1_)), _mm256_set1_ps(1.0f));
+   cfl32x8 s = _mm256_blendv_ps(_mm256_div_ps(p, q), _mm256_mul_ps(x, _mm256_set1_ps(12.92f)), _mm256_cmp_ps(x, _mm256_set1_ps(0.0031308f), _CMP_LE_OQ));
+   csi256 code = _mm256_min_epi32(_mm256_cvttps_epi32(_mm256_mul_ps(s, _mm256_set1_ps(255.0f))), _mm256_set1_epi32(254));
+   cfl32x8 next = _mm256_i32gather_ps(threshold, _mm256_add_epi32(code, _mm256_set1_epi32(1)), 4);
+
+   return _mm256_sub_epi32(code, _mm256_castps_si256(_mm256_cmp_ps(x, next, _CMP_GE_OQ)));
+}
+
+template<cbool alpha> static inline _FPDT_TARGET_AVX2_ void _fpc_encodeSRGBAVX2(ui8 *dest, cfl32 *src, csize_t count) {
+   cfl32 *threshold = _fpc_srgb().threshold;
+   size_t i = 0;
+
+   for (; i + 8 <= count; i += 8) {
+      cfl32x8 value = _mm256_loadu_ps(&src[i]);
+      si256 code = _fpc_srgbCodesAVX2(value, threshold);
+
+      if constexpr (alpha) code = _mm256_blend_epi32(code, _mm256_cvttps_epi32(_mm256_mul_ps(value, _mm256_set1_ps(255.0f))), 0x088);
+      csi128 words = _mm_packus_epi32(_mm256_castsi256_si128(code), _mm256_extracti128_si256(code, 1));
+      _mm_storel_epi64((si128 *)&dest[i], _mm_packus_epi16(words, words));
+   }
+   _fpc_encodeSRGBSSE<alpha>(&dest[i], &src[i], count - i);
+}
+
+template<cbool alpha> static inline _FPDT_TARGET_AVX2_ void _fpc_decodeSRGBAVX2(fl32 *dest, cui8 *src, csize_t count) {
+   cfl32 *linear = _fpc_srgb().linear;
+   size_t i = 0;
+
+   for (; i + 8 <= count; i += 8) {
+      csi256 code = _mm256_cvtepu8_epi32(_mm_loadl_epi64((csi128 *)&src[i]));
+      fl32x8 value = _mm256_i32gather_ps(linear, code, 4);
+
+      if constexpr (alpha) value = _mm256_blend_ps(value, _mm256_mul_ps(_mm256_cvtepi32_ps(code), _mm256_set1_ps(1.0f / 255.0f)), 0x088);
+      _mm256_storeu_ps(&dest[i], value);
+   }
+   _fpc_decodeSRGBSSE<alpha>(&dest[i], &src[i], count - i);
+}
+#endif
+
+#ifdef _FPDT_KERNELS_AVX512_
+static inline _FPDT_TARGET_AVX512_ csi512 _fpc_srgbCodesAVX512(cfl32x16 value, cfl32 *threshold) {
+   cfl32x16 x = _mm512_min_ps(_mm512_max_ps(value, _mm512_setzero_ps()), _mm512_set1_ps(1.0f)), t = _mm512_sqrt_ps(x);
+   cfl32x16 p = _mm512_fmadd_ps(t, _mm512_fmadd_ps(t, _mm512_set1_ps(_FPC_SRGB_P2_), _mm512_set1_ps(_FPC_SRGB_P1_)), _mm512_set1_ps(_FPC_SRGB_P0_));
+   cfl32x16 q = _mm512_fmadd_ps(t, _mm512_fmadd_ps(t, _mm512_set1_ps(_FPC_SRGB_Q2_), _mm512_set1_ps(_FPC_SRGB_Q1_)), _mm512_set1_ps(1.0f));
+   cfl32x16 s = _mm512_mask_mul_ps(_mm512_div_ps(p, q), _mm512_cmp_ps_mask(x, _mm512_set1_ps(0.0031308f), _CMP_LE_OQ), x, _mm512_set1_ps(12.92f));
+   csi512 code = _mm512_min_epi32(_mm512_cvttps_epi32(_mm512_mul_ps(s, _mm512_set1_ps(255.0f))), _mm512_set1_epi32(254));
+   cfl32x16 next = _mm512_i32gather_ps(_mm512_add_epi32(code, _mm512_set1_epi32(1)), threshold, 4);
+
+   return _mm512_mask_add_epi32(code, _mm512_cmp_ps_mask(x, next, _CMP_GE_OQ), code, _mm512_set1_epi32(1));
+}
+
+template<cbool alpha> static inline _FPDT_TARGET_AVX512_ void _fpc_encodeSRGBAVX512(ui8 *dest, cfl32 *src, csize_t count) {
+   cfl32 *threshold = _fpc_srgb().threshold;
+   size_t i = 0;
+
+   for (; i + 16 <= count; i += 16) {
+      cfl32x16 value = _mm512_loadu_ps(&src[i]);
+      si512 code = _fpc_srgbCodesAVX512(value, threshold);
+
+      if constexpr (alpha) code = _mm512_max_epi32(_mm512_mask_cvttps_epi32(code, 0x08888, _mm512_mul_ps(value, _mm512_set1_ps(255.0f))), _mm512_setzero_si512());
+      _mm_storeu_si128((si128 *)&dest[i], _mm512_cvtusepi32_epi8(code));
+   }
+   _fpc_encodeSRGBSSE<alpha>(&dest[i], &src[i], count - i);
+}
+
+template<cbool alpha> static inline _FPDT_TARGET_AVX512_ void _fpc_decodeSRGBAVX512(fl32 *dest, cui8 *src, csize_t count) {
+   cfl32 *linear = _fpc_srgb().linear;
+   size_t i = 0;
+
+   for (; i + 16 <= count; i += 16) {
+      csi512 code = _mm512_cvtepu8_epi32(_mm_loadu_si128((csi128 *)&src[i]));
+      fl32x16 value = _mm512_i32gather_ps(code, linear, 4);
+
+      if constexpr (alpha) value = _mm512_mask_mul_ps(value, 0x08888, _mm512_cvtepi32_ps(code), _mm512_set1_ps(1.0f / 255.0f));
+      _mm512_storeu_ps(&dest[i], value);
+   }
+   _fpc_decodeSRGBSSE<alpha>(&dest[i], &src[i], count - i);
+}
+#endif
+
+static decltype(&_fpc_encodeSRGBSSE<false>) const _fpc_encodeSRGBISA[][3] = { _FPDT_KERNELS_T_(_fpc_encodeSRGB, false), _FPDT_KERNELS_T_(_fpc_encodeSRGB, true) };
+static decltype(&_fpc_decodeSRGBSSE<false>) const _fpc_decodeSRGBISA[][3] = { _FPDT_KERNELS_T_(_fpc_decodeSRGB, false), _FPDT_KERNELS_T_(_fpc_decodeSRGB, true) };
+
+// Convert count linear 32-bit floats to 8-bit sRGB codes, rounded to nearest; values outside 0.0~1.0 are clamped
+inline void fpdtToFixedSRGB(fp8n0_1 *dest, cfl32 *src, csize_t count) { _fpc_encodeSRGBISA[0][fpdtISA()]((ui8 *)dest, src, count); }
+
+// Convert count 8-bit sRGB codes to linear 32-bit floats
+inline void fpdtToFloatSRGB(fl32 *dest, cfp8n0_1 *src, csize_t count) { _fpc_decodeSRGBISA[0][fpdtISA()](dest, (cui8 *)src, count); }
+
+// Convert count linear colours of 4 32-bit floats to sRGB pixels; alpha stays linear, & truncates as fp8n0_1
+inline void fpdtToFixedSRGB(fp8n0_1x4 *dest, cVEC4Df *src, csize_t count) { _fpc_encodeSRGBISA[1][fpdtISA()]((ui8 *)dest, (cfl32 *)src, count * 4); }
+inline void fpdtToFixedSRGB(fp8n0_1x4 *dest, cSSE4Df32 *src, csize_t count) { _fpc_encodeSRGBISA[1][fpdtISA()]((ui8 *)dest, (cfl32 *)src, count * 4); }
+
+// Convert count sRGB pixels to linear colours of 4 32-bit floats; alpha is linear
+inline void fpdtToFloatSRGB(VEC4Df *dest, cfp8n0_1x4 *src, csize_t count) { _fpc_decodeSRGBISA[1][fpdtISA()]((fl32 *)dest, (cui8 *)src, count * 4); }
+inline void fpdtToFloatSRGB(SSE4Df32 *dest, cfp8n0_1x4 *src, csize_t count) { _fpc_decodeSRGBISA[1][fpdtISA()]((fl32 *)dest, (cui8 *)src, count * 4); }
@@ -1,6 +1,6 @@
 /**********************************************************************
  * File: Fixed-point data types.h                 Created: 2024/05/11 *
- *                                          Last modified: 2024/06/25 *
+ *                                          Last modified: 2024/07/26 *
  *                                                                    *
  * Desc: Provides sizes of 8, 16, 24, and 32 bits. All sizes have     *
  *       support for fixed, normalised, and custom value ranges.      *
@@ -13,7 +13,13 @@
  *        user-definable ranges.                                      *
  *        If using those data types, add fpdtInitCustom; to the       *
  *        global space of one of your project's .c/.cpp source files. *
- *        SSE3 support required. AVX2 and AVX512 support optional.    *
+ *        Define FPDT_THREAD_LOCAL_RANGES to give each thread its own *
+ *        range context, so threads may quantise with different       *
+ *        ranges without racing; each thread starts with the default  *
+ *        ranges. Range reads then look up the thread's context       *
+ *        through thread-local storage before loading the range.      *
+ *        fpdtRangeScope switches to an explicit fpdtRange.           *
+ *        SSE4.1 support required. AVX2 and AVX512 support optional.  *
  *                                                                    *
  * MIT license.                     Copyright (c) David William Bull. *
  **********************************************************************/
@@ -22,8 +28,16 @@
 #include <immintrin.h>
 #include "typedefs.h"
 
+// One range context per thread, or one shared by all threads
+#ifdef FPDT_THREAD_LOCAL_RANGES
+#define _FPDT_DATA_STORAGE_ thread_local
+#else
+#define _FPDT_DATA_STORAGE_
+#endif
+
 // External _FPDT_DATA_ to be declared in a main .c/.cpp file, required for data types with a user-definable range
-#define fpdtInitCustom __declspec(align(16)) __FPDT_DATA__ __fpdt_data__
+// Aligned to a cache line, so that range reads never share one with unrelated writes
+#define fpdtInitCustom _FPDT_DATA_STORAGE_ __declspec(align(64)) __FPDT_DATA__ __fpdt_data__
 
 // For 2-scalar return values
 typedef
@@ -163,6 +177,29 @@ static cfl64 _fpdt_rcp2p32_1  = 1.0 / 4294967295.0;
 static cfl64 _fpdt_rcp2p32    = 1.0 / 4294967296.0;
 static cfl64 _fpdt_2div2p32_1 = 2.0 / 4294967295.0;
 
+/*
+ *  Integer-domain multiply & divide, rounded to nearest
+ */
+
+// Unsigned fixed-point of up to 16 bits: (a * b) >> frac
+static inline cui32 _fpdt_mulU16(cui32 a, cui32 b, cui32 frac) { return (a * b + (1u << frac >> 1)) >> frac; }
+// Unsigned fixed-point of up to 16 bits: (a << frac) / b; division by zero returns max
+static inline cui32 _fpdt_divU16(cui32 a, cui32 b, cui32 frac, cui32 max) { return b ? ((a << frac) + (b >> 1)) / b : max; }
+// Unsigned fixed-point of up to 32 bits: (a * b) >> frac
+static inline cui32 _fpdt_mulU32(cui64 a, cui64 b, cui32 frac) { return ui32((a * b + (1ull << frac >> 1)) >> frac); }
+// Unsigned fixed-point of up to 32 bits: (a << frac) / b; division by zero returns max
+static inline cui32 _fpdt_divU32(cui64 a, cui64 b, cui32 frac, cui32 max) { return b ? ui32(((a << frac) + (b >> 1)) / b) : max; }
+// Excess-32768 (signed) 16-bit fixed-point: (a * b) >> frac
+static inline cui16 _fpdt_mulS16(cui16 a, cui16 b, cui32 frac) { return ui16(((si32(si16(a ^ 0x08000)) * si16(b ^ 0x08000) + (1 << frac >> 1)) >> frac) ^ 0x08000); }
+// Excess-32768 (signed) 16-bit fixed-point: (a << frac) / b, rounded away from zero on ties; division by zero returns the extreme of a's sign
+static inline cui16 _fpdt_divS16(cui16 a, cui16 b, cui32 frac) {
+   csi32 num = si32(si16(a ^ 0x08000)) * (1 << frac), den = si16(b ^ 0x08000);
+   csi32 half = (den < 0 ? -den : den) >> 1;
+
+   if (!den) return num < 0 ? 0 : 0x0FFFF;
+   return ui16(((num + (num < 0 ? -half : half)) / den) ^ 0x08000);
+}
+
 #ifndef FPDT_NO_CUSTOM
 
 // Data for types with a user-defineable range
@@ -185,9 +222,31 @@ struct __FPDT_DATA__ {
    fl32 range8        = 1.0f;
    fl32 maxDivRange8  = 255.0f;
    fl32 rangeDivMax8  = _fpdt_rcp255f;
+
+   // Set the range of one size to floor~ceiling
+   inline void setRange32(cfl64 floor, cfl64 ceiling) { origin32 = floor; range32 = ceiling - floor; maxDivRange32 = 4294967296.0 / range32; rangeDivMax32 = range32 / 4294967296.0; }
+#ifdef _24BIT_INTEGERS_
+   inline void setRange24(cfl32 floor, cfl32 ceiling) { origin24 = floor; range24 = ceiling - floor; maxDivRange24 = 16777215.0f / range24; rangeDivMax24 = range24 / 16777215.0f; }
+#endif
+   inline void setRange16(cfl32 floor, cfl32 ceiling) { origin16 = floor; range16 = ceiling - floor; maxDivRange16 = 65535.0f / range16; rangeDivMax16 = range16 / 65535.0f; }
+   inline void setRange8(cfl32 floor, cfl32 ceiling) { origin8 = floor; range8 = ceiling - floor; maxDivRange8 = 255.0f / range8; rangeDivMax8 = range8 / 255.0f; }
 };
 
-extern __FPDT_DATA__ __fpdt_data__;
+// An explicit range context, e.g. one per data stream
+typedef __FPDT_DATA__ fpdtRange;
+
+extern _FPDT_DATA_STORAGE_ __FPDT_DATA__ __fpdt_data__;
+
+// Makes a range context current until the end of the enclosing scope, then restores the previous one
+struct fpdtRangeScope {
+   const fpdtRange previous;
+
+   fpdtRangeScope(const fpdtRange &range) : previous(__fpdt_data__) { __fpdt_data__ = range; }
+   ~fpdtRangeScope(void) { __fpdt_data__ = previous; }
+
+   fpdtRangeScope(const fpdtRangeScope &) = delete;
+   fpdtRangeScope &operator=(const fpdtRangeScope &) = delete;
+};
 
 // Normalised 8-bit : User-defineable decimal range
 struct fp8n {
@@ -202,17 +261,9 @@ struct fp8n {
    inline cui8 toFixedMod(cfl32 &value) const { return ui8(value * __fpdt_data__.maxDivRange8); }
 
    fp8n(void) = default;
-   fp8n(cfl32 floor, cfl32 ceiling) {
-      __fpdt_data__.origin8      = floor;
-      __fpdt_data__.range8       = ceiling - floor;
-      __fpdt_data__.maxDivRange8 = 255.0f / __fpdt_data__.range8;
-      __fpdt_data__.rangeDivMax8 = __fpdt_data__.range8 / 255.0f;
-   };
+   fp8n(cfl32 floor, cfl32 ceiling) { __fpdt_data__.setRange8(floor, ceiling); }
    fp8n(cfl32 value, cfl32 floor, cfl32 ceiling) {
-      __fpdt_data__.origin8      = floor;
-      __fpdt_data__.range8       = ceiling - floor;
-      __fpdt_data__.maxDivRange8 = 255.0f / __fpdt_data__.range8;
-      __fpdt_data__.rangeDivMax8 = __fpdt_data__.range8 / 255.0f;
+      __fpdt_data__.setRange8(floor, ceiling);
 
       data = ui8((value - floor) * __fpdt_data__.maxDivRange8);
    };
@@ -317,12 +368,7 @@ struct fp8nx4 {
    }
 
    fp8nx4(void) = default;
-   fp8nx4(cfl32 floor, cfl32 ceiling) {
-      __fpdt_data__.origin8      = floor;
-      __fpdt_data__.range8       = ceiling - floor;
-      __fpdt_data__.maxDivRange8 = 255.0f / __fpdt_data__.range8;
-      __fpdt_data__.rangeDivMax8 = __fpdt_data__.range8 / 255.0f;
-   };
+   fp8nx4(cfl32 floor, cfl32 ceiling) { __fpdt_data__.setRange8(floor, ceiling); }
    fp8nx4(cfp8n value, cui8 index) { data[index] = value.data; }
    fp8nx4(cui8 value, cui8 index) { data8[index] = value; }
    fp8nx4(csi32 value, cui8 index) { data8[index] = (ui8 &)value; }
@@ -343,17 +389,11 @@ struct fp8nx4 {
    fp8nx4(cui8 value0, cui8 value1, cui8 value2, cui8 value3) { data8[0] = value0; data8[1] = value1; data8[2] = value2; data8[3] = value3; }
    fp8nx4(csi32 value0, csi32 value1, csi32 value2, csi32 value3) { data8[0] = (ui8 &)value0; data8[1] = (ui8 &)value1; data8[2] = (ui8 &)value2; data8[3] = (ui8 &)value3; }
    fp8nx4(cfl32 value, cui8 index, cfl32 floor, cfl32 ceiling) {
-      __fpdt_data__.origin8      = floor;
-      __fpdt_data__.range8       = ceiling - floor;
-      __fpdt_data__.maxDivRange8 = 255.0f / __fpdt_data__.range8;
-      __fpdt_data__.rangeDivMax8 = __fpdt_data__.range8 / 255.0f;
+      __fpdt_data__.setRange8(floor, ceiling);
       data8[index] = ui8((value - floor) * __fpdt_data__.maxDivRange8);
    };
    fp8nx4(cfl32x4 value, cfl32 floor, cfl32 ceiling) {
-      __fpdt_data__.origin8      = floor;
-      __fpdt_data__.range8       = ceiling - floor;
-      __fpdt_data__.maxDivRange8 = 255.0f / __fpdt_data__.range8;
-      __fpdt_data__.rangeDivMax8 = __fpdt_data__.range8 / 255.0f;
+      __fpdt_data__.setRange8(floor, ceiling);
       data32 = toFixed4(value).data32;
    }
 
@@ -473,17 +513,9 @@ struct fp16n {
    inline cui16 toFixedMod(cfl32 &value) const { return ui16(value * __fpdt_data__.maxDivRange16); }
 
    fp16n(void) {};
-   fp16n(cfl32 floor, cfl32 ceiling) {
-      __fpdt_data__.origin16      = floor;
-      __fpdt_data__.range16       = ceiling - floor;
-      __fpdt_data__.maxDivRange16 = 65535.0f / __fpdt_data__.range16;
-      __fpdt_data__.rangeDivMax16 = __fpdt_data__.range16 / 65535.0f;
-   };
+   fp16n(cfl32 floor, cfl32 ceiling) { __fpdt_data__.setRange16(floor, ceiling); }
    fp16n(cfl32 value, cfl32 floor, cfl32 ceiling) {
-      __fpdt_data__.origin16      = floor;
-      __fpdt_data__.range16       = ceiling - floor;
-      __fpdt_data__.maxDivRange16 = 65535.0f / __fpdt_data__.range16;
-      __fpdt_data__.rangeDivMax16 = __fpdt_data__.range16 / 65535.0f;
+      __fpdt_data__.setRange16(floor, ceiling);
 
       data = ui16((value - floor) * __fpdt_data__.maxDivRange16);
    };
@@ -599,12 +631,7 @@ struct fp16nx4 {
    }
 
    fp16nx4(void) = default;
-   fp16nx4(cfl32 floor, cfl32 ceiling) {
-      __fpdt_data__.origin16      = floor;
-      __fpdt_data__.range16       = ceiling - floor;
-      __fpdt_data__.maxDivRange16 = 65535.0f / __fpdt_data__.range16;
-      __fpdt_data__.rangeDivMax16 = __fpdt_data__.range16 / 65535.0f;
-   };
+   fp16nx4(cfl32 floor, cfl32 ceiling) { __fpdt_data__.setRange16(floor, ceiling); }
    fp16nx4(cfp16n value, cui8 index) { data[index] = value.data; }
    fp16nx4(cui16 value, cui8 index) { data16[index] = value; }
    fp16nx4(csi32 value, cui8 index) { data16[index] = (ui16 &)value; }
@@ -626,17 +653,11 @@ struct fp16nx4 {
    fp16nx4(cui16 value0, cui16 value1, cui16 value2, cui16 value3) { data16[0] = value0; data16[1] = value1; data16[2] = value2; data16[3] = value3; }
    fp16nx4(csi32 value0, csi32 value1, csi32 value2, csi32 value3) { data16[0] = (ui16 &)value0; data16[1] = (ui16 &)value1; data16[2] = (ui16 &)value2; data16[3] = (ui16 &)value3; }
    fp16nx4(cfl32 value, cui8 index, cfl32 floor, cfl32 ceiling) {
-      __fpdt_data__.origin16      = floor;
-      __fpdt_data__.range16       = ceiling - floor;
-      __fpdt_data__.maxDivRange16 = 65535.0f / __fpdt_data__.range16;
-      __fpdt_data__.rangeDivMax16 = __fpdt_data__.range16 / 65535.0f;
+      __fpdt_data__.setRange16(floor, ceiling);
       data16[index] = ui16((value - floor) * __fpdt_data__.maxDivRange16);
    };
    fp16nx4(cfl32x4 value, cfl32 floor, cfl32 ceiling) {
-      __fpdt_data__.origin16      = floor;
-      __fpdt_data__.range16       = ceiling - floor;
-      __fpdt_data__.maxDivRange16 = 65535.0f / __fpdt_data__.range16;
-      __fpdt_data__.rangeDivMax16 = __fpdt_data__.range16 / 65535.0f;
+      __fpdt_data__.setRange16(floor, ceiling);
       data64 = toFixed4(value).data64;
    }
 
@@ -758,17 +779,9 @@ struct fp24n {
    inline cui24 toFixedMod(cfl32 &value) const { return ui24(value * __fpdt_data__.maxDivRange24); }
 
    fp24n(void) = default;
-   fp24n(cfl32 floor, cfl32 ceiling) {
-      __fpdt_data__.origin24      = floor;
-      __fpdt_data__.range24       = ceiling - floor;
-      __fpdt_data__.maxDivRange24 = 16777215.0f / __fpdt_data__.range24;
-      __fpdt_data__.rangeDivMax24 = __fpdt_data__.range24 / 16777215.0f;
-   };
+   fp24n(cfl32 floor, cfl32 ceiling) { __fpdt_data__.setRange24(floor, ceiling); }
    fp24n(cfl32 value, cfl32 floor, cfl32 ceiling) {
-      __fpdt_data__.origin24      = floor;
-      __fpdt_data__.range24       = ceiling - floor;
-      __fpdt_data__.maxDivRange24 = 16777215.0f / __fpdt_data__.range24;
-      __fpdt_data__.rangeDivMax24 = __fpdt_data__.range24 / 16777215.0f;
+      __fpdt_data__.setRange24(floor, ceiling);
 
       data = ui24((value - floor) * __fpdt_data__.maxDivRange24);
    };
@@ -874,17 +887,9 @@ struct fp32n {
    inline cui32 toFixedMod(cfl64 &value) const { return ui32(value * __fpdt_data__.maxDivRange32); }
 
    fp32n(void) = default;
-   fp32n(cfl64 floor, cfl64 ceiling) {
-      __fpdt_data__.origin32      = floor;
-      __fpdt_data__.range32       = ceiling - floor;
-      __fpdt_data__.maxDivRange32 = 4294967296.0 / __fpdt_data__.range32;
-      __fpdt_data__.rangeDivMax32 = __fpdt_data__.range32 / 4294967296.0;
-   };
+   fp32n(cfl64 floor, cfl64 ceiling) { __fpdt_data__.setRange32(floor, ceiling); }
    fp32n(cfl64 value, cfl64 floor, cfl64 ceiling) {
-      __fpdt_data__.origin32      = floor;
-      __fpdt_data__.range32       = ceiling - floor;
-      __fpdt_data__.maxDivRange32 = 4294967296.0 / __fpdt_data__.range32;
-      __fpdt_data__.rangeDivMax32 = __fpdt_data__.range32 / 4294967296.0;
+      __fpdt_data__.setRange32(floor, ceiling);
 
       data = ui32((value - floor) * __fpdt_data__.maxDivRange32);
    };
@@ -1041,16 +1046,16 @@ struct f0p8 {
 
    inline cf0p8 operator+(cf0p8 &value) const { return (cf0p8 &)(data + value.data); }
    inline cf0p8 operator-(cf0p8 &value) const { return (cf0p8 &)(data - value.data); }
-   inline cf0p8 operator*(cf0p8 &value) const { return toFixed(toFloat() * toFloat(value)); }
-   inline cf0p8 operator/(cf0p8 &value) const { return toFixed(toFloat() / toFloat(value)); }
+   inline cf0p8 operator*(cf0p8 &value) const { return ui8(_fpdt_mulU16(data, value.data, 8)); }
+   inline cf0p8 operator/(cf0p8 &value) const { return ui8(_fpdt_divU16(data, value.data, 8, 0x0FF)); }
    inline cf0p8 operator%(cf0p8 &value) const { return (cf0p8 &)(data % value.data); }
    inline cf0p8 operator&(cf0p8 &value) const { return (cf0p8 &)(data & value.data); }
    inline cf0p8 operator|(cf0p8 &value) const { return (cf0p8 &)(data | value.data); }
    inline cf0p8 operator^(cf0p8 &value) const { return (cf0p8 &)(data ^ value.data); }
    inline cf0p8 operator+=(cf0p8 &value) { return (cf0p8 &)(data += value.data); }
    inline cf0p8 operator-=(cf0p8 &value) { return (cf0p8 &)(data -= value.data); }
-   inline cf0p8 operator*=(cf0p8 &value) { return data = toFixed(toFloat() * toFloat(value)); }
-   inline cf0p8 operator/=(cf0p8 &value) { return data = toFixed(toFloat() / toFloat(value)); }
+   inline cf0p8 operator*=(cf0p8 &value) { return data = ui8(_fpdt_mulU16(data, value.data, 8)); }
+   inline cf0p8 operator/=(cf0p8 &value) { return data = ui8(_fpdt_divU16(data, value.data, 8, 0x0FF)); }
    inline cf0p8 operator%=(cf0p8 &value) { return (cf0p8 &)(data %= value.data); }
    inline cf0p8 operator&=(cf0p8 &value) { return (cf0p8 &)(data &= value.data); }
    inline cf0p8 operator|=(cf0p8 &value) { return (cf0p8 &)(data |= value.data); }
@@ -1145,16 +1150,16 @@ struct f1p7 {
 
    inline cf1p7 operator+(cf1p7 &value) const { return (cf1p7 &)(data + value.data); }
    inline cf1p7 operator-(cf1p7 &value) const { return (cf1p7 &)(data - value.data); }
-   inline cf1p7 operator*(cf1p7 &value) const { return toFixed(toFloat() * toFloat(value)); }
-   inline cf1p7 operator/(cf1p7 &value) const { return toFixed(toFloat() / toFloat(value)); }
+   inline cf1p7 operator*(cf1p7 &value) const { return ui8(_fpdt_mulU16(data, value.data, 7)); }
+   inline cf1p7 operator/(cf1p7 &value) const { return ui8(_fpdt_divU16(data, value.data, 7, 0x0FF)); }
    inline cf1p7 operator%(cf1p7 &value) const { return (cf1p7 &)(data % value.data); }
    inline cf1p7 operator&(cf1p7 &value) const { return (cf1p7 &)(data & value.data); }
    inline cf1p7 operator|(cf1p7 &value) const { return (cf1p7 &)(data | value.data); }
    inline cf1p7 operator^(cf1p7 &value) const { return (cf1p7 &)(data ^ value.data); }
    inline cf1p7 operator+=(cf1p7 &value) { return (cf1p7 &)(data += value.data); }
    inline cf1p7 operator-=(cf1p7 &value) { return (cf1p7 &)(data -= value.data); }
-   inline cf1p7 operator*=(cf1p7 &value) { return data = toFixed(toFloat() * toFloat(value)); }
-   inline cf1p7 operator/=(cf1p7 &value) { return data = toFixed(toFloat() / toFloat(value)); }
+   inline cf1p7 operator*=(cf1p7 &value) { return data = ui8(_fpdt_mulU16(data, value.data, 7)); }
+   inline cf1p7 operator/=(cf1p7 &value) { return data = ui8(_fpdt_divU16(data, value.data, 7, 0x0FF)); }
    inline cf1p7 operator%=(cf1p7 &value) { return (cf1p7 &)(data %= value.data); }
    inline cf1p7 operator&=(cf1p7 &value) { return (cf1p7 &)(data &= value.data); }
    inline cf1p7 operator|=(cf1p7 &value) { return (cf1p7 &)(data |= value.data); }
@@ -1249,16 +1254,16 @@ struct f4p4 {
 
    inline cf4p4 operator+(cf4p4 &value) const { return (cf4p4 &)(data + value.data); }
    inline cf4p4 operator-(cf4p4 &value) const { return (cf4p4 &)(data - value.data); }
-   inline cf4p4 operator*(cf4p4 &value) const { return toFixed(toFloat() * toFloat(value)); }
-   inline cf4p4 operator/(cf4p4 &value) const { return toFixed(toFloat() / toFloat(value)); }
+   inline cf4p4 operator*(cf4p4 &value) const { return ui8(_fpdt_mulU16(data, value.data, 4)); }
+   inline cf4p4 operator/(cf4p4 &value) const { return ui8(_fpdt_divU16(data, value.data, 4, 0x0FF)); }
    inline cf4p4 operator%(cf4p4 &value) const { return (cf4p4 &)(data % value.data); }
    inline cf4p4 operator&(cf4p4 &value) const { return (cf4p4 &)(data & value.data); }
    inline cf4p4 operator|(cf4p4 &value) const { return (cf4p4 &)(data | value.data); }
    inline cf4p4 operator^(cf4p4 &value) const { return (cf4p4 &)(data ^ value.data); }
    inline cf4p4 operator+=(cf4p4 &value) { return (cf4p4 &)(data += value.data); }
    inline cf4p4 operator-=(cf4p4 &value) { return (cf4p4 &)(data -= value.data); }
-   inline cf4p4 operator*=(cf4p4 &value) { return data = toFixed(toFloat() * toFloat(value)); }
-   inline cf4p4 operator/=(cf4p4 &value) { return data = toFixed(toFloat() / toFloat(value)); }
+   inline cf4p4 operator*=(cf4p4 &value) { return data = ui8(_fpdt_mulU16(data, value.data, 4)); }
+   inline cf4p4 operator/=(cf4p4 &value) { return data = ui8(_fpdt_divU16(data, value.data, 4, 0x0FF)); }
    inline cf4p4 operator%=(cf4p4 &value) { return (cf4p4 &)(data %= value.data); }
    inline cf4p4 operator&=(cf4p4 &value) { return (cf4p4 &)(data &= value.data); }
    inline cf4p4 operator|=(cf4p4 &value) { return (cf4p4 &)(data |= value.data); }
@@ -1504,16 +1509,16 @@ struct f0p16 {
 
    inline cf0p16 operator+(cf0p16 &value) const { return (cf0p16 &)(data + value.data); }
    inline cf0p16 operator-(cf0p16 &value) const { return (cf0p16 &)(data - value.data); }
-   inline cf0p16 operator*(cf0p16 &value) const { return toFixed(toFloat() * toFloat(value)); }
-   inline cf0p16 operator/(cf0p16 &value) const { return toFixed(toFloat() / toFloat(value)); }
+   inline cf0p16 operator*(cf0p16 &value) const { return ui16(_fpdt_mulU16(data, value.data, 16)); }
+   inline cf0p16 operator/(cf0p16 &value) const { return ui16(_fpdt_divU16(data, value.data, 16, 0x0FFFF)); }
    inline cf0p16 operator%(cf0p16 &value) const { return (cf0p16 &)(data % value.data); }
    inline cf0p16 operator&(cf0p16 &value) const { return (cf0p16 &)(data & value.data); }
    inline cf0p16 operator|(cf0p16 &value) const { return (cf0p16 &)(data | value.data); }
    inline cf0p16 operator^(cf0p16 &value) const { return (cf0p16 &)(data ^ value.data); }
    inline cf0p16 operator+=(cf0p16 &value) { return (cf0p16 &)(data += value.data); }
    inline cf0p16 operator-=(cf0p16 &value) { return (cf0p16 &)(data -= value.data); }
-   inline cf0p16 operator*=(cf0p16 &value) { return data = toFixed(toFloat() * toFloat(value)); }
-   inline cf0p16 operator/=(cf0p16 &value) { return data = toFixed(toFloat() / toFloat(value)); }
+   inline cf0p16 operator*=(cf0p16 &value) { return data = ui16(_fpdt_mulU16(data, value.data, 16)); }
+   inline cf0p16 operator/=(cf0p16 &value) { return data = ui16(_fpdt_divU16(data, value.data, 16, 0x0FFFF)); }
    inline cf0p16 operator%=(cf0p16 &value) { return (cf0p16 &)(data %= value.data); }
    inline cf0p16 operator&=(cf0p16 &value) { return (cf0p16 &)(data &= value.data); }
    inline cf0p16 operator|=(cf0p16 &value) { return (cf0p16 &)(data |= value.data); }
@@ -1608,16 +1613,16 @@ struct fs1p14 {
 
    inline cfs1p14 operator+(cfs1p14 &value) const { return (cfs1p14 &)(data + value.data - 32768); }
    inline cfs1p14 operator-(cfs1p14 &value) const { return (cfs1p14 &)(data - value.data - 32768); }
-   inline cfs1p14 operator*(cfs1p14 &value) const { return toFixed(toFloat() * toFloat(value)); }
-   inline cfs1p14 operator/(cfs1p14 &value) const { return toFixed(toFloat() / toFloat(value)); }
+   inline cfs1p14 operator*(cfs1p14 &value) const { return _fpdt_mulS16(data, value.data, 14); }
+   inline cfs1p14 operator/(cfs1p14 &value) const { return _fpdt_divS16(data, value.data, 14); }
    inline cfs1p14 operator%(cfs1p14 &value) const { return (cfs1p14 &)(data % value.data); }
    inline cfs1p14 operator&(cfs1p14 &value) const { return (cfs1p14 &)(data & value.data); }
    inline cfs1p14 operator|(cfs1p14 &value) const { return (cfs1p14 &)(data | value.data); }
    inline cfs1p14 operator^(cfs1p14 &value) const { return (cfs1p14 &)(data ^ value.data); }
    inline cfs1p14 operator+=(cfs1p14 &value) { return (cfs1p14 &)(data += value.data - 32768); }
    inline cfs1p14 operator-=(cfs1p14 &value) { return (cfs1p14 &)(data -= value.data - 32768); }
-   inline cfs1p14 operator*=(cfs1p14 &value) { return data = toFixed(toFloat() * toFloat(value)); }
-   inline cfs1p14 operator/=(cfs1p14 &value) { return data = toFixed(toFloat() / toFloat(value)); }
+   inline cfs1p14 operator*=(cfs1p14 &value) { return data = _fpdt_mulS16(data, value.data, 14); }
+   inline cfs1p14 operator/=(cfs1p14 &value) { return data = _fpdt_divS16(data, value.data, 14); }
    inline cfs1p14 operator%=(cfs1p14 &value) { return (cfs1p14 &)(data %= value.data); }
    inline cfs1p14 operator&=(cfs1p14 &value) { return (cfs1p14 &)(data &= value.data); }
    inline cfs1p14 operator|=(cfs1p14 &value) { return (cfs1p14 &)(data |= value.data); }
@@ -1712,16 +1717,16 @@ struct f1p15 {
 
    inline cf1p15 operator+(cf1p15 &value) const { return (cf1p15 &)(data + value.data); }
    inline cf1p15 operator-(cf1p15 &value) const { return (cf1p15 &)(data - value.data); }
-   inline cf1p15 operator*(cf1p15 &value) const { return toFixed(toFloat() * toFloat(value)); }
-   inline cf1p15 operator/(cf1p15 &value) const { return toFixed(toFloat() / toFloat(value)); }
+   inline cf1p15 operator*(cf1p15 &value) const { return ui16(_fpdt_mulU16(data, value.data, 15)); }
+   inline cf1p15 operator/(cf1p15 &value) const { return ui16(_fpdt_divU16(data, value.data, 15, 0x0FFFF)); }
    inline cf1p15 operator%(cf1p15 &value) const { return (cf1p15 &)(data % value.data); }
    inline cf1p15 operator&(cf1p15 &value) const { return (cf1p15 &)(data & value.data); }
    inline cf1p15 operator|(cf1p15 &value) const { return (cf1p15 &)(data | value.data); }
    inline cf1p15 operator^(cf1p15 &value) const { return (cf1p15 &)(data ^ value.data); }
    inline cf1p15 operator+=(cf1p15 &value) { return (cf1p15 &)(data += value.data); }
    inline cf1p15 operator-=(cf1p15 &value) { return (cf1p15 &)(data -= value.data); }
-   inline cf1p15 operator*=(cf1p15 &value) { return data = toFixed(toFloat() * toFloat(value)); }
-   inline cf1p15 operator/=(cf1p15 &value) { return data = toFixed(toFloat() / toFloat(value)); }
+   inline cf1p15 operator*=(cf1p15 &value) { return data = ui16(_fpdt_mulU16(data, value.data, 15)); }
+   inline cf1p15 operator/=(cf1p15 &value) { return data = ui16(_fpdt_divU16(data, value.data, 15, 0x0FFFF)); }
    inline cf1p15 operator%=(cf1p15 &value) { return (cf1p15 &)(data %= value.data); }
    inline cf1p15 operator&=(cf1p15 &value) { return (cf1p15 &)(data &= value.data); }
    inline cf1p15 operator|=(cf1p15 &value) { return (cf1p15 &)(data |= value.data); }
@@ -1816,16 +1821,16 @@ struct f6p10 {
 
    inline cf6p10 operator+(cf6p10 &value) const { return (cf6p10 &)(data + value.data); }
    inline cf6p10 operator-(cf6p10 &value) const { return (cf6p10 &)(data - value.data); }
-   inline cf6p10 operator*(cf6p10 &value) const { return toFixed(toFloat() * toFloat(value)); }
-   inline cf6p10 operator/(cf6p10 &value) const { return toFixed(toFloat() / toFloat(value)); }
+   inline cf6p10 operator*(cf6p10 &value) const { return ui16(_fpdt_mulU16(data, value.data, 10)); }
+   inline cf6p10 operator/(cf6p10 &value) const { return ui16(_fpdt_divU16(data, value.data, 10, 0x0FFFF)); }
    inline cf6p10 operator%(cf6p10 &value) const { return (cf6p10 &)(data % value.data); }
    inline cf6p10 operator&(cf6p10 &value) const { return (cf6p10 &)(data & value.data); }
    inline cf6p10 operator|(cf6p10 &value) const { return (cf6p10 &)(data | value.data); }
    inline cf6p10 operator^(cf6p10 &value) const { return (cf6p10 &)(data ^ value.data); }
    inline cf6p10 operator+=(cf6p10 &value) { return (cf6p10 &)(data += value.data); }
    inline cf6p10 operator-=(cf6p10 &value) { return (cf6p10 &)(data -= value.data); }
-   inline cf6p10 operator*=(cf6p10 &value) { return data = toFixed(toFloat() * toFloat(value)); }
-   inline cf6p10 operator/=(cf6p10 &value) { return data = toFixed(toFloat() / toFloat(value)); }
+   inline cf6p10 operator*=(cf6p10 &value) { return data = ui16(_fpdt_mulU16(data, value.data, 10)); }
+   inline cf6p10 operator/=(cf6p10 &value) { return data = ui16(_fpdt_divU16(data, value.data, 10, 0x0FFFF)); }
    inline cf6p10 operator%=(cf6p10 &value) { return (cf6p10 &)(data %= value.data); }
    inline cf6p10 operator&=(cf6p10 &value) { return (cf6p10 &)(data &= value.data); }
    inline cf6p10 operator|=(cf6p10 &value) { return (cf6p10 &)(data |= value.data); }
@@ -1920,16 +1925,16 @@ struct fs7p8 {
 
    inline cfs7p8 operator+(cfs7p8 &value) const { return (cfs7p8 &)(data + value.data - 32768); }
    inline cfs7p8 operator-(cfs7p8 &value) const { return (cfs7p8 &)(data - value.data - 32768); }
-   inline cfs7p8 operator*(cfs7p8 &value) const { return toFixed(toFloat() * toFloat(value)); }
-   inline cfs7p8 operator/(cfs7p8 &value) const { return toFixed(toFloat() / toFloat(value)); }
+   inline cfs7p8 operator*(cfs7p8 &value) const { return _fpdt_mulS16(data, value.data, 8); }
+   inline cfs7p8 operator/(cfs7p8 &value) const { return _fpdt_divS16(data, value.data, 8); }
    inline cfs7p8 operator%(cfs7p8 &value) const { return (cfs7p8 &)(data % value.data); }
    inline cfs7p8 operator&(cfs7p8 &value) const { return (cfs7p8 &)(data & value.data); }
    inline cfs7p8 operator|(cfs7p8 &value) const { return (cfs7p8 &)(data | value.data); }
    inline cfs7p8 operator^(cfs7p8 &value) const { return (cfs7p8 &)(data ^ value.data); }
    inline cfs7p8 operator+=(cfs7p8 &value) { return (cfs7p8 &)(data += value.data - 32768); }
    inline cfs7p8 operator-=(cfs7p8 &value) { return (cfs7p8 &)(data -= value.data - 32768); }
-   inline cfs7p8 operator*=(cfs7p8 &value) { return data = toFixed(toFloat() * toFloat(value)); }
-   inline cfs7p8 operator/=(cfs7p8 &value) { return data = toFixed(toFloat() / toFloat(value)); }
+   inline cfs7p8 operator*=(cfs7p8 &value) { return data = _fpdt_mulS16(data, value.data, 8); }
+   inline cfs7p8 operator/=(cfs7p8 &value) { return data = _fpdt_divS16(data, value.data, 8); }
    inline cfs7p8 operator%=(cfs7p8 &value) { return (cfs7p8 &)(data %= value.data); }
    inline cfs7p8 operator&=(cfs7p8 &value) { return (cfs7p8 &)(data &= value.data); }
    inline cfs7p8 operator|=(cfs7p8 &value) { return (cfs7p8 &)(data |= value.data); }
@@ -2024,16 +2029,16 @@ struct f7p9 {
 
    inline cf7p9 operator+(cf7p9 &value) const { return (cf7p9 &)(data + value.data); }
    inline cf7p9 operator-(cf7p9 &value) const { return (cf7p9 &)(data - value.data); }
-   inline cf7p9 operator*(cf7p9 &value) const { return toFixed(toFloat() * toFloat(value)); }
-   inline cf7p9 operator/(cf7p9 &value) const { return toFixed(toFloat() / toFloat(value)); }
+   inline cf7p9 operator*(cf7p9 &value) const { return ui16(_fpdt_mulU16(data, value.data, 9)); }
+   inline cf7p9 operator/(cf7p9 &value) const { return ui16(_fpdt_divU16(data, value.data, 9, 0x0FFFF)); }
    inline cf7p9 operator%(cf7p9 &value) const { return (cf7p9 &)(data % value.data); }
    inline cf7p9 operator&(cf7p9 &value) const { return (cf7p9 &)(data & value.data); }
    inline cf7p9 operator|(cf7p9 &value) const { return (cf7p9 &)(data | value.data); }
    inline cf7p9 operator^(cf7p9 &value) const { return (cf7p9 &)(data ^ value.data); }
    inline cf7p9 operator+=(cf7p9 &value) { return (cf7p9 &)(data += value.data); }
    inline cf7p9 operator-=(cf7p9 &value) { return (cf7p9 &)(data -= value.data); }
-   inline cf7p9 operator*=(cf7p9 &value) { return data = toFixed(toFloat() * toFloat(value)); }
-   inline cf7p9 operator/=(cf7p9 &value) { return data = toFixed(toFloat() / toFloat(value)); }
+   inline cf7p9 operator*=(cf7p9 &value) { return data = ui16(_fpdt_mulU16(data, value.data, 9)); }
+   inline cf7p9 operator/=(cf7p9 &value) { return data = ui16(_fpdt_divU16(data, value.data, 9, 0x0FFFF)); }
    inline cf7p9 operator%=(cf7p9 &value) { return (cf7p9 &)(data %= value.data); }
    inline cf7p9 operator&=(cf7p9 &value) { return (cf7p9 &)(data &= value.data); }
    inline cf7p9 operator|=(cf7p9 &value) { return (cf7p9 &)(data |= value.data); }
@@ -2128,16 +2133,16 @@ struct f8p8 {
 
    inline cf8p8 operator+(cf8p8 &value) const { return (cf8p8 &)(data + value.data); }
    inline cf8p8 operator-(cf8p8 &value) const { return (cf8p8 &)(data - value.data); }
-   inline cf8p8 operator*(cf8p8 &value) const { return toFixed(toFloat() * toFloat(value)); }
-   inline cf8p8 operator/(cf8p8 &value) const { return toFixed(toFloat() / toFloat(value)); }
+   inline cf8p8 operator*(cf8p8 &value) const { return ui16(_fpdt_mulU16(data, value.data, 8)); }
+   inline cf8p8 operator/(cf8p8 &value) const { return ui16(_fpdt_divU16(data, value.data, 8, 0x0FFFF)); }
    inline cf8p8 operator%(cf8p8 &value) const { return (cf8p8 &)(data % value.data); }
    inline cf8p8 operator&(cf8p8 &value) const { return (cf8p8 &)(data & value.data); }
    inline cf8p8 operator|(cf8p8 &value) const { return (cf8p8 &)(data | value.data); }
    inline cf8p8 operator^(cf8p8 &value) const { return (cf8p8 &)(data ^ value.data); }
    inline cf8p8 operator+=(cf8p8 &value) { return (cf8p8 &)(data += value.data); }
    inline cf8p8 operator-=(cf8p8 &value) { return (cf8p8 &)(data -= value.data); }
-   inline cf8p8 operator*=(cf8p8 &value) { return data = toFixed(toFloat() * toFloat(value)); }
-   inline cf8p8 operator/=(cf8p8 &value) { return data = toFixed(toFloat() / toFloat(value)); }
+   inline cf8p8 operator*=(cf8p8 &value) { return data = ui16(_fpdt_mulU16(data, value.data, 8)); }
+   inline cf8p8 operator/=(cf8p8 &value) { return data = ui16(_fpdt_divU16(data, value.data, 8, 0x0FFFF)); }
    inline cf8p8 operator%=(cf8p8 &value) { return (cf8p8 &)(data %= value.data); }
    inline cf8p8 operator&=(cf8p8 &value) { return (cf8p8 &)(data &= value.data); }
    inline cf8p8 operator|=(cf8p8 &value) { return (cf8p8 &)(data |= value.data); }
@@ -2696,9 +2701,9 @@ struct fp16n_128_128 {
 
    ui16 data;
 
-   inline cui16 toFixed(cfl32 &value) const { return ui16(value * _fpdt_65535div256f); }
-   inline cfl32 toFloat(void) const { return cfl32(data) * _fpdt_256div65535f; }
-   inline cfl32 toFloat(cfp16n_128_128 &value) const { return fl32(value.data) * _fpdt_256div65535f; }
+   inline cui16 toFixed(cfl32 &value) const { return ui16((value + 128.0f) * _fpdt_65535div256f); }
+   inline cfl32 toFloat(void) const { return cfl32(data) * _fpdt_256div65535f - 128.0f; }
+   inline cfl32 toFloat(cfp16n_128_128 &value) const { return fl32(value.data) * _fpdt_256div65535f - 128.0f; }
 
    fp16n_128_128(void) = default;
 #ifndef FPDT_NO_CUSTOM
@@ -2715,7 +2720,7 @@ struct fp16n_128_128 {
    fp16n_128_128(cfl32 value) { data = toFixed(value); }
 
    operator ptr(void) const { return *this; }
-   operator cfl32(void) const { return cfl32(data) * _fpdt_256div65535f; }
+   operator cfl32(void) const { return cfl32(data) * _fpdt_256div65535f - 128.0f; }
 
    inline cfp16n_128_128 &operator&(void) const { return *this; }
    inline cfp16n_128_128 operator~(void) const { return (cfp16n_128_128 &)~data; }
@@ -2804,8 +2809,8 @@ struct fs7p8x3 {
    inline ci16x3 toFixed3(cfl32x4 &value) const { cui64 data64 = (ui64 &)_mm_shuffle_epi8(_mm_cvttps_epi32(_mm_mul_ps(_mm_add_ps(value, _fpdt_128fx4), _fpdt_256fx4)), _fpdt_shuffle16s); return *(i16x3 *)&data64; }
    inline cfl32 toFloat(cui8 index) const { return cfl32(data16[index]) * _fpdt_rcp256f - 128.0f; }
    inline cfl32 toFloat(cfs7p8 &value) const { return fl32(value.data) * _fpdt_rcp256f - 128.0f; }
-   inline cfl32x4 toFloat3(void) const { return _mm_sub_ps(_mm_mul_ps(_mm_cvtepu32_ps(_mm_cvtepu8_epi32(_mm_cvtsi64_si128((si64 &)*this))), _fpdt_rcp256fx4), _fpdt_128fx4); } // 4th element is undefined
-   inline cfl32x4 toFloat3(cfs7p8x3 value) const { return _mm_sub_ps(_mm_mul_ps(_mm_cvtepu32_ps(_mm_cvtepu8_epi32(_mm_cvtsi64_si128((si64 &)value))), _fpdt_rcp256fx4), _fpdt_128fx4); } // 4th element is undefined
+   inline cfl32x4 toFloat3(void) const { return _mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtepu16_epi32(_mm_cvtsi64_si128((si64 &)*this))), _fpdt_rcp256fx4), _fpdt_128fx4); } // 4th element is undefined
+   inline cfl32x4 toFloat3(cfs7p8x3 value) const { return _mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtepu16_epi32(_mm_cvtsi64_si128((si64 &)value))), _fpdt_rcp256fx4), _fpdt_128fx4); } // 4th element is undefined
 
    fs7p8x3(void) = default;
    fs7p8x3(cfs7p8 value, cui16 index) { data[index] = value; }
@@ -2825,6 +2830,17 @@ struct fs7p8x3 {
    operator ptr(void) const { return *this; }
    operator cfl32x4(void) const { return toFloat3(); } // 4th element is undefined
 
+   // Rounded 7.8 product of each lane; the excess-32768 lanes become signed by flipping their top bit around a signed multiply
+   inline ci16x3 mul3(cfs7p8x3 &value) const {
+      cui128 sign = _mm_set1_epi16(si16(0x08000));
+      csi128 a = _mm_xor_si128(_mm_insert_epi16(_mm_cvtsi32_si128(*(si32 *)&data16[0]), data16[2], 2), sign);
+      csi128 b = _mm_xor_si128(_mm_insert_epi16(_mm_cvtsi32_si128(*(si32 *)&value.data16[0]), value.data16[2], 2), sign);
+      csi128 lo = _mm_mullo_epi16(a, b);
+      cui64  data64 = _mm_cvtsi128_si64(_mm_xor_si128(_mm_add_epi16(_mm_or_si128(_mm_slli_epi16(_mm_mulhi_epi16(a, b), 8), _mm_srli_epi16(lo, 8)), _mm_and_si128(_mm_srli_epi16(lo, 7), _fpdt_1x8)), sign));
+
+      return *(i16x3 *)&data64;
+   }
+
    inline cfs7p8x3 &operator&(void) const { return *this; }
    inline cfs7p8x3 &operator&(cui16 (&value)[3]) const { return (cfs7p8x3 &)value; }
 
@@ -2842,6 +2858,8 @@ struct fs7p8x3 {
    inline cfs7p8x3 operator-(cfs7p8x3 &value) const { return cfs7p8x3{ ui16(data16[0] - value.data16[0]), ui16(data16[1] - value.data16[1]), ui16(data16[2] - value.data16[2]) }; }
    inline cfs7p8x3 operator+=(cfs7p8x3 &value) { return cfs7p8x3{ data16[0] += value.data16[0], data16[1] += value.data16[1], data16[2] += value.data16[2]}; }
    inline cfs7p8x3 operator-=(cfs7p8x3 &value) { return cfs7p8x3{ data16[0] -= value.data16[0], data16[1] -= value.data16[1], data16[2] -= value.data16[2]}; }
+   inline cfs7p8x3 operator*(cfs7p8x3 &value) const { ci16x3 temp = mul3(value); return *(cfs7p8x3 *)&temp; }
+   inline cfs7p8x3 operator*=(cfs7p8x3 &value) { data48 = mul3(value); return *this; }
 
    inline cfs7p8x3 operator+(cfl32x4 &value) const { ci16x3 temp = toFixed3(_mm_add_ps(value, toFloat3())); return *(cfs7p8x3 *)&temp; }
    inline cfs7p8x3 operator-(cfl32x4 &value) const { ci16x3 temp = toFixed3(_mm_sub_ps(value, toFloat3())); return *(cfs7p8x3 *)&temp; }
@@ -2872,7 +2890,15 @@ struct f1p15x4 {
    f1p15x4(cSSE4Df32 value) { data64 = (ui64 &)_mm_shuffle_epi8(_mm_cvttps_epi32(_mm_mul_ps(value.xmm, _fpdt_32768fx4)), _fpdt_shuffle16s); }
 #endif
    operator ptr(void) const { return *this; }
-   operator cfl32x4(void) const { return _mm_mul_ps(_mm_cvtepu32_ps(_mm_cvtepu8_epi32(_mm_cvtsi64_si128(data64))), _fpdt_rcp255fx4); }
+   operator cfl32x4(void) const { return _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtepu16_epi32(_mm_cvtsi64_si128(data64))), _fpdt_rcp32768fx4); }
+
+   // Rounded 1.15 product of each lane, (a * b + 0x4000) >> 15, assembled from the high & low halves of the 32-bit products
+   inline cui64 mul4(cui64 &value) const {
+      csi128 a = _mm_cvtsi64_si128(data64), b = _mm_cvtsi64_si128(value);
+      csi128 lo = _mm_mullo_epi16(a, b);
+
+      return _mm_cvtsi128_si64(_mm_add_epi16(_mm_or_si128(_mm_slli_epi16(_mm_mulhi_epu16(a, b), 1), _mm_srli_epi16(lo, 15)), _mm_and_si128(_mm_srli_epi16(lo, 14), _fpdt_1x8)));
+   }
 
    inline cf1p15x4 &operator&(void) const { return *this; }
    inline cf1p15x4 &operator&(cui64 &value) const { return (cf1p15x4 &)value; }
@@ -2891,6 +2917,8 @@ struct f1p15x4 {
    inline cf1p15x4 operator-(cf1p15x4 &value) const { return (cf1p15x4 &)_mm_add_epi16(_mm_cvtsi64_si128(data64), _mm_cvtsi64_si128(value.data64)); }
    inline cf1p15x4 operator+=(cf1p15x4 &value) { data64 = (ui64 &)_mm_add_epi16(_mm_cvtsi64_si128(data64), _mm_cvtsi64_si128(value.data64)); return *this; }
    inline cf1p15x4 operator-=(cf1p15x4 &value) { data64 = (ui64 &)_mm_sub_epi16(_mm_cvtsi64_si128(data64), _mm_cvtsi64_si128(value.data64)); return *this; }
+   inline cf1p15x4 operator*(cf1p15x4 &value) const { return mul4(value.data64); }
+   inline cf1p15x4 operator*=(cf1p15x4 &value) { data64 = mul4(value.data64); return *this; }
 
    inline cf1p15x4 operator+(cfl32x4 &value) const { return (cf1p15x4 &)_mm_add_epi16(_mm_cvtsi64_si128(data64), _mm_shuffle_epi8(_mm_cvttps_epi32(_mm_mul_ps(value, _fpdt_65535fx4)), _fpdt_shuffle16s)); }
    inline cf1p15x4 operator-(cfl32x4 &value) const { return (cf1p15x4 &)_mm_add_epi16(_mm_cvtsi64_si128(data64), _mm_shuffle_epi8(_mm_cvttps_epi32(_mm_mul_ps(value, _fpdt_65535fx4)), _fpdt_shuffle16s)); }
@@ -2922,7 +2950,7 @@ struct fp16n0_1x4 {
 #endif
 
    operator cui64(void) const { return data64; }
-   operator cfl32x4(void) const { return _mm_mul_ps(_mm_cvtepu32_ps(_mm_cvtepu8_epi32(_mm_cvtsi64_si128(data64))), _fpdt_rcp255fx4); }
+   operator cfl32x4(void) const { return _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtepu16_epi32(_mm_cvtsi64_si128(data64))), _fpdt_rcp65535fx4); }
 
    inline cfp16n0_1x4 operator++(void) { data16[0]++; data16[1]++; data16[2]++; data16[3]++; return *this; }
    inline cfp16n0_1x4 operator++(int) { al8 cui16 temp[4] = { data16[0]++, data16[1]++, data16[2]++, data16[3]++ }; return (cfp16n0_1x4 &)temp; }
@@ -3351,16 +3379,16 @@ struct f0p24 {
 
    inline cf0p24 operator+(cf0p24 &value) const { return (cf0p24 &)(data + value.data); }
    inline cf0p24 operator-(cf0p24 &value) const { return (cf0p24 &)(data - value.data); }
-   inline cf0p24 operator*(cf0p24 &value) const { return toFixed(toFloat() * toFloat(value)); }
-   inline cf0p24 operator/(cf0p24 &value) const { return toFixed(toFloat() / toFloat(value)); }
+   inline cf0p24 operator*(cf0p24 &value) const { return ui24(_fpdt_mulU32(data, value.data, 24)); }
+   inline cf0p24 operator/(cf0p24 &value) const { return ui24(_fpdt_divU32(data, value.data, 24, 0x0FFFFFF)); }
    inline cf0p24 operator%(cf0p24 &value) const { return (cf0p24 &)(data % value.data); }
    inline cf0p24 operator&(cf0p24 &value) const { return (cf0p24 &)(data & value.data); }
    inline cf0p24 operator|(cf0p24 &value) const { return (cf0p24 &)(data | value.data); }
    inline cf0p24 operator^(cf0p24 &value) const { return (cf0p24 &)(data ^ value.data); }
    inline cf0p24 operator+=(cf0p24 &value) { return (cf0p24 &)(data += value.data); }
    inline cf0p24 operator-=(cf0p24 &value) { return (cf0p24 &)(data -= value.data); }
-   inline cf0p24 operator*=(cf0p24 &value) { return data = toFixed(toFloat() * toFloat(value)); }
-   inline cf0p24 operator/=(cf0p24 &value) { return data = toFixed(toFloat() / toFloat(value)); }
+   inline cf0p24 operator*=(cf0p24 &value) { return data = ui24(_fpdt_mulU32(data, value.data, 24)); }
+   inline cf0p24 operator/=(cf0p24 &value) { return data = ui24(_fpdt_divU32(data, value.data, 24, 0x0FFFFFF)); }
    inline cf0p24 operator%=(cf0p24 &value) { return (cf0p24 &)(data %= value.data); }
    inline cf0p24 operator&=(cf0p24 &value) { return (cf0p24 &)(data &= value.data); }
    inline cf0p24 operator|=(cf0p24 &value) { return (cf0p24 &)(data |= value.data); }
@@ -3453,16 +3481,16 @@ struct f8p16 {
 
    inline cf8p16 operator+(cf8p16 &value) const { return (cf8p16 &)(data + value.data); }
    inline cf8p16 operator-(cf8p16 &value) const { return (cf8p16 &)(data - value.data); }
-   inline cf8p16 operator*(cf8p16 &value) const { return toFixed(toFloat() * toFloat(value)); }
-   inline cf8p16 operator/(cf8p16 &value) const { return toFixed(toFloat() / toFloat(value)); }
+   inline cf8p16 operator*(cf8p16 &value) const { return ui24(_fpdt_mulU32(data, value.data, 16)); }
+   inline cf8p16 operator/(cf8p16 &value) const { return ui24(_fpdt_divU32(data, value.data, 16, 0x0FFFFFF)); }
    inline cf8p16 operator%(cf8p16 &value) const { return (cf8p16 &)(data % value.data); }
    inline cf8p16 operator&(cf8p16 &value) const { return (cf8p16 &)(data & value.data); }
    inline cf8p16 operator|(cf8p16 &value) const { return (cf8p16 &)(data | value.data); }
    inline cf8p16 operator^(cf8p16 &value) const { return (cf8p16 &)(data ^ value.data); }
    inline cf8p16 operator+=(cf8p16 &value) { return (cf8p16 &)(data += value.data); }
    inline cf8p16 operator-=(cf8p16 &value) { return (cf8p16 &)(data -= value.data); }
-   inline cf8p16 operator*=(cf8p16 &value) { return data = toFixed(toFloat() * toFloat(value)); }
-   inline cf8p16 operator/=(cf8p16 &value) { return data = toFixed(toFloat() / toFloat(value)); }
+   inline cf8p16 operator*=(cf8p16 &value) { return data = ui24(_fpdt_mulU32(data, value.data, 16)); }
+   inline cf8p16 operator/=(cf8p16 &value) { return data = ui24(_fpdt_divU32(data, value.data, 16, 0x0FFFFFF)); }
    inline cf8p16 operator%=(cf8p16 &value) { return (cf8p16 &)(data %= value.data); }
    inline cf8p16 operator&=(cf8p16 &value) { return (cf8p16 &)(data &= value.data); }
    inline cf8p16 operator|=(cf8p16 &value) { return (cf8p16 &)(data |= value.data); }
@@ -3555,16 +3583,16 @@ struct f12p12 {
 
    inline cf12p12 operator+(cf12p12 &value) const { return (cf12p12 &)(data + value.data); }
    inline cf12p12 operator-(cf12p12 &value) const { return (cf12p12 &)(data - value.data); }
-   inline cf12p12 operator*(cf12p12 &value) const { return toFixed(toFloat() * toFloat(value)); }
-   inline cf12p12 operator/(cf12p12 &value) const { return toFixed(toFloat() / toFloat(value)); }
+   inline cf12p12 operator*(cf12p12 &value) const { return ui24(_fpdt_mulU32(data, value.data, 12)); }
+   inline cf12p12 operator/(cf12p12 &value) const { return ui24(_fpdt_divU32(data, value.data, 12, 0x0FFFFFF)); }
    inline cf12p12 operator%(cf12p12 &value) const { return (cf12p12 &)(data % value.data); }
    inline cf12p12 operator&(cf12p12 &value) const { return (cf12p12 &)(data & value.data); }
    inline cf12p12 operator|(cf12p12 &value) const { return (cf12p12 &)(data | value.data); }
    inline cf12p12 operator^(cf12p12 &value) const { return (cf12p12 &)(data ^ value.data); }
    inline cf12p12 operator+=(cf12p12 &value) { return (cf12p12 &)(data += value.data); }
    inline cf12p12 operator-=(cf12p12 &value) { return (cf12p12 &)(data -= value.data); }
-   inline cf12p12 operator*=(cf12p12 &value) { return data = toFixed(toFloat() * toFloat(value)); }
-   inline cf12p12 operator/=(cf12p12 &value) { return data = toFixed(toFloat() / toFloat(value)); }
+   inline cf12p12 operator*=(cf12p12 &value) { return data = ui24(_fpdt_mulU32(data, value.data, 12)); }
+   inline cf12p12 operator/=(cf12p12 &value) { return data = ui24(_fpdt_divU32(data, value.data, 12, 0x0FFFFFF)); }
    inline cf12p12 operator%=(cf12p12 &value) { return (cf12p12 &)(data %= value.data); }
    inline cf12p12 operator&=(cf12p12 &value) { return (cf12p12 &)(data &= value.data); }
    inline cf12p12 operator|=(cf12p12 &value) { return (cf12p12 &)(data |= value.data); }
@@ -3657,16 +3685,16 @@ struct f16p8 {
 
    inline cf16p8 operator+(cf16p8 &value) const { return (cf16p8 &)(data + value.data); }
    inline cf16p8 operator-(cf16p8 &value) const { return (cf16p8 &)(data - value.data); }
-   inline cf16p8 operator*(cf16p8 &value) const { return toFixed(toFloat() * toFloat(value)); }
-   inline cf16p8 operator/(cf16p8 &value) const { return toFixed(toFloat() / toFloat(value)); }
+   inline cf16p8 operator*(cf16p8 &value) const { return ui24(_fpdt_mulU32(data, value.data, 8)); }
+   inline cf16p8 operator/(cf16p8 &value) const { return ui24(_fpdt_divU32(data, value.data, 8, 0x0FFFFFF)); }
    inline cf16p8 operator%(cf16p8 &value) const { return (cf16p8 &)(data % value.data); }
    inline cf16p8 operator&(cf16p8 &value) const { return (cf16p8 &)(data & value.data); }
    inline cf16p8 operator|(cf16p8 &value) const { return (cf16p8 &)(data | value.data); }
    inline cf16p8 operator^(cf16p8 &value) const { return (cf16p8 &)(data ^ value.data); }
    inline cf16p8 operator+=(cf16p8 &value) { return (cf16p8 &)(data += value.data); }
    inline cf16p8 operator-=(cf16p8 &value) { return (cf16p8 &)(data -= value.data); }
-   inline cf16p8 operator*=(cf16p8 &value) { return data = toFixed(toFloat() * toFloat(value)); }
-   inline cf16p8 operator/=(cf16p8 &value) { return data = toFixed(toFloat() / toFloat(value)); }
+   inline cf16p8 operator*=(cf16p8 &value) { return data = ui24(_fpdt_mulU32(data, value.data, 8)); }
+   inline cf16p8 operator/=(cf16p8 &value) { return data = ui24(_fpdt_divU32(data, value.data, 8, 0x0FFFFFF)); }
    inline cf16p8 operator%=(cf16p8 &value) { return (cf16p8 &)(data %= value.data); }
    inline cf16p8 operator&=(cf16p8 &value) { return (cf16p8 &)(data &= value.data); }
    inline cf16p8 operator|=(cf16p8 &value) { return (cf16p8 &)(data |= value.data); }
@@ -3967,16 +3995,16 @@ struct f0p32 {
 
    inline cf0p32 operator+(cf0p32 &value) const { return (cf0p32 &)(data + value.data); }
    inline cf0p32 operator-(cf0p32 &value) const { return (cf0p32 &)(data - value.data); }
-   inline cf0p32 operator*(cf0p32 &value) const { return toFixed(toFloat() * toFloat(value)); }
-   inline cf0p32 operator/(cf0p32 &value) const { return toFixed(toFloat() / toFloat(value)); }
+   inline cf0p32 operator*(cf0p32 &value) const { return ui32(_fpdt_mulU32(data, value.data, 32)); }
+   inline cf0p32 operator/(cf0p32 &value) const { return ui32(_fpdt_divU32(data, value.data, 32, 0x0FFFFFFFF)); }
    inline cf0p32 operator%(cf0p32 &value) const { return (cf0p32 &)(data % value.data); }
    inline cf0p32 operator&(cf0p32 &value) const { return (cf0p32 &)(data & value.data); }
    inline cf0p32 operator|(cf0p32 &value) const { return (cf0p32 &)(data | value.data); }
    inline cf0p32 operator^(cf0p32 &value) const { return (cf0p32 &)(data ^ value.data); }
    inline cf0p32 operator+=(cf0p32 &value) { return (cf0p32 &)(data += value.data); }
    inline cf0p32 operator-=(cf0p32 &value) { return (cf0p32 &)(data -= value.data); }
-   inline cf0p32 operator*=(cf0p32 &value) { return data = toFixed(toFloat() * toFloat(value)); }
-   inline cf0p32 operator/=(cf0p32 &value) { return data = toFixed(toFloat() / toFloat(value)); }
+   inline cf0p32 operator*=(cf0p32 &value) { return data = ui32(_fpdt_mulU32(data, value.data, 32)); }
+   inline cf0p32 operator/=(cf0p32 &value) { return data = ui32(_fpdt_divU32(data, value.data, 32, 0x0FFFFFFFF)); }
    inline cf0p32 operator%=(cf0p32 &value) { return (cf0p32 &)(data %= value.data); }
    inline cf0p32 operator&=(cf0p32 &value) { return (cf0p32 &)(data &= value.data); }
    inline cf0p32 operator|=(cf0p32 &value) { return (cf0p32 &)(data |= value.data); }
@@ -4071,16 +4099,16 @@ struct f16p16 {
 
    inline cf16p16 operator+(cf16p16 &value) const { return (cf16p16 &)(data + value.data); }
    inline cf16p16 operator-(cf16p16 &value) const { return (cf16p16 &)(data - value.data); }
-   inline cf16p16 operator*(cf16p16 &value) const { return toFixed(toFloat() * toFloat(value)); }
-   inline cf16p16 operator/(cf16p16 &value) const { return toFixed(toFloat() / toFloat(value)); }
+   inline cf16p16 operator*(cf16p16 &value) const { return ui32(_fpdt_mulU32(data, value.data, 16)); }
+   inline cf16p16 operator/(cf16p16 &value) const { return ui32(_fpdt_divU32(data, value.data, 16, 0x0FFFFFFFF)); }
    inline cf16p16 operator%(cf16p16 &value) const { return (cf16p16 &)(data % value.data); }
    inline cf16p16 operator&(cf16p16 &value) const { return (cf16p16 &)(data & value.data); }
    inline cf16p16 operator|(cf16p16 &value) const { return (cf16p16 &)(data | value.data); }
    inline cf16p16 operator^(cf16p16 &value) const { return (cf16p16 &)(data ^ value.data); }
    inline cf16p16 operator+=(cf16p16 &value) { return (cf16p16 &)(data += value.data); }
    inline cf16p16 operator-=(cf16p16 &value) { return (cf16p16 &)(data -= value.data); }
-   inline cf16p16 operator*=(cf16p16 &value) { return data = toFixed(toFloat() * toFloat(value)); }
-   inline cf16p16 operator/=(cf16p16 &value) { return data = toFixed(toFloat() / toFloat(value)); }
+   inline cf16p16 operator*=(cf16p16 &value) { return data = ui32(_fpdt_mulU32(data, value.data, 16)); }
+   inline cf16p16 operator/=(cf16p16 &value) { return data = ui32(_fpdt_divU32(data, value.data, 16, 0x0FFFFFFFF)); }
    inline cf16p16 operator%=(cf16p16 &value) { return (cf16p16 &)(data %= value.data); }
    inline cf16p16 operator&=(cf16p16 &value) { return (cf16p16 &)(data &= value.data); }
    inline cf16p16 operator|=(cf16p16 &value) { return (cf16p16 &)(data |= value.data); }
@@ -4224,8 +4252,8 @@ struct fp32n_1_1 {
    ui32 data;
 
    inline cui32 toFixed(cfl64 &value) const { return ui32((value + 1.0) * 2147483647.5); }
-   inline cfl64 toFloat(void) const { return cfl64(data) * _fpdt_2div2p32_1; }
-   inline cfl64 toFloat(cfp32n_1_1 &value) const { return fl64(value.data) * _fpdt_2div2p32_1; }
+   inline cfl64 toFloat(void) const { return cfl64(data) * _fpdt_2div2p32_1 - 1.0; }
+   inline cfl64 toFloat(cfp32n_1_1 &value) const { return fl64(value.data) * _fpdt_2div2p32_1 - 1.0; }
 
    fp32n_1_1(void) = default;
 #ifndef FPDT_NO_CUSTOM
@@ -4242,7 +4270,7 @@ struct fp32n_1_1 {
    fp32n_1_1(cfl64 value) { data = toFixed(value); }
 
    operator ptr(void) const { return *this; }
-   operator cfl64(void) const { return cfl64(data) * _fpdt_2div2p32_1; }
+   operator cfl64(void) const { return cfl64(data) * _fpdt_2div2p32_1 - 1.0; }
 
    inline cfp32n_1_1 &operator&(void) const { return *this; }
    inline cfp32n_1_1 operator~(void) const { return (cfp32n_1_1 &)~data; }
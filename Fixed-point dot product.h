@@ -0,0 +1,347 @@
+/**********************************************************************
+ * File: Fixed-point dot product.h                Created: 2024/07/14 *
+ *                                          Last modified: 2024/07/26 *
+ *                                                                    *
+ * Desc: Dot products of fp8n0_1, fs7p8, & fs1p14 arrays, computed on *
+ *       their raw codes with integer multiply-adds, then converted   *
+ *       to a float once, rather than decoding every element, &       *
+ *       multiply-adds of those arrays by a float into float arrays.  *
+ *                                                                    *
+ * Notes: 8-bit codes are zero-extended & multiplied with madd_epi16, *
+ *        or with vpdpbusd when AVX512-VNNI is present; maddubs is    *
+ *        not used, as it treats one operand as signed & saturates.   *
+ *        Products are summed in 32-bit lanes, which are widened to   *
+ *        64 bits every 65536 elements, so sums are exact.            *
+ *        16-bit codes are multiplied with madd_epi16; as one pair of *
+ *        full-range products fills 32 bits, the pair sums are        *
+ *        widened to 64 bits as they are accumulated.                 *
+ *        The result is exact until it is rounded to a 64-bit float.  *
+ *        Multiply-adds decode each code once, scaled by the float in *
+ *        place of the code's unit; they match decoding, multiplying, *
+ *        & adding with floats for fs7p8 & fs1p14, whose units are    *
+ *        powers of 2, & are within a rounding of it for fp8n0_1.     *
+ *                                                                    *
+ * MIT license.                     Copyright (c) David William Bull. *
+ **********************************************************************/
+#pragma once
+
+#include "Fixed-point data types.h"
+#include "Fixed-point CPU dispatch.h"
+
+#define _FIXED_POINT_DOT_PRODUCT_
+
+/*************
+ *  Kernels  *
+ *************/
+
+// Each 8-bit kernel returns the sum of a[i] * b[i] over count unsigned codes; each 16-bit kernel does so for codes of excess 32768
+
+// Elements per block of 8-bit products summed in 32-bit lanes; no lane sums more than 16384 products of 255 * 255, which fits in 31 bits
+#define _FPDT_DOT8_BLOCK_ 65536
+
+// Sum of two 64-bit lanes
+static inline csi64 _fpdt_hsum64(csi128 sums) { return _mm_cvtsi128_si64(_mm_add_epi64(sums, _mm_unpackhi_epi64(sums, sums))); }
+
+// Sum of four unsigned 32-bit lanes
+static inline cui64 _fpdt_hsum32(csi128 sums) {
+   csi128 zero = _mm_setzero_si128();
+
+   return ui64(_fpdt_hsum64(_mm_add_epi64(_mm_unpacklo_epi32(sums, zero), _mm_unpackhi_epi32(sums, zero))));
+}
+
+static inline cui64 _fpdt_dot8SSE(cui8 *a, cui8 *b, csize_t count) {
+   csi128 zero = _mm_setzero_si128();
+   ui64 sum = 0;
+   size_t i = 0;
+
+   while (count - i >= 16) {
+      csize_t end = count - i > _FPDT_DOT8_BLOCK_ ? i + _FPDT_DOT8_BLOCK_ : count & ~size_t(15);
+      si128 acc = zero;
+
+      for (; i < end; i += 16) {
+         csi128 x = _mm_loadu_si128((csi128 *)&a[i]), y = _mm_loadu_si128((csi128 *)&b[i]);
+
+         acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_unpacklo_epi8(x, zero), _mm_unpacklo_epi8(y, zero)));
+         acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_unpackhi_epi8(x, zero), _mm_unpackhi_epi8(y, zero)));
+      }
+      sum += _fpdt_hsum32(acc);
+   }
+   for (; i < count; i++) sum += ui32(a[i]) * ui32(b[i]);
+   return sum;
+}
+
+static inline csi64 _fpdt_dot16SSE(cui16 *a, cui16 *b, csize_t count) {
+   csi128 flip = _mm_set1_epi16(-32768), bias = _mm_set1_epi32(65536);
+   si128 accA = _mm_setzero_si128(), accB = accA;
+   size_t i = 0;
+
+   // A pair sum is 2^31 when all four codes are the lowest, so 65536 is taken off each to fit 32 bits, then added back
+   for (; i + 8 <= count; i += 8) {
+      csi128 x = _mm_xor_si128(_mm_loadu_si128((csi128 *)&a[i]), flip), y = _mm_xor_si128(_mm_loadu_si128((csi128 *)&b[i]), flip);
+      csi128 pairs = _mm_sub_epi32(_mm_madd_epi16(x, y), bias);
+
+      accA = _mm_add_epi64(accA, _mm_cvtepi32_epi64(pairs));
+      accB = _mm_add_epi64(accB, _mm_cvtepi32_epi64(_mm_unpackhi_epi64(pairs, pairs)));
+   }
+
+   si64 sum = _fpdt_hsum64(_mm_add_epi64(accA, accB)) + si64(i / 2) * 65536;
+
+   for (; i < count; i++) sum += si64(si16(a[i] ^ 0x8000)) * si16(b[i] ^ 0x8000);
+   return sum;
+}
+
+// Each multiply-add kernel adds code * scale to dest[i] over count unsigned 8-bit codes, or 16-bit codes of excess 32768;
+// products & sums are rounded separately on every instruction set, so all give the same results
+
+// Adds four 32-bit codes times scale to dest
+static inline void _fpdt_mac4(fl32 *dest, csi128 codes, cfl32x4 scale) { _mm_storeu_ps(dest, _mm_add_ps(_mm_loadu_ps(dest), _mm_mul_ps(_mm_cvtepi32_ps(codes), scale))); }
+
+static inline void _fpdt_mac8SSE(fl32 *dest, cui8 *a, cfl32 scale, csize_t count) {
+   cfl32x4 s = _mm_set1_ps(scale);
+   size_t i = 0;
+
+   for (; i + 16 <= count; i += 16) {
+      csi128 x = _mm_loadu_si128((csi128 *)&a[i]);
+
+      _fpdt_mac4(&dest[i], _mm_cvtepu8_epi32(x), s);
+      _fpdt_mac4(&dest[i + 4], _mm_cvtepu8_epi32(_mm_srli_si128(x, 4)), s);
+      _fpdt_mac4(&dest[i + 8], _mm_cvtepu8_epi32(_mm_srli_si128(x, 8)), s);
+      _fpdt_mac4(&dest[i + 12], _mm_cvtepu8_epi32(_mm_srli_si128(x, 12)), s);
+   }
+   for (; i < count; i++) dest[i] += fl32(a[i]) * scale;
+}
+
+static inline void _fpdt_mac16SSE(fl32 *dest, cui16 *a, cfl32 scale, csize_t count) {
+   csi128 flip = _mm_set1_epi16(-32768);
+   cfl32x4 s = _mm_set1_ps(scale);
+   size_t i = 0;
+
+   for (; i + 8 <= count; i += 8) {
+      csi128 x = _mm_xor_si128(_mm_loadu_si128((csi128 *)&a[i]), flip);
+
+      _fpdt_mac4(&dest[i], _mm_cvtepi16_epi32(x), s);
+      _fpdt_mac4(&dest[i + 4], _mm_cvtepi16_epi32(_mm_srli_si128(x, 8)), s);
+   }
+   for (; i < count; i++) dest[i] += fl32(si16(a[i] ^ 0x8000)) * scale;
+}
+
+#ifdef _FPDT_KERNELS_AVX2_
+static inline _FPDT_TARGET_AVX2_ cui64 _fpdt_dot8AVX2(cui8 *a, cui8 *b, csize_t count) {
+   ui64 sum = 0;
+   size_t i = 0;
+
+   while (count - i >= 32) {
+      csize_t end = count - i > _FPDT_DOT8_BLOCK_ ? i + _FPDT_DOT8_BLOCK_ : count & ~size_t(31);
+      si256 acc = _mm256_setzero_si256();
+
+      for (; i < end; i += 32) {
+         csi256 xA = _mm256_cvtepu8_epi16(_mm_loadu_si128((csi128 *)&a[i])), yA = _mm256_cvtepu8_epi16(_mm_loadu_si128((csi128 *)&b[i]));
+         csi256 xB = _mm256_cvtepu8_epi16(_mm_loadu_si128((csi128 *)&a[i + 16])), yB = _mm256_cvtepu8_epi16(_mm_loadu_si128((csi128 *)&b[i + 16]));
+
+         acc = _mm256_add_epi32(acc, _mm256_madd_epi16(xA, yA));
+         acc = _mm256_add_epi32(acc, _mm256_madd_epi16(xB, yB));
+      }
+      sum += _fpdt_hsum32(_mm256_castsi256_si128(acc)) + _fpdt_hsum32(_mm256_extracti128_si256(acc, 1));
+   }
+   return sum + _fpdt_dot8SSE(&a[i], &b[i], count - i);
+}
+
+static inline _FPDT_TARGET_AVX2_ csi64 _fpdt_dot16AVX2(cui16 *a, cui16 *b, csize_t count) {
+   csi256 flip = _mm256_set1_epi16(-32768), bias = _mm256_set1_epi32(65536);
+   si256 accA = _mm256_setzero_si256(), accB = accA;
+   size_t i = 0;
+
+   for (; i + 16 <= count; i += 16) {
+      csi256 x = _mm256_xor_si256(_mm256_loadu_si256((csi256 *)&a[i]), flip), y = _mm256_xor_si256(_mm256_loadu_si256((csi256 *)&b[i]), flip);
+      csi256 pairs = _mm256_sub_epi32(_mm256_madd_epi16(x, y), bias);
+
+      accA = _mm256_add_epi64(accA, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(pairs)));
+      accB = _mm256_add_epi64(accB, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(pairs, 1)));
+   }
+   accA = _mm256_add_epi64(accA, accB);
+
+   return _fpdt_hsum64(_mm_add_epi64(_mm256_castsi256_si128(accA), _mm256_extracti128_si256(accA, 1))) + si64(i / 2) * 65536 + _fpdt_dot16SSE(&a[i], &b[i], count - i);
+}
+
+static inline _FPDT_TARGET_AVX2_ void _fpdt_mac8AVX2(fl32 *dest, cui8 *a, cfl32 scale, csize_t count) {
+   cfl32x8 s = _mm256_set1_ps(scale);
+   size_t i = 0;
+
+   for (; i + 16 <= count; i += 16) {
+      csi128 x = _mm_loadu_si128((csi128 *)&a[i]);
+
+      _mm256_storeu_ps(&dest[i], _mm256_add_ps(_mm256_loadu_ps(&dest[i]), _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(x)), s)));
+      _mm256_storeu_ps(&dest[i + 8], _mm256_add_ps(_mm256_loadu_ps(&dest[i + 8]), _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_unpackhi_epi64(x, x))), s)));
+   }
+   _fpdt_mac8SSE(&dest[i], &a[i], scale, count - i);
+}
+
+static inline _FPDT_TARGET_AVX2_ void _fpdt_mac16AVX2(fl32 *dest, cui16 *a, cfl32 scale, csize_t count) {
+   csi128 flip = _mm_set1_epi16(-32768);
+   cfl32x8 s = _mm256_set1_ps(scale);
+   size_t i = 0;
+
+   for (; i + 8 <= count; i += 8) {
+      csi256 x = _mm256_cvtepi16_epi32(_mm_xor_si128(_mm_loadu_si128((csi128 *)&a[i]), flip));
+
+      _mm256_storeu_ps(&dest[i], _mm256_add_ps(_mm256_loadu_ps(&dest[i]), _mm256_mul_ps(_mm256_cvtepi32_ps(x), s)));
+   }
+   _fpdt_mac16SSE(&dest[i], &a[i], scale, count - i);
+}
+#endif
+
+#ifdef _FPDT_KERNELS_AVX512_
+// Sum of sixteen 32-bit lanes, sign-extended
+static inline _FPDT_TARGET_AVX512_ csi64 _fpdt_hsum32x16(csi512 sums) { return _mm512_reduce_add_epi64(_mm512_add_epi64(_mm512_cvtepi32_epi64(_mm512_castsi512_si256(sums)), _mm512_cvtepi32_epi64(_mm512_extracti64x4_epi64(sums, 1)))); }
+
+static inline _FPDT_TARGET_AVX512_ cui64 _fpdt_dot8AVX512(cui8 *a, cui8 *b, csize_t count) {
+   ui64 sum = 0;
+   size_t i = 0;
+
+   while (i < count) {
+      csize_t end = count - i > _FPDT_DOT8_BLOCK_ ? i + _FPDT_DOT8_BLOCK_ : count;
+      si512 acc = _mm512_setzero_si512();
+
+      // Masked-off codes load as 0, so add nothing
+      for (; i < end; i += 32) {
+         const __mmask32 mask = end - i < 32 ? __mmask32((1u << (end - i)) - 1u) : __mmask32(0x0FFFFFFFF);
+         csi512 x = _mm512_cvtepu8_epi16(_mm256_maskz_loadu_epi8(mask, &a[i])), y = _mm512_cvtepu8_epi16(_mm256_maskz_loadu_epi8(mask, &b[i]));
+
+         acc = _mm512_add_epi32(acc, _mm512_madd_epi16(x, y));
+      }
+      sum += ui64(_fpdt_hsum32x16(acc));
+   }
+   return sum;
+}
+
+static inline _FPDT_TARGET_AVX512_ csi64 _fpdt_dot16AVX512(cui16 *a, cui16 *b, csize_t count) {
+   csi512 flip = _mm512_set1_epi16(-32768), bias = _mm512_set1_epi32(65536);
+   si512 accA = _mm512_setzero_si512(), accB = accA;
+   size_t i = 0;
+
+   // Masked-off codes of b are zeroed after the flip, so their products are 0, & the bias is added back for every lane
+   for (; i < count; i += 32) {
+      const __mmask32 mask = count - i < 32 ? __mmask32((1u << (count - i)) - 1u) : __mmask32(0x0FFFFFFFF);
+      csi512 x = _mm512_xor_si512(_mm512_maskz_loadu_epi16(mask, &a[i]), flip);
+      csi512 y = _mm512_maskz_mov_epi16(mask, _mm512_xor_si512(_mm512_maskz_loadu_epi16(mask, &b[i]), flip));
+      csi512 pairs = _mm512_sub_epi32(_mm512_madd_epi16(x, y), bias);
+
+      accA = _mm512_add_epi64(accA, _mm512_cvtepi32_epi64(_mm512_castsi512_si256(pairs)));
+      accB = _mm512_add_epi64(accB, _mm512_cvtepi32_epi64(_mm512_extracti64x4_epi64(pairs, 1)));
+   }
+   return _mm512_reduce_add_epi64(_mm512_add_epi64(accA, accB)) + si64(i / 2) * 65536;
+}
+
+// Masked-off elements of dest are neither read nor written
+static inline _FPDT_TARGET_AVX512_ void _fpdt_mac8AVX512(fl32 *dest, cui8 *a, cfl32 scale, csize_t count) {
+   cfl32x16 s = _mm512_set1_ps(scale);
+
+   for (size_t i = 0; i < count; i += 16) {
+      const __mmask16 mask = count - i < 16 ? __mmask16((1u << (count - i)) - 1u) : __mmask16(0x0FFFF);
+      cfl32x16 x = _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(_mm_maskz_loadu_epi8(mask, &a[i])));
+
+      _mm512_mask_storeu_ps(&dest[i], mask, _mm512_add_ps(_mm512_maskz_loadu_ps(mask, &dest[i]), _mm512_mul_ps(x, s)));
+   }
+}
+
+static inline _FPDT_TARGET_AVX512_ void _fpdt_mac16AVX512(fl32 *dest, cui16 *a, cfl32 scale, csize_t count) {
+   csi256 flip = _mm256_set1_epi16(-32768);
+   cfl32x16 s = _mm512_set1_ps(scale);
+
+   for (size_t i = 0; i < count; i += 16) {
+      const __mmask16 mask = count - i < 16 ? __mmask16((1u << (count - i)) - 1u) : __mmask16(0x0FFFF);
+      cfl32x16 x = _mm512_cvtepi32_ps(_mm512_cvtepi16_epi32(_mm256_xor_si256(_mm256_maskz_loadu_epi16(mask, &a[i]), flip)));
+
+      _mm512_mask_storeu_ps(&dest[i], mask, _mm512_add_ps(_mm512_maskz_loadu_ps(mask, &dest[i]), _mm512_mul_ps(x, s)));
+   }
+}
+#endif
+
+#ifdef _FPDT_KERNELS_VNNI_
+// vpdpbusd multiplies unsigned by signed bytes, so b is taken as b - 128, & 128 * the sum of a is added back
+static inline cui64 _fpdt_dot8VNNI(cui8 *a, cui8 *b, csize_t count) {
+   csi512 flip = _mm512_set1_epi8(-128), zero = _mm512_setzero_si512();
+   si512 sumA = zero;
+   si64 sum = 0;
+   size_t i = 0;
+
+   while (i < count) {
+      csize_t end = count - i > _FPDT_DOT8_BLOCK_ ? i + _FPDT_DOT8_BLOCK_ : count;
+      si512 acc = zero;
+
+      for (; i < end; i += 64) {
+         const __mmask64 mask = end - i < 64 ? __mmask64((1ull << (end - i)) - 1ull) : __mmask64(~0ull);
+         csi512 x = _mm512_maskz_loadu_epi8(mask, &a[i]), y = _mm512_xor_si512(_mm512_maskz_loadu_epi8(mask, &b[i]), flip);
+
+         acc = _mm512_dpbusd_epi32(acc, x, y);
+         sumA = _mm512_add_epi64(sumA, _mm512_sad_epu8(x, zero));
+      }
+      sum += _fpdt_hsum32x16(acc);
+   }
+   return ui64(sum + _mm512_reduce_add_epi64(sumA) * 128);
+}
+#endif
+
+/*
+ *  Kernel tables, indexed by fpdtISA()
+ */
+
+static decltype(&_fpdt_dot8SSE) const _fpdt_dot8ISA[] = _FPDT_KERNELS_(_fpdt_dot8);
+static decltype(&_fpdt_dot16SSE) const _fpdt_dot16ISA[] = _FPDT_KERNELS_(_fpdt_dot16);
+static decltype(&_fpdt_mac8SSE) const _fpdt_mac8ISA[] = _FPDT_KERNELS_(_fpdt_mac8);
+static decltype(&_fpdt_mac16SSE) const _fpdt_mac16ISA[] = _FPDT_KERNELS_(_fpdt_mac16);
+
+// The 8-bit kernel of the current instruction set, or the VNNI kernel in place of AVX512 when the host has it
+static inline decltype(&_fpdt_dot8SSE) _fpdt_dot8Kernel(void) {
+   cui32 isa = fpdtISA();
+
+#ifdef _FPDT_KERNELS_VNNI_
+   if (isa == FPDT_ISA_AVX512 && (fpdtCPUFeatures() & FPDT_CPU_VNNI)) return _fpdt_dot8VNNI;
+#endif
+   return _fpdt_dot8ISA[isa];
+}
+
+static inline cui64 _fpdt_dot8(cui8 *a, cui8 *b, csize_t count) { return _fpdt_dot8Kernel()(a, b, count); }
+static inline csi64 _fpdt_dot16(cui16 *a, cui16 *b, csize_t count) { return _fpdt_dot16ISA[fpdtISA()](a, b, count); }
+
+/******************
+ *  Dot products  *
+ ******************/
+
+// Decimal value of one unit of each type's summed code products
+static cfl64 _fpdt_dotUnit8n0_1 = 1.0 / 65025.0;
+static cfl64 _fpdt_dotUnit7p8   = 1.0 / 65536.0;
+static cfl64 _fpdt_dotUnit1p14  = 1.0 / 268435456.0;
+
+// Sum of a[i] * b[i] over count elements
+inline cfl64 fpdtDot(const fp8n0_1 *a, const fp8n0_1 *b, csize_t count) { return fl64(_fpdt_dot8((cui8 *)a, (cui8 *)b, count)) * _fpdt_dotUnit8n0_1; }
+inline cfl64 fpdtDot(const fs7p8 *a, const fs7p8 *b, csize_t count) { return fl64(_fpdt_dot16((cui16 *)a, (cui16 *)b, count)) * _fpdt_dotUnit7p8; }
+inline cfl64 fpdtDot(const fs1p14 *a, const fs1p14 *b, csize_t count) { return fl64(_fpdt_dot16((cui16 *)a, (cui16 *)b, count)) * _fpdt_dotUnit1p14; }
+
+// dest[r] = dot product of row r with vector, for rowCount rows of count elements stored one after another
+inline void fpdtDot(fl32 *dest, const fp8n0_1 *rows, const fp8n0_1 *vector, csize_t rowCount, csize_t count) {
+   const auto kernel = _fpdt_dot8Kernel();
+
+   for (size_t r = 0; r < rowCount; r++) dest[r] = fl32(fl64(kernel((cui8 *)(rows + r * count), (cui8 *)vector, count)) * _fpdt_dotUnit8n0_1);
+}
+
+inline void fpdtDot(fl32 *dest, const fs7p8 *rows, const fs7p8 *vector, csize_t rowCount, csize_t count) {
+   const auto kernel = _fpdt_dot16ISA[fpdtISA()];
+
+   for (size_t r = 0; r < rowCount; r++) dest[r] = fl32(fl64(kernel((cui16 *)(rows + r * count), (cui16 *)vector, count)) * _fpdt_dotUnit7p8);
+}
+
+inline void fpdtDot(fl32 *dest, const fs1p14 *rows, const fs1p14 *vector, csize_t rowCount, csize_t count) {
+   const auto kernel = _fpdt_dot16ISA[fpdtISA()];
+
+   for (size_t r = 0; r < rowCount; r++) dest[r] = fl32(fl64(kernel((cui16 *)(rows + r * count), (cui16 *)vector, count)) * _fpdt_dotUnit1p14);
+}
+
+/*******************
+ *  Multiply-adds  *
+ *******************/
+
+// dest[i] += a[i] * b over count elements
+inline void fpdtMac(fl32 *dest, const fp8n0_1 *a, cfl32 b, csize_t count) { _fpdt_mac8ISA[fpdtISA()](dest, (cui8 *)a, fl32(fl64(b) / 255.0), count); }
+inline void fpdtMac(fl32 *dest, const fs7p8 *a, cfl32 b, csize_t count) { _fpdt_mac16ISA[fpdtISA()](dest, (cui16 *)a, b * 0.00390625f, count); }
+inline void fpdtMac(fl32 *dest, const fs1p14 *a, cfl32 b, csize_t count) { _fpdt_mac16ISA[fpdtISA()](dest, (cui16 *)a, b * 0.00006103515625f, count); }
@@ -1,6 +1,6 @@
 /************************************************************
  * File: Fixed-point math.h             Created: 2023/06/25 *
- *                                    Last mod.: 2023/07/06 *
+ *                                    Last mod.: 2024/07/17 *
  *                                                          *
  * Desc:                                                    *
  *                                                          *
@@ -144,7 +144,11 @@ inline cVEC4Du16 Fix16x4(cVEC4Df floats, cfl32 floor, cfl32 range) {
  *  Fixed range conversion functions
  */
 
-
+// Convert packed fixed-point colour values (R8G9B7A8) to 4 32-bit floats (range 0.0~1.0)
+inline cVEC4Df Float8978(cui32 packed) {
+   return { fl32(packed & 0x0FF) * (1.0f / 255.0f), fl32((packed >> 8) & 0x01FF) * (1.0f / 511.0f),
+            fl32((packed >> 17) & 0x07F) * (1.0f / 127.0f), fl32(packed >> 24) * (1.0f / 255.0f) };
+}
 
 /*
  *  Scalable range conversion functions
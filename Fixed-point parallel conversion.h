@@ -0,0 +1,219 @@
+/**********************************************************************
+ * File: Fixed-point parallel conversion.h        Created: 2024/07/25 *
+ *                                          Last modified: 2024/07/26 *
+ *                                                                    *
+ * Desc: Multithreaded forms of fpdtToFixed(), fpdtToFloat(), &       *
+ *       fpdtCalibrate(), for buffers far larger than the caches:     *
+ *       fpdtToFixedMT(), fpdtToFloatMT(), & fpdtCalibrateMT() take   *
+ *       the same arguments, & split the work into cache-sized        *
+ *       chunks that LoopMT() spreads across cores.                   *
+ *                                                                    *
+ * Notes: Results are the same as those of the serial functions,      *
+ *        except when rounding stochastically; each chunk then        *
+ *        draws from its own generator, seeded from that of the       *
+ *        calling thread & the chunk's first element. Chunks start at *
+ *        fixed multiples of their size, so results are reproducible  *
+ *        after fpdtSeed(), whatever the number of threads.           *
+ *        When the output is larger than the last-level cache, each   *
+ *        chunk is converted into a buffer in L1, then copied out     *
+ *        with non-temporal stores, which write memory without first  *
+ *        reading it, & without evicting the input from the caches.   *
+ *        Types with a user-definable range use the range of the      *
+ *        calling thread, or an explicit fpdtRange context.           *
+ *                                                                    *
+ * MIT license.                     Copyright (c) David William Bull. *
+ **********************************************************************/
+#pragma once
+
+#include <cstring>
+#include <mutex>
+#include "Fixed-point bulk conversion.h"
+#include "Parallel loops.h"
+
+#define _FIXED_POINT_PARALLEL_CONVERSION_
+
+#define _FPDT_MT_CHUNK_ 16384 // Bytes of output per chunk; its input & output fit L1 with room to spare
+
+/*************
+ *  Helpers  *
+ *************/
+
+// Floats per element of each vector type; 1 for scalar types
+template<typename T> struct _fpdt_mtLanes { static constexpr size_t lanes = 1; };
+
+#define _FPDT_MT_LANES_(name, count) template<> struct _fpdt_mtLanes<name> { static constexpr size_t lanes = count; };
+
+_FPDT_MT_LANES_(fp8nx4, 4)
+_FPDT_MT_LANES_(fp16nx4, 4)
+_FPDT_MT_LANES_(fp8n0_1x4, 4)
+_FPDT_MT_LANES_(fs7p8x3, 3)
+_FPDT_MT_LANES_(f1p15x4, 4)
+_FPDT_MT_LANES_(fp16n0_1x4, 4)
+_FPDT_MT_LANES_(fp16n0_3x16, 16)
+
+// Copies bytes with non-temporal stores, 16-byte aligned; the unaligned ends are copied normally
+static inline void _fpdt_stream(ptr dest, cptr src, size_t bytes) {
+   ui8    *to = (ui8 *)dest;
+   cui8   *from = (cui8 *)src;
+   size_t  head = (16 - (size_t(to) & 15)) & 15;
+
+   if (head > bytes) head = bytes;
+   memcpy(to, from, head);
+   to += head, from += head, bytes -= head;
+   for (; bytes >= 64; to += 64, from += 64, bytes -= 64) {
+      _mm_stream_si128((si128 *)to, _mm_loadu_si128((csi128 *)from));
+      _mm_stream_si128((si128 *)(to + 16), _mm_loadu_si128((csi128 *)(from + 16)));
+      _mm_stream_si128((si128 *)(to + 32), _mm_loadu_si128((csi128 *)(from + 32)));
+      _mm_stream_si128((si128 *)(to + 48), _mm_loadu_si128((csi128 *)(from + 48)));
+   }
+   for (; bytes >= 16; to += 16, from += 16, bytes -= 16) _mm_stream_si128((si128 *)to, _mm_loadu_si128((csi128 *)from));
+   memcpy(to, from, bytes);
+}
+
+// Calls convert(to, first, last) for chunks of count elements on every core, where to is dest + first * perElement;
+// when the output would overflow the last-level cache, to is instead a buffer in L1, which is then streamed there.
+// Chunks are cut at fixed multiples of the grain, whatever the thread count, so that stochastic seeds are too
+template<typename D, typename Convert> static inline void _fpdt_convertMT(D *dest, csize_t count, csize_t perElement, Convert convert) {
+   csize_t outBytes = perElement * sizeof(D);
+   csize_t grain = _FPDT_MT_CHUNK_ / outBytes;
+   csize_t chunks = (count + grain - 1) / grain;
+
+   if (count * outBytes > fpdtCacheSize()) {
+      LoopMT(0, chunks, [&](csize_t index) {
+         al64 ui8 stage[_FPDT_MT_CHUNK_];
+         csize_t first = index * grain, last = count - first < grain ? count : first + grain;
+
+         convert((D *)stage, first, last);
+         _fpdt_stream(dest + first * perElement, stage, (last - first) * outBytes);
+         _mm_sfence(); // Non-temporal stores are weakly ordered; complete them before the loop returns
+      }, 1);
+   } else LoopMT(0, chunks, [&](csize_t index) {
+      csize_t first = index * grain, last = count - first < grain ? count : first + grain;
+
+      convert(dest + first * perElement, first, last);
+   }, 1);
+}
+
+// Seeds the generator of the thread that encodes a chunk, from the seed of the calling thread & the chunk's first element
+static inline void _fpdt_seedChunk(cui32 seed, csize_t first) {
+   ui32 state = seed ^ ui32(first * 0x09E3779B9u);
+
+   _fpdt_xorshift(state);
+   fpdtSeed(state ^ ui32(ui64(first) >> 32));
+}
+
+/*********************************************
+ *  Floating-point to fixed-point functions  *
+ *********************************************/
+
+// Encodes count elements, as fpdtToFixed(dest, src, count, range, round)
+template<typename T, typename F> inline void fpdtToFixedMT(T *dest, const F *src, csize_t count, const fpdtRange &range, cui32 round = FPDT_ROUND_TRUNCATE) {
+   cui32 seed = __fpdt_seed__;
+
+   _fpdt_convertMT((ui8 *)dest, count, sizeof(T), [&](ui8 *to, csize_t first, csize_t last) {
+      if (round == FPDT_ROUND_STOCHASTIC) _fpdt_seedChunk(seed, first);
+      fpdtToFixed((T *)to, src + first * _fpdt_mtLanes<T>::lanes, last - first, range, round);
+   });
+   if (round == FPDT_ROUND_STOCHASTIC) _fpdt_seedChunk(seed, count);
+}
+
+// Encodes count elements, as fpdtToFixed(dest, src, count, round)
+template<typename T, typename F> inline void fpdtToFixedMT(T *dest, const F *src, csize_t count, cui32 round = FPDT_ROUND_TRUNCATE) {
+   // Workers may have their own range contexts, so pass on that of this thread
+   if constexpr (requires { fpdtToFixed(dest, src, count, __fpdt_data__, round); }) fpdtToFixedMT(dest, src, count, __fpdt_data__, round);
+   else {
+      cui32 seed = __fpdt_seed__;
+
+      _fpdt_convertMT((ui8 *)dest, count, sizeof(T), [&](ui8 *to, csize_t first, csize_t last) {
+         if (round == FPDT_ROUND_STOCHASTIC) _fpdt_seedChunk(seed, first);
+         fpdtToFixed((T *)to, src + first * _fpdt_mtLanes<T>::lanes, last - first, round);
+      });
+      if (round == FPDT_ROUND_STOCHASTIC) _fpdt_seedChunk(seed, count);
+   }
+}
+
+/*********************************************
+ *  Fixed-point to floating-point functions  *
+ *********************************************/
+
+// Decodes count elements, as fpdtToFloat(dest, src, count, range)
+template<typename F, typename T> inline void fpdtToFloatMT(F *dest, const T *src, csize_t count, const fpdtRange &range) {
+   _fpdt_convertMT(dest, count, _fpdt_mtLanes<T>::lanes, [&](F *to, csize_t first, csize_t last) { fpdtToFloat(to, src + first, last - first, range); });
+}
+
+// Decodes count elements, as fpdtToFloat(dest, src, count)
+template<typename F, typename T> inline void fpdtToFloatMT(F *dest, const T *src, csize_t count) {
+   if constexpr (requires { fpdtToFloat(dest, src, count, __fpdt_data__); }) fpdtToFloatMT(dest, src, count, __fpdt_data__);
+   else _fpdt_convertMT(dest, count, _fpdt_mtLanes<T>::lanes, [&](F *to, csize_t first, csize_t last) { fpdtToFloat(to, src + first, last - first); });
+}
+
+/***********************
+ *  Range calibration  *
+ ***********************/
+
+#ifndef FPDT_NO_CUSTOM
+// Min & max of count floats, from the min & max of each chunk on every core; NaNs are skipped
+template<typename F> static inline void _fpdt_minMaxMT(const F *src, csize_t count, F &lo, F &hi) {
+   std::mutex merge;
+
+   LoopMT(0, count, [&](csize_t first, csize_t last) {
+      // Each chunk starts from the largest magnitudes, so that lo & hi are only read & written under the lock
+      F chunkLo = sizeof(F) == 4 ? F(3.402823466e+38f) : F(1.7976931348623157e+308), chunkHi = -chunkLo;
+
+      if constexpr (sizeof(F) == 4) _fpdt_minMax32(src + first, last - first, chunkLo, chunkHi);
+      else _fpdt_minMax64(src + first, last - first, chunkLo, chunkHi);
+
+      std::lock_guard<std::mutex> lock(merge);
+
+      if (chunkLo < lo) lo = chunkLo;
+      if (chunkHi > hi) hi = chunkHi;
+   }, _FPDT_MT_CHUNK_ * 4 / sizeof(F));
+}
+
+// Each function finds the range of src on every core, stores it in range, & encodes src with it on every core, as
+// fpdtCalibrate(dest, src, count, range, round); without a range, the current one is set
+inline void fpdtCalibrateMT(fp8n *dest, cfl32 *src, csize_t count, fpdtRange &range, cui32 round = FPDT_ROUND_TRUNCATE) {
+   fl32 floor = 3.402823466e+38f, ceiling = -3.402823466e+38f;
+
+   _fpdt_minMaxMT(src, count, floor, ceiling);
+   _fpdt_settle32(floor, ceiling);
+   range.setRange8(floor, ceiling);
+   range.maxDivRange8 = _fpdt_fitScale(floor, ceiling, 255.0f);
+   fpdtToFixedMT(dest, src, count, range, round);
+}
+inline void fpdtCalibrateMT(fp8n *dest, cfl32 *src, csize_t count, cui32 round = FPDT_ROUND_TRUNCATE) { fpdtCalibrateMT(dest, src, count, __fpdt_data__, round); }
+
+inline void fpdtCalibrateMT(fp16n *dest, cfl32 *src, csize_t count, fpdtRange &range, cui32 round = FPDT_ROUND_TRUNCATE) {
+   fl32 floor = 3.402823466e+38f, ceiling = -3.402823466e+38f;
+
+   _fpdt_minMaxMT(src, count, floor, ceiling);
+   _fpdt_settle32(floor, ceiling);
+   range.setRange16(floor, ceiling);
+   range.maxDivRange16 = _fpdt_fitScale(floor, ceiling, 65535.0f);
+   fpdtToFixedMT(dest, src, count, range, round);
+}
+inline void fpdtCalibrateMT(fp16n *dest, cfl32 *src, csize_t count, cui32 round = FPDT_ROUND_TRUNCATE) { fpdtCalibrateMT(dest, src, count, __fpdt_data__, round); }
+
+#ifdef _24BIT_INTEGERS_
+inline void fpdtCalibrateMT(fp24n *dest, cfl32 *src, csize_t count, fpdtRange &range, cui32 round = FPDT_ROUND_TRUNCATE) {
+   fl32 floor = 3.402823466e+38f, ceiling = -3.402823466e+38f;
+
+   _fpdt_minMaxMT(src, count, floor, ceiling);
+   _fpdt_settle32(floor, ceiling);
+   range.setRange24(floor, ceiling);
+   range.maxDivRange24 = _fpdt_fitScale(floor, ceiling, 16777215.0f);
+   fpdtToFixedMT(dest, src, count, range, round);
+}
+inline void fpdtCalibrateMT(fp24n *dest, cfl32 *src, csize_t count, cui32 round = FPDT_ROUND_TRUNCATE) { fpdtCalibrateMT(dest, src, count, __fpdt_data__, round); }
+#endif
+
+inline void fpdtCalibrateMT(fp32n *dest, cfl64 *src, csize_t count, fpdtRange &range, cui32 round = FPDT_ROUND_TRUNCATE) {
+   fl64 floor = 1.7976931348623157e+308, ceiling = -1.7976931348623157e+308;
+
+   _fpdt_minMaxMT(src, count, floor, ceiling);
+   _fpdt_settle64(floor, ceiling);
+   range.setRange32(floor, ceiling);
+   fpdtToFixedMT(dest, src, count, range, round);
+}
+inline void fpdtCalibrateMT(fp32n *dest, cfl64 *src, csize_t count, cui32 round = FPDT_ROUND_TRUNCATE) { fpdtCalibrateMT(dest, src, count, __fpdt_data__, round); }
+#endif
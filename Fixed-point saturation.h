@@ -0,0 +1,199 @@
+/**********************************************************************
+ * File: Fixed-point saturation.h                 Created: 2024/07/06 *
+ *                                          Last modified: 2024/07/06 *
+ *                                                                    *
+ * Desc: sat<T> overflow policy for the fixed-point data types. It    *
+ *       wraps any fixed or normalised type, or one of the SIMD       *
+ *       vector types, so that operator+, operator-, +=, & -= clamp   *
+ *       to the type's range instead of wrapping around. All other    *
+ *       operators & conversions are those of the wrapped type.       *
+ *                                                                    *
+ * Notes: Vector forms use the saturating SIMD adds & subtracts, so   *
+ *        clamped math costs the same as wrapping math. Excess-coded  *
+ *        lanes (fs7p8x3) have their top bit flipped around a signed  *
+ *        saturating operation.                                       *
+ *        Types with a user-definable range have no scalar form, as   *
+ *        their zero code depends on __fpdt_data__.                   *
+ *                                                                    *
+ * MIT license.                     Copyright (c) David William Bull. *
+ **********************************************************************/
+#pragma once
+
+#include "Fixed-point data types.h"
+
+#define _FIXED_POINT_SATURATION_
+
+// Code of 0.0 for each scalar type; operator+ & operator- subtract or add it back
+template<typename T> struct _fpdt_satBias;
+
+#define _FPDT_SAT_BIAS_(type, bias) template<> struct _fpdt_satBias<type> { static constexpr si64 value = bias; };
+
+_FPDT_SAT_BIAS_(f0p8, 0)
+_FPDT_SAT_BIAS_(f1p7, 0)
+_FPDT_SAT_BIAS_(f4p4, 0)
+_FPDT_SAT_BIAS_(fp8n0_1, 0)
+_FPDT_SAT_BIAS_(f0p16, 0)
+_FPDT_SAT_BIAS_(fs1p14, 32768)
+_FPDT_SAT_BIAS_(f1p15, 0)
+_FPDT_SAT_BIAS_(f6p10, 0)
+_FPDT_SAT_BIAS_(fs7p8, 32768)
+_FPDT_SAT_BIAS_(f7p9, 0)
+_FPDT_SAT_BIAS_(f8p8, 0)
+_FPDT_SAT_BIAS_(fp16n0_1, 0)
+_FPDT_SAT_BIAS_(fp16n0_2, 0)
+_FPDT_SAT_BIAS_(fp16n0_3, 0)
+_FPDT_SAT_BIAS_(fp16n0_128, 0)
+_FPDT_SAT_BIAS_(fp16n_1_1, 32767)
+_FPDT_SAT_BIAS_(fp16n_128_128, 32767)
+#ifdef _24BIT_INTEGERS_
+_FPDT_SAT_BIAS_(f0p24, 0)
+_FPDT_SAT_BIAS_(f8p16, 0)
+_FPDT_SAT_BIAS_(f12p12, 0)
+_FPDT_SAT_BIAS_(f16p8, 0)
+_FPDT_SAT_BIAS_(fp24n0_1, 0)
+_FPDT_SAT_BIAS_(fp24n_1_1, 8388607)
+#endif
+_FPDT_SAT_BIAS_(f0p32, 0)
+_FPDT_SAT_BIAS_(f16p16, 0)
+_FPDT_SAT_BIAS_(fp32n0_1, 0)
+_FPDT_SAT_BIAS_(fp32n_1_1, 2147483647)
+
+#undef _FPDT_SAT_BIAS_
+
+/*************************
+ *  Scalar fixed-points  *
+ *************************/
+
+template<typename T> struct sat : T {
+   static constexpr si64 bias = _fpdt_satBias<T>::value;
+   static constexpr si64 max = si64((1ull << (sizeof(T::data) << 3)) - 1ull);
+
+   using T::T;
+   sat(void) = default;
+   sat(const T &value) : T(value) {}
+
+   using T::operator+; using T::operator-; using T::operator+=; using T::operator-=;
+
+   // Clamp a widened result to the code range
+   static inline const sat clamp(csi64 value) { sat result; result.data = decltype(T::data)(ui32(value < 0 ? 0 : value > max ? max : value)); return result; }
+
+   inline const sat operator+(const T &value) const { return clamp(si64(T::data) + si64(value.data) - bias); }
+   inline const sat operator-(const T &value) const { return clamp(si64(T::data) - si64(value.data) + bias); }
+   inline const sat operator+=(const T &value) { return *this = clamp(si64(T::data) + si64(value.data) - bias); }
+   inline const sat operator-=(const T &value) { return *this = clamp(si64(T::data) - si64(value.data) + bias); }
+};
+
+/*************************
+ *  Vector fixed-points  *
+ *************************/
+
+// 4x normalised 8-bit : Decimal ranges of 0.0~1.0
+template<> struct sat<fp8n0_1x4> : fp8n0_1x4 {
+   using fp8n0_1x4::fp8n0_1x4;
+   sat(void) = default;
+   sat(const fp8n0_1x4 &value) : fp8n0_1x4(value) {}
+
+   using fp8n0_1x4::operator+; using fp8n0_1x4::operator-; using fp8n0_1x4::operator+=; using fp8n0_1x4::operator-=;
+
+   inline const sat operator+(const fp8n0_1x4 &value) const { return ui32(_mm_cvtsi128_si32(_mm_adds_epu8(_mm_cvtsi32_si128(data32), _mm_cvtsi32_si128(value.data32)))); }
+   inline const sat operator-(const fp8n0_1x4 &value) const { return ui32(_mm_cvtsi128_si32(_mm_subs_epu8(_mm_cvtsi32_si128(data32), _mm_cvtsi32_si128(value.data32)))); }
+   inline const sat operator+=(const fp8n0_1x4 &value) { data32 = _mm_cvtsi128_si32(_mm_adds_epu8(_mm_cvtsi32_si128(data32), _mm_cvtsi32_si128(value.data32))); return *this; }
+   inline const sat operator-=(const fp8n0_1x4 &value) { data32 = _mm_cvtsi128_si32(_mm_subs_epu8(_mm_cvtsi32_si128(data32), _mm_cvtsi32_si128(value.data32))); return *this; }
+};
+
+#ifndef FPDT_NO_CUSTOM
+// 4x normalised 8-bit : User-defineable decimal range
+template<> struct sat<fp8nx4> : fp8nx4 {
+   using fp8nx4::fp8nx4;
+   sat(void) = default;
+   sat(const fp8nx4 &value) : fp8nx4(value) {}
+
+   using fp8nx4::operator+; using fp8nx4::operator-; using fp8nx4::operator+=; using fp8nx4::operator-=;
+
+   inline const sat operator+(const fp8nx4 &value) const { return ui32(_mm_cvtsi128_si32(_mm_adds_epu8(_mm_cvtsi32_si128(data32), _mm_cvtsi32_si128(value.data32)))); }
+   inline const sat operator-(const fp8nx4 &value) const { return ui32(_mm_cvtsi128_si32(_mm_subs_epu8(_mm_cvtsi32_si128(data32), _mm_cvtsi32_si128(value.data32)))); }
+   inline const sat operator+=(const fp8nx4 &value) { data32 = _mm_cvtsi128_si32(_mm_adds_epu8(_mm_cvtsi32_si128(data32), _mm_cvtsi32_si128(value.data32))); return *this; }
+   inline const sat operator-=(const fp8nx4 &value) { data32 = _mm_cvtsi128_si32(_mm_subs_epu8(_mm_cvtsi32_si128(data32), _mm_cvtsi32_si128(value.data32))); return *this; }
+};
+
+// 4x normalised 16-bit : User-defineable decimal range
+template<> struct sat<fp16nx4> : fp16nx4 {
+   using fp16nx4::fp16nx4;
+   sat(void) = default;
+   sat(const fp16nx4 &value) : fp16nx4(value) {}
+
+   using fp16nx4::operator+; using fp16nx4::operator-; using fp16nx4::operator+=; using fp16nx4::operator-=;
+
+   inline const sat operator+(const fp16nx4 &value) const { return ui64(_mm_cvtsi128_si64(_mm_adds_epu16(_mm_cvtsi64_si128(data64), _mm_cvtsi64_si128(value.data64)))); }
+   inline const sat operator-(const fp16nx4 &value) const { return ui64(_mm_cvtsi128_si64(_mm_subs_epu16(_mm_cvtsi64_si128(data64), _mm_cvtsi64_si128(value.data64)))); }
+   inline const sat operator+=(const fp16nx4 &value) { data64 = _mm_cvtsi128_si64(_mm_adds_epu16(_mm_cvtsi64_si128(data64), _mm_cvtsi64_si128(value.data64))); return *this; }
+   inline const sat operator-=(const fp16nx4 &value) { data64 = _mm_cvtsi128_si64(_mm_subs_epu16(_mm_cvtsi64_si128(data64), _mm_cvtsi64_si128(value.data64))); return *this; }
+};
+#endif
+
+// 3x 16-bit, signed 7.8 : Decimal range of -128.0~127.99609375
+template<> struct sat<fs7p8x3> : fs7p8x3 {
+   using fs7p8x3::fs7p8x3;
+   sat(void) = default;
+   sat(const fs7p8x3 &value) : fs7p8x3(value) {}
+
+   using fs7p8x3::operator+; using fs7p8x3::operator-; using fs7p8x3::operator+=; using fs7p8x3::operator-=;
+
+   // Flip the excess-32768 lanes to two's complement (or back)
+   static inline csi128 flip(const fs7p8x3 &value) { return _mm_xor_si128(_mm_insert_epi16(_mm_cvtsi32_si128(*(si32 *)&value.data16[0]), value.data16[2], 2), _mm_set1_epi16(si16(0x08000))); }
+   inline const sat store(csi128 &value) const { sat result; cui64 temp = _mm_cvtsi128_si64(_mm_xor_si128(value, _mm_set1_epi16(si16(0x08000)))); result.data48 = *(ci16x3 *)&temp; return result; }
+
+   inline const sat operator+(const fs7p8x3 &value) const { return store(_mm_adds_epi16(flip(*this), flip(value))); }
+   inline const sat operator-(const fs7p8x3 &value) const { return store(_mm_subs_epi16(flip(*this), flip(value))); }
+   inline const sat operator+=(const fs7p8x3 &value) { return *this = store(_mm_adds_epi16(flip(*this), flip(value))); }
+   inline const sat operator-=(const fs7p8x3 &value) { return *this = store(_mm_subs_epi16(flip(*this), flip(value))); }
+};
+
+// 4x 16-bit, 1.15 : Decimal range of 0.0~1.999969482421875
+template<> struct sat<f1p15x4> : f1p15x4 {
+   using f1p15x4::f1p15x4;
+   sat(void) = default;
+   sat(const f1p15x4 &value) : f1p15x4(value) {}
+
+   using f1p15x4::operator+; using f1p15x4::operator-; using f1p15x4::operator+=; using f1p15x4::operator-=;
+
+   inline const sat operator+(const f1p15x4 &value) const { return ui64(_mm_cvtsi128_si64(_mm_adds_epu16(_mm_cvtsi64_si128(data64), _mm_cvtsi64_si128(value.data64)))); }
+   inline const sat operator-(const f1p15x4 &value) const { return ui64(_mm_cvtsi128_si64(_mm_subs_epu16(_mm_cvtsi64_si128(data64), _mm_cvtsi64_si128(value.data64)))); }
+   inline const sat operator+=(const f1p15x4 &value) { data64 = _mm_cvtsi128_si64(_mm_adds_epu16(_mm_cvtsi64_si128(data64), _mm_cvtsi64_si128(value.data64))); return *this; }
+   inline const sat operator-=(const f1p15x4 &value) { data64 = _mm_cvtsi128_si64(_mm_subs_epu16(_mm_cvtsi64_si128(data64), _mm_cvtsi64_si128(value.data64))); return *this; }
+};
+
+// 4x normalised 16-bit : Decimal ranges of 0.0~1.0
+template<> struct sat<fp16n0_1x4> : fp16n0_1x4 {
+   using fp16n0_1x4::fp16n0_1x4;
+   sat(void) = default;
+   sat(const fp16n0_1x4 &value) : fp16n0_1x4(value) {}
+
+   using fp16n0_1x4::operator+; using fp16n0_1x4::operator-; using fp16n0_1x4::operator+=; using fp16n0_1x4::operator-=;
+
+   inline const sat operator+(const fp16n0_1x4 &value) const { return ui64(_mm_cvtsi128_si64(_mm_adds_epu16(_mm_cvtsi64_si128(data64), _mm_cvtsi64_si128(value.data64)))); }
+   inline const sat operator-(const fp16n0_1x4 &value) const { return ui64(_mm_cvtsi128_si64(_mm_subs_epu16(_mm_cvtsi64_si128(data64), _mm_cvtsi64_si128(value.data64)))); }
+   inline const sat operator+=(const fp16n0_1x4 &value) { data64 = _mm_cvtsi128_si64(_mm_adds_epu16(_mm_cvtsi64_si128(data64), _mm_cvtsi64_si128(value.data64))); return *this; }
+   inline const sat operator-=(const fp16n0_1x4 &value) { data64 = _mm_cvtsi128_si64(_mm_subs_epu16(_mm_cvtsi64_si128(data64), _mm_cvtsi64_si128(value.data64))); return *this; }
+};
+
+// 16x normalised 16-bit : Decimal ranges of 0.0~3.0
+template<> struct sat<fp16n0_3x16> : fp16n0_3x16 {
+   using fp16n0_3x16::fp16n0_3x16;
+   sat(void) = default;
+   sat(const fp16n0_3x16 &value) : fp16n0_3x16(value) {}
+
+   using fp16n0_3x16::operator+; using fp16n0_3x16::operator-; using fp16n0_3x16::operator+=; using fp16n0_3x16::operator-=;
+
+#ifdef _FPDT_AVX2_
+   inline const sat operator+(const fp16n0_3x16 &value) const { sat result; result.data256 = _mm256_adds_epu16(data256, value.data256); return result; }
+   inline const sat operator-(const fp16n0_3x16 &value) const { sat result; result.data256 = _mm256_subs_epu16(data256, value.data256); return result; }
+   inline const sat operator+=(const fp16n0_3x16 &value) { data256 = _mm256_adds_epu16(data256, value.data256); return *this; }
+   inline const sat operator-=(const fp16n0_3x16 &value) { data256 = _mm256_subs_epu16(data256, value.data256); return *this; }
+#else
+   inline const sat operator+(const fp16n0_3x16 &value) const { sat result; result.data128[0] = _mm_adds_epu16(data128[0], value.data128[0]); result.data128[1] = _mm_adds_epu16(data128[1], value.data128[1]); return result; }
+   inline const sat operator-(const fp16n0_3x16 &value) const { sat result; result.data128[0] = _mm_subs_epu16(data128[0], value.data128[0]); result.data128[1] = _mm_subs_epu16(data128[1], value.data128[1]); return result; }
+   inline const sat operator+=(const fp16n0_3x16 &value) { data128[0] = _mm_adds_epu16(data128[0], value.data128[0]); data128[1] = _mm_adds_epu16(data128[1], value.data128[1]); return *this; }
+   inline const sat operator-=(const fp16n0_3x16 &value) { data128[0] = _mm_subs_epu16(data128[0], value.data128[0]); data128[1] = _mm_subs_epu16(data128[1], value.data128[1]); return *this; }
+#endif
+};
@@ -0,0 +1,404 @@
+/**********************************************************************
+ * File: Fixed-point templates.h                  Created: 2024/07/09 *
+ *                                          Last modified: 2024/07/26 *
+ *                                                                    *
+ * Desc: Fixed-point types generated from compile-time parameters.    *
+ *       fpn<Bits, Floor, Ceiling> is a normalised type of 8, 16, or  *
+ *       32 bits (24 with _24BIT_INTEGERS_) covering Floor~Ceiling,   *
+ *       with the scale & bias as constexpr members; there is no      *
+ *       run-time state, unlike the types with a user-definable       *
+ *       range, so the compiler folds conversions into immediates.    *
+ *       fixed<IntBits, FracBits, Signed> is any Q-format of those    *
+ *       sizes, with integer multiply & divide. fixedv<T, N> holds N  *
+ *       lanes of either, with fixedx4/x8/x16/x32 aliases for fixed.  *
+ *                                                                    *
+ * Notes: Floating-point template parameters require C++20.           *
+ *        Codes are (value - Floor) * scale, truncated, as with the   *
+ *        hand-written types; e.g. fpn<16, -1.0, 1.0> has the same    *
+ *        codes as fp16n_1_1, & fixed<7, 8, true> those of fs7p8.     *
+ *        fixedv uses SSE, or AVX2 when enabled at compile time, for  *
+ *        +, -, *, & conversions; division is per lane.               *
+ *        fpdtToFixed() & fpdtToFloat() accept arrays of every type   *
+ *        generated here.                                             *
+ *                                                                    *
+ * MIT license.                     Copyright (c) David William Bull. *
+ **********************************************************************/
+#pragma once
+
+#include "Fixed-point data types.h"
+#include "Fixed-point bulk conversion.h"
+
+#define _FIXED_POINT_TEMPLATES_
+
+// Code & conversion types for each size
+template<cui32 bits> struct _fpdt_code;
+template<> struct _fpdt_code<8> { typedef ui8 type; typedef fl32 fl; };
+template<> struct _fpdt_code<16> { typedef ui16 type; typedef fl32 fl; };
+#ifdef _24BIT_INTEGERS_
+template<> struct _fpdt_code<24> { typedef ui24 type; typedef fl32 fl; };
+#endif
+template<> struct _fpdt_code<32> { typedef ui32 type; typedef fl64 fl; };
+
+/****************************************
+ *  Base of all generated fixed-points  *
+ ****************************************/
+
+// Operators shared by every generated type T, whose value is code / scale + floor
+template<typename T, cui32 bits, cfl64 floor64, cfl64 scale64> struct _fpdt_scaled {
+   typedef typename _fpdt_code<bits>::type code;
+   typedef typename _fpdt_code<bits>::fl fl;
+   typedef const code ccode; typedef const fl cfl; typedef const T cT;
+
+   static constexpr fl   floor = fl(floor64);           // Value of code 0
+   static constexpr fl   scale = fl(scale64);           // Codes per unit
+   static constexpr fl   rcpScale = fl(1.0 / scale64);  // Units per code
+   static constexpr si64 zero = si64(-floor64 * scale64); // Code of 0.0, restored after + & -
+
+   code data;
+
+   static inline ccode toFixed(cfl &value) { return code((value - floor) * scale); }
+   static inline cfl toFloat(ccode &value) { return fl(value) * rcpScale + floor; }
+   inline cfl toFloat(void) const { return fl(data) * rcpScale + floor; }
+
+   // Wrap a raw code
+   static inline cT raw(ccode value) { T result; result.data = value; return result; }
+
+   _fpdt_scaled(void) = default;
+   _fpdt_scaled(ccode value) { data = value; }
+   _fpdt_scaled(csi32 value) { data = code(value); }
+   _fpdt_scaled(cfl32 value) { data = toFixed(fl(value)); }
+   _fpdt_scaled(cfl64 value) { data = toFixed(fl(value)); }
+
+   operator cfl(void) const { return toFloat(); }
+
+   inline cT operator-(void) const { return raw(toFixed(-toFloat())); }
+   inline cbool operator!(void) const { return data == code(zero); }
+
+   inline cT operator++(void) { data++; return raw(data); }
+   inline cT operator++(int) { ccode temp = data++; return raw(temp); }
+   inline cT operator--(void) { data--; return raw(data); }
+   inline cT operator--(int) { ccode temp = data--; return raw(temp); }
+
+   inline cbool operator==(cT &value) const { return data == value.data; }
+   inline cbool operator!=(cT &value) const { return data != value.data; }
+   inline cbool operator>=(cT &value) const { return data >= value.data; }
+   inline cbool operator<=(cT &value) const { return data <= value.data; }
+   inline cbool operator>(cT &value) const { return data > value.data; }
+   inline cbool operator<(cT &value) const { return data < value.data; }
+
+   inline cT operator+(cT &value) const { return raw(code(data + value.data - zero)); }
+   inline cT operator-(cT &value) const { return raw(code(data - value.data + zero)); }
+   inline cT operator*(cT &value) const { return raw(toFixed(toFloat() * value.toFloat())); }
+   inline cT operator/(cT &value) const { return raw(toFixed(toFloat() / value.toFloat())); }
+   inline cT operator+=(cT &value) { data = code(data + value.data - zero); return raw(data); }
+   inline cT operator-=(cT &value) { data = code(data - value.data + zero); return raw(data); }
+   inline cT operator*=(cT &value) { data = toFixed(toFloat() * value.toFloat()); return raw(data); }
+   inline cT operator/=(cT &value) { data = toFixed(toFloat() / value.toFloat()); return raw(data); }
+
+   inline cfl operator+(cfl &value) const { return toFloat() + value; }
+   inline cfl operator-(cfl &value) const { return toFloat() - value; }
+   inline cfl operator*(cfl &value) const { return toFloat() * value; }
+   inline cfl operator/(cfl &value) const { return toFloat() / value; }
+   inline cfl operator+=(cfl &value) { cfl temp = toFloat() + value; data = toFixed(temp); return temp; }
+   inline cfl operator-=(cfl &value) { cfl temp = toFloat() - value; data = toFixed(temp); return temp; }
+   inline cfl operator*=(cfl &value) { cfl temp = toFloat() * value; data = toFixed(temp); return temp; }
+   inline cfl operator/=(cfl &value) { cfl temp = toFloat() / value; data = toFixed(temp); return temp; }
+
+   inline cbool operator==(cfl &value) const { return data == toFixed(value); }
+   inline cbool operator!=(cfl &value) const { return data != toFixed(value); }
+   inline cbool operator>=(cfl &value) const { return toFloat() >= value; }
+   inline cbool operator<=(cfl &value) const { return toFloat() <= value; }
+   inline cbool operator>(cfl &value) const { return toFloat() > value; }
+   inline cbool operator<(cfl &value) const { return toFloat() < value; }
+};
+
+/***********************************
+ *  Compile-time normalised range  *
+ ***********************************/
+
+// Normalised Bits-bit : Decimal range of Floor~Ceiling
+template<cui32 Bits, cfl64 Floor, cfl64 Ceiling>
+struct fpn : _fpdt_scaled<fpn<Bits, Floor, Ceiling>, Bits, Floor, fl64((1ull << Bits) - 1ull) / (Ceiling - Floor)> {
+   static_assert(Ceiling > Floor, "fpn requires Ceiling > Floor");
+
+   using _fpdt_scaled<fpn<Bits, Floor, Ceiling>, Bits, Floor, fl64((1ull << Bits) - 1ull) / (Ceiling - Floor)>::_fpdt_scaled;
+   fpn(void) = default;
+};
+
+/***************************
+ *  Compile-time Q-format  *
+ ***************************/
+
+// IntBits.FracBits fixed-point, plus a sign bit if Signed; signed codes are excess-2^(bits - 1), as fs7p8's
+template<cui32 IntBits, cui32 FracBits, cbool Signed = false>
+struct fixed : _fpdt_scaled<fixed<IntBits, FracBits, Signed>, IntBits + FracBits + Signed, Signed ? -fl64(1ull << IntBits) : 0.0, fl64(1ull << FracBits)> {
+   typedef _fpdt_scaled<fixed<IntBits, FracBits, Signed>, IntBits + FracBits + Signed, Signed ? -fl64(1ull << IntBits) : 0.0, fl64(1ull << FracBits)> base;
+   typedef typename base::code code; typedef typename base::ccode ccode; typedef const fixed cfixed;
+
+   static constexpr ui32 bits = IntBits + FracBits + Signed;
+   static constexpr ui32 frac = FracBits;
+   static constexpr ui64 max = (1ull << bits) - 1ull;
+   static_assert(bits == 8 || bits == 16 || bits == 24 || bits == 32, "fixed requires 8, 16, 24, or 32 bits");
+
+   // Integer multiply & divide, rounded to nearest, matching the hand-written fixed-point types
+   static inline ccode mul(ccode a, ccode b) {
+      if constexpr (Signed) return code((((si64(a) - base::zero) * (si64(b) - base::zero) + (1ll << FracBits >> 1)) >> FracBits) + base::zero);
+      else return code((ui64(a) * ui64(b) + (1ull << FracBits >> 1)) >> FracBits);
+   }
+   static inline ccode div(ccode a, ccode b) {
+      if constexpr (Signed) {
+         csi64 num = (si64(a) - base::zero) * (1ll << FracBits), den = si64(b) - base::zero;
+         csi64 half = (den < 0 ? -den : den) >> 1;
+
+         if (!den) return num < 0 ? code(0) : code(max);
+         return code((num + (num < 0 ? -half : half)) / den + base::zero);
+      } else return b ? code(((ui64(a) << FracBits) + (ui64(b) >> 1)) / ui64(b)) : code(max);
+   }
+
+   using base::base;
+   fixed(void) = default;
+
+   using base::operator*; using base::operator/; using base::operator*=; using base::operator/=;
+
+   inline cfixed operator*(cfixed &value) const { return base::raw(mul(base::data, value.data)); }
+   inline cfixed operator/(cfixed &value) const { return base::raw(div(base::data, value.data)); }
+   inline cfixed operator*=(cfixed &value) { base::data = mul(base::data, value.data); return *this; }
+   inline cfixed operator/=(cfixed &value) { base::data = div(base::data, value.data); return *this; }
+};
+
+/********************************
+ *  Vectors of generated types  *
+ ********************************/
+
+// Lane operations on SSE & AVX2 registers; bits is the lane size
+template<cui32 bits> static inline csi128 _fpdt_vadd(csi128 a, csi128 b) {
+   if constexpr (bits == 8) return _mm_add_epi8(a, b);
+   else if constexpr (bits == 16) return _mm_add_epi16(a, b);
+   else return _mm_add_epi32(a, b);
+}
+
+template<cui32 bits> static inline csi128 _fpdt_vsub(csi128 a, csi128 b) {
+   if constexpr (bits == 8) return _mm_sub_epi8(a, b);
+   else if constexpr (bits == 16) return _mm_sub_epi16(a, b);
+   else return _mm_sub_epi32(a, b);
+}
+
+// Subtract a constant from each lane; 0 compiles to nothing
+template<cui32 bits> static inline csi128 _fpdt_vbias(csi128 a, csi64 bias) {
+   if (!bias) return a;
+   if constexpr (bits == 8) return _mm_sub_epi8(a, _mm_set1_epi8(si8(bias)));
+   else if constexpr (bits == 16) return _mm_sub_epi16(a, _mm_set1_epi16(si16(bias)));
+   else return _mm_sub_epi32(a, _mm_set1_epi32(si32(bias)));
+}
+
+// Flip each lane's top bit: converts excess codes to & from two's complement
+template<cui32 bits> static inline csi128 _fpdt_vflip(csi128 a) {
+   if constexpr (bits == 8) return _mm_xor_si128(a, _mm_set1_epi8(si8(0x080)));
+   else if constexpr (bits == 16) return _mm_xor_si128(a, _mm_set1_epi16(si16(0x08000)));
+   else return _mm_xor_si128(a, _mm_set1_epi32(si32(0x080000000)));
+}
+
+// (a * b + 2^(frac - 1)) >> frac per lane, of two's complement lanes if sign
+template<cui32 bits, cui32 frac, cbool sign> static inline csi128 _fpdt_vmul(csi128 a, csi128 b) {
+   if constexpr (bits == 8) {
+      // Widen to 16 bits, where the whole product fits, then keep the low byte of each result
+      csi128 zero = _mm_setzero_si128(), half = _mm_set1_epi16(si16(1 << frac >> 1)), mask = _mm_set1_epi16(0x0FF);
+      si128  lo, hi;
+
+      if constexpr (sign) {
+         lo = _mm_mullo_epi16(_mm_srai_epi16(_mm_unpacklo_epi8(a, a), 8), _mm_srai_epi16(_mm_unpacklo_epi8(b, b), 8));
+         hi = _mm_mullo_epi16(_mm_srai_epi16(_mm_unpackhi_epi8(a, a), 8), _mm_srai_epi16(_mm_unpackhi_epi8(b, b), 8));
+         lo = _mm_srai_epi16(_mm_add_epi16(lo, half), frac); hi = _mm_srai_epi16(_mm_add_epi16(hi, half), frac);
+      } else {
+         lo = _mm_mullo_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+         hi = _mm_mullo_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+         lo = _mm_srli_epi16(_mm_add_epi16(lo, half), frac); hi = _mm_srli_epi16(_mm_add_epi16(hi, half), frac);
+      }
+      return _mm_packus_epi16(_mm_and_si128(lo, mask), _mm_and_si128(hi, mask));
+   } else if constexpr (bits == 16) {
+      // Low 16 bits of the 32-bit product >> frac, plus the rounding bit
+      csi128 lo = _mm_mullo_epi16(a, b);
+      csi128 hi = sign ? _mm_mulhi_epi16(a, b) : _mm_mulhi_epu16(a, b);
+
+      if constexpr (frac == 0) return lo;
+      else return _mm_add_epi16(_mm_or_si128(_mm_slli_epi16(hi, 16 - frac), _mm_srli_epi16(lo, frac)), _mm_and_si128(_mm_srli_epi16(lo, frac - 1), _mm_set1_epi16(1)));
+   } else {
+      // Even & odd lanes as 64-bit products; the low 32 bits of a logical shift equal those of an arithmetic one
+      csi128 half = _mm_set1_epi64x(si64(1ull << frac >> 1));
+      csi128 even = sign ? _mm_mul_epi32(a, b) : _mm_mul_epu32(a, b);
+      csi128 odd = sign ? _mm_mul_epi32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32)) : _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+
+      return _mm_blend_epi16(_mm_srli_epi64(_mm_add_epi64(even, half), frac), _mm_slli_epi64(_mm_srli_epi64(_mm_add_epi64(odd, half), frac), 32), 0x0CC);
+   }
+}
+
+#ifdef _FPDT_AVX2_
+template<cui32 bits> static inline csi256 _fpdt_vadd(csi256 a, csi256 b) {
+   if constexpr (bits == 8) return _mm256_add_epi8(a, b);
+   else if constexpr (bits == 16) return _mm256_add_epi16(a, b);
+   else return _mm256_add_epi32(a, b);
+}
+
+template<cui32 bits> static inline csi256 _fpdt_vsub(csi256 a, csi256 b) {
+   if constexpr (bits == 8) return _mm256_sub_epi8(a, b);
+   else if constexpr (bits == 16) return _mm256_sub_epi16(a, b);
+   else return _mm256_sub_epi32(a, b);
+}
+
+template<cui32 bits> static inline csi256 _fpdt_vbias(csi256 a, csi64 bias) {
+   if (!bias) return a;
+   if constexpr (bits == 8) return _mm256_sub_epi8(a, _mm256_set1_epi8(si8(bias)));
+   else if constexpr (bits == 16) return _mm256_sub_epi16(a, _mm256_set1_epi16(si16(bias)));
+   else return _mm256_sub_epi32(a, _mm256_set1_epi32(si32(bias)));
+}
+
+template<cui32 bits> static inline csi256 _fpdt_vflip(csi256 a) {
+   if constexpr (bits == 8) return _mm256_xor_si256(a, _mm256_set1_epi8(si8(0x080)));
+   else if constexpr (bits == 16) return _mm256_xor_si256(a, _mm256_set1_epi16(si16(0x08000)));
+   else return _mm256_xor_si256(a, _mm256_set1_epi32(si32(0x080000000)));
+}
+
+template<cui32 bits, cui32 frac, cbool sign> static inline csi256 _fpdt_vmul(csi256 a, csi256 b) {
+   if constexpr (bits == 8) {
+      // In-lane unpacks & packs are inverses, so element order is kept
+      csi256 zero = _mm256_setzero_si256(), half = _mm256_set1_epi16(si16(1 << frac >> 1)), mask = _mm256_set1_epi16(0x0FF);
+      si256  lo, hi;
+
+      if constexpr (sign) {
+         lo = _mm256_mullo_epi16(_mm256_srai_epi16(_mm256_unpacklo_epi8(a, a), 8), _mm256_srai_epi16(_mm256_unpacklo_epi8(b, b), 8));
+         hi = _mm256_mullo_epi16(_mm256_srai_epi16(_mm256_unpackhi_epi8(a, a), 8), _mm256_srai_epi16(_mm256_unpackhi_epi8(b, b), 8));
+         lo = _mm256_srai_epi16(_mm256_add_epi16(lo, half), frac); hi = _mm256_srai_epi16(_mm256_add_epi16(hi, half), frac);
+      } else {
+         lo = _mm256_mullo_epi16(_mm256_unpacklo_epi8(a, zero), _mm256_unpacklo_epi8(b, zero));
+         hi = _mm256_mullo_epi16(_mm256_unpackhi_epi8(a, zero), _mm256_unpackhi_epi8(b, zero));
+         lo = _mm256_srli_epi16(_mm256_add_epi16(lo, half), frac); hi = _mm256_srli_epi16(_mm256_add_epi16(hi, half), frac);
+      }
+      return _mm256_packus_epi16(_mm256_and_si256(lo, mask), _mm256_and_si256(hi, mask));
+   } else if constexpr (bits == 16) {
+      csi256 lo = _mm256_mullo_epi16(a, b);
+      csi256 hi = sign ? _mm256_mulhi_epi16(a, b) : _mm256_mulhi_epu16(a, b);
+
+      if constexpr (frac == 0) return lo;
+      else return _mm256_add_epi16(_mm256_or_si256(_mm256_slli_epi16(hi, 16 - frac), _mm256_srli_epi16(lo, frac)), _mm256_and_si256(_mm256_srli_epi16(lo, frac - 1), _mm256_set1_epi16(1)));
+   } else {
+      csi256 half = _mm256_set1_epi64x(si64(1ull << frac >> 1));
+      csi256 even = sign ? _mm256_mul_epi32(a, b) : _mm256_mul_epu32(a, b);
+      csi256 odd = sign ? _mm256_mul_epi32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32)) : _mm256_mul_epu32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32));
+
+      return _mm256_blend_epi32(_mm256_srli_epi64(_mm256_add_epi64(even, half), frac), _mm256_slli_epi64(_mm256_srli_epi64(_mm256_add_epi64(odd, half), frac), 32), 0x0AA);
+   }
+}
+#endif
+
+// Encode & decode kernels for the instruction set enabled at compile time, as the inline vector types use
+#if defined(__AVX512BW__) && defined(__AVX512VL__) && defined(_FPDT_KERNELS_AVX512_)
+#define _FPDT_INLINE_KERNEL_(name) name##AVX512
+#elif defined(_FPDT_AVX2_) && defined(_FPDT_KERNELS_AVX2_)
+#define _FPDT_INLINE_KERNEL_(name) name##AVX2
+#else
+#define _FPDT_INLINE_KERNEL_(name) name##SSE
+#endif
+
+// N lanes of a generated 8, 16, or 32-bit type T, processed with SSE, or AVX2 where 32 or more bytes
+template<typename T, cui32 N> struct fixedv {
+   typedef typename T::code code; typedef typename T::fl fl;
+   typedef const T cT; typedef const fl cfl; typedef const fixedv cfixedv;
+
+   static constexpr ui32 bits = sizeof(code) << 3;
+   static constexpr ui32 bytes = N * sizeof(code);
+   static_assert(bits == 8 || bits == 16 || bits == 32, "fixedv requires 8, 16, or 32-bit lanes");
+   static_assert(bytes == 4 || bytes == 8 || bytes % 16 == 0, "fixedv requires 4, 8, or a multiple of 16 bytes");
+
+   // Largest power of 2 that divides bytes, up to a cache line; e.g. 48-byte vectors align to 16
+   static constexpr ui32 align = (bytes & (0u - bytes)) < 64 ? (bytes & (0u - bytes)) : 64;
+
+   alignas(align) T data[N];
+
+   // Apply a lane operation to every register's worth of lanes
+   template<typename Op> inline cfixedv zip(cfixedv &value, Op op) const {
+      fixedv result;
+
+      if constexpr (bytes == 4) *(si32 *)result.data = _mm_cvtsi128_si32(op(_mm_cvtsi32_si128(*(csi32 *)data), _mm_cvtsi32_si128(*(csi32 *)value.data)));
+      else if constexpr (bytes == 8) _mm_storel_epi64((si128 *)result.data, op(_mm_loadl_epi64((csi128 *)data), _mm_loadl_epi64((csi128 *)value.data)));
+#ifdef _FPDT_AVX2_
+      else if constexpr (bytes % 32 == 0)
+         for (ui32 i = 0; i < bytes; i += 32) _mm256_store_si256((si256 *)((ui8 *)result.data + i), op(_mm256_load_si256((csi256 *)((cui8 *)data + i)), _mm256_load_si256((csi256 *)((cui8 *)value.data + i))));
+#endif
+      else
+         for (ui32 i = 0; i < bytes; i += 16) _mm_store_si128((si128 *)((ui8 *)result.data + i), op(_mm_load_si128((csi128 *)((cui8 *)data + i)), _mm_load_si128((csi128 *)((cui8 *)value.data + i))));
+      return result;
+   }
+
+   fixedv(void) = default;
+   fixedv(cT value) { for (ui32 i = 0; i < N; i++) data[i] = value; }
+   fixedv(cfl value) { cT temp = value; for (ui32 i = 0; i < N; i++) data[i] = temp; }
+   fixedv(cT (&values)[N]) { for (ui32 i = 0; i < N; i++) data[i] = values[i]; }
+   fixedv(const fl (&values)[N]) { toFixed(values); }
+
+   // Convert N floats, or to N floats, with the SIMD encode & decode kernels
+   inline void toFixed(const fl (&values)[N]) {
+      if constexpr (bits == 8) _FPDT_INLINE_KERNEL_(_fpdt_encode8)<FPDT_ROUND_TRUNCATE>((ui8 *)data, values, N, -T::floor, T::scale);
+      else if constexpr (bits == 16) _FPDT_INLINE_KERNEL_(_fpdt_encode16)<FPDT_ROUND_TRUNCATE>((ui16 *)data, values, N, -T::floor, T::scale);
+      else _FPDT_INLINE_KERNEL_(_fpdt_encode32)<FPDT_ROUND_TRUNCATE>((ui32 *)data, values, N, -T::floor, T::scale);
+   }
+   inline void toFloat(fl (&values)[N]) const {
+      if constexpr (bits == 8) _FPDT_INLINE_KERNEL_(_fpdt_decode8)((fl32 *)values, (cui8 *)data, N, T::rcpScale, T::floor);
+      else if constexpr (bits == 16) _FPDT_INLINE_KERNEL_(_fpdt_decode16)((fl32 *)values, (cui16 *)data, N, T::rcpScale, T::floor);
+      else _FPDT_INLINE_KERNEL_(_fpdt_decode32)((fl64 *)values, (cui32 *)data, N, T::rcpScale, T::floor);
+   }
+
+   inline T &operator[](cui32 index) { return data[index]; }
+   inline cT &operator[](cui32 index) const { return data[index]; }
+
+   // Codes add & subtract, then the code of 0.0 is restored
+   inline cfixedv operator+(cfixedv &value) const { return zip(value, [](auto a, auto b) { return _fpdt_vbias<bits>(_fpdt_vadd<bits>(a, b), T::zero); }); }
+   inline cfixedv operator-(cfixedv &value) const { return zip(value, [](auto a, auto b) { return _fpdt_vbias<bits>(_fpdt_vsub<bits>(a, b), -T::zero); }); }
+   // Q-formats multiply in integer lanes, signed ones as two's complement; other types multiply lane by lane
+   inline cfixedv operator*(cfixedv &value) const {
+      if constexpr (requires { T::frac; })
+         return zip(value, [](auto a, auto b) {
+            if constexpr (T::zero != 0) return _fpdt_vflip<bits>(_fpdt_vmul<bits, T::frac, true>(_fpdt_vflip<bits>(a), _fpdt_vflip<bits>(b)));
+            else return _fpdt_vmul<bits, T::frac, false>(a, b);
+         });
+      else { fixedv result; for (ui32 i = 0; i < N; i++) result.data[i] = data[i] * value.data[i]; return result; }
+   }
+   // No SIMD integer divide exists, so lanes divide one at a time
+   inline cfixedv operator/(cfixedv &value) const { fixedv result; for (ui32 i = 0; i < N; i++) result.data[i] = data[i] / value.data[i]; return result; }
+
+   inline cfixedv operator+=(cfixedv &value) { return *this = *this + value; }
+   inline cfixedv operator-=(cfixedv &value) { return *this = *this - value; }
+   inline cfixedv operator*=(cfixedv &value) { return *this = *this * value; }
+   inline cfixedv operator/=(cfixedv &value) { return *this = *this / value; }
+};
+
+template<cui32 IntBits, cui32 FracBits, cbool Signed = false> using fixedx4 = fixedv<fixed<IntBits, FracBits, Signed>, 4>;
+template<cui32 IntBits, cui32 FracBits, cbool Signed = false> using fixedx8 = fixedv<fixed<IntBits, FracBits, Signed>, 8>;
+template<cui32 IntBits, cui32 FracBits, cbool Signed = false> using fixedx16 = fixedv<fixed<IntBits, FracBits, Signed>, 16>;
+template<cui32 IntBits, cui32 FracBits, cbool Signed = false> using fixedx32 = fixedv<fixed<IntBits, FracBits, Signed>, 32>;
+
+/**********************
+ *  Bulk conversions  *
+ **********************/
+
+template<typename T, cui32 bits, cfl64 floor, cfl64 scale>
+inline void fpdtToFixed(_fpdt_scaled<T, bits, floor, scale> *dest, const typename _fpdt_code<bits>::fl *src, csize_t count, cui32 round = FPDT_ROUND_TRUNCATE) {
+   if constexpr (bits == 8) _fpdt_encode8((ui8 *)dest, src, count, fl32(-floor), fl32(scale), round);
+   else if constexpr (bits == 16) _fpdt_encode16((ui16 *)dest, src, count, fl32(-floor), fl32(scale), round);
+#ifdef _24BIT_INTEGERS_
+   else if constexpr (bits == 24) _fpdt_encode24((ui8 *)dest, src, count, fl32(-floor), fl32(scale), round);
+#endif
+   else _fpdt_encode32((ui32 *)dest, src, count, -floor, scale, round);
+}
+
+template<typename T, cui32 bits, cfl64 floor, cfl64 scale>
+inline void fpdtToFloat(typename _fpdt_code<bits>::fl *dest, const _fpdt_scaled<T, bits, floor, scale> *src, csize_t count) {
+   if constexpr (bits == 8) _fpdt_decode8(dest, (cui8 *)src, count, fl32(1.0 / scale), fl32(floor));
+   else if constexpr (bits == 16) _fpdt_decode16(dest, (cui16 *)src, count, fl32(1.0 / scale), fl32(floor));
+#ifdef _24BIT_INTEGERS_
+   else if constexpr (bits == 24) _fpdt_decode24(dest, (cui8 *)src, count, fl32(1.0 / scale), fl32(floor));
+#endif
+   else _fpdt_decode32(dest, (cui32 *)src, count, 1.0 / scale, floor);
+}
+
+template<typename T, cui32 N> inline void fpdtToFixed(fixedv<T, N> *dest, const typename T::fl *src, csize_t count, cui32 round = FPDT_ROUND_TRUNCATE) { fpdtToFixed((T *)dest, src, count * N, round); }
+template<typename T, cui32 N> inline void fpdtToFloat(typename T::fl *dest, const fixedv<T, N> *src, csize_t count) { fpdtToFloat(dest, (const T *)src, count * N); }
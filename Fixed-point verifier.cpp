@@ -0,0 +1,556 @@
+/**********************************************************************
+ * File: Fixed-point verifier.cpp                 Created: 2024/07/23 *
+ *                                          Last modified: 2024/07/26 *
+ *                                                                    *
+ * Desc: Exhaustive checks of every 8 & 16-bit type over all of its   *
+ *       codes. toFixed(toFloat(code)) must give back the code, & the *
+ *       SIMD paths must match the scalar path: the vector types, &   *
+ *       the bulk kernels at each instruction set the host supports.  *
+ *       Prints CSV, one row per type & check:                        *
+ *       check,isa,type,values,failures,first,maxError,ms             *
+ *                                                                    *
+ * Notes: Codes are split among all hardware threads, which take      *
+ *        chunks of them in turn. Encodes are checked at each decoded *
+ *        value, the floats just below & above it, & the midpoint to  *
+ *        the next code, within the range of the type. first is the   *
+ *        lowest failing code, or -1. maxError is the largest         *
+ *        |toFloat(toFixed(x)) - x| of the round trips, in steps.     *
+ *        Truncating encodes of the normalised types listed in        *
+ *        VERIFY_TRUNCATING give the code below for some codes, one   *
+ *        step out, which their round trips accept; any other code    *
+ *        fails, as does any mismatch for every other type. Bulk      *
+ *        encodes are checked truncating, bit for bit, & rounding to  *
+ *        nearest, where each must give the nearest code, either one  *
+ *        within 1/64 of a step of a tie. Both take in the floats     *
+ *        just above the top code that truncate to it. The array      *
+ *        check runs FixedArray operators on arrays of unequal        *
+ *        lengths, which must keep the elements past the shorter one, *
+ *        & the padding at code 0; the array op checks compare +, -,  *
+ *        *, /, scale(), & clamp() with the element type's own        *
+ *        operators, element by element. The top checks encode values *
+ *        within a step of each type's top code, rounded to nearest & *
+ *        stochastically, which must not wrap past the top code. The  *
+ *        pcm checks feed PCM24Decoder & PCM24Encoder streams of      *
+ *        3-channel frames in chunks of random sizes, so that partial *
+ *        frames carry over, & compare every sample with the scalar   *
+ *        path, bit for bit. Returns 1 if any check fails. The only   *
+ *        argument is a thread count, every hardware thread if none.  *
+ *                                                                    *
+ * MIT license.                     Copyright (c) David William Bull. *
+ **********************************************************************/
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include "vector structures.h"
+#include "Fixed-point bulk conversion.h"
+#include "Fixed-point array.h"
+#include "PCM audio conversion.h"
+
+fpdtInitCustom;
+
+#if defined(__AVX512F__)
+#define VERIFY_BUILD "AVX512"
+#elif defined(__AVX2__)
+#define VERIFY_BUILD "AVX2"
+#else
+#define VERIFY_BUILD "SSE"
+#endif
+
+#define VERIFY_CHUNK 1024 // Codes per work item
+
+// Every 8 & 16-bit scalar type
+#define VERIFY_SCALARS(X) \
+   X(fp8n) X(f0p8) X(f1p7) X(f4p4) X(fp8n0_1) \
+   X(fp16n) X(f0p16) X(fs1p14) X(f1p15) X(f6p10) X(fs7p8) X(f7p9) X(f8p8) \
+   X(fp16n0_1) X(fp16n0_2) X(fp16n0_3) X(fp16n0_128) X(fp16n_1_1) X(fp16n_128_128)
+
+// Normalised types whose decoded values can fall a fraction below their codes, which truncating encodes take to the
+// code below; their round trips may give that code, one step out, where every other type must give back each code
+#define VERIFY_TRUNCATING(X) \
+   X(fp8n) X(fp16n) X(fp16n0_1) X(fp16n0_2) X(fp16n0_3) X(fp16n0_128) X(fp16n_1_1) X(fp16n_128_128)
+
+// FixedArray element types: normalised, Q-format, & biased signed layouts
+#define VERIFY_ARRAYS(X) X(fp8n0_1) X(f4p4) X(fs7p8) X(f8p8) X(fs1p14) X(fp16n_1_1)
+
+// Every vector type, with its lane type & lanes
+#define VERIFY_VECTORS(X) \
+   X(fp8nx4, fp8n, 4) X(fp8n0_1x4, fp8n0_1, 4) X(fp16nx4, fp16n, 4) X(fs7p8x3, fs7p8, 3) X(f1p15x4, f1p15, 4) \
+   X(fp16n0_1x4, fp16n0_1, 4) X(fp16n0_3x16, fp16n0_3, 16) \
+   X(f0p8x2, f0p8, 2) X(f1p7x2, f1p7, 2) X(f4p4x2, f4p4, 2) X(fp8n0_1x2, fp8n0_1, 2) X(f0p16x2, f0p16, 2) \
+   X(fs1p14x2, fs1p14, 2) X(f1p15x2, f1p15, 2) X(f6p10x2, f6p10, 2) X(fs7p8x2, fs7p8, 2) X(f7p9x2, f7p9, 2) \
+   X(f8p8x2, f8p8, 2) X(fp16n0_1x2, fp16n0_1, 2) X(fp16n_1_1x2, fp16n_1_1, 2)
+
+// PCM sample types
+#define VERIFY_PCM_TYPES(X) X(fl32) X(fs1p14) X(f1p15) X(fp16n_1_1)
+
+static const char * const verifyISA[] = { "SSE", "AVX2", "AVX512" };
+
+static ui32 verifyThreads = 1;
+static bool verifyFailed = false;
+
+/*************
+ *  Helpers  *
+ *************/
+
+// Whether T is in VERIFY_TRUNCATING
+template<typename T> struct verifyTruncates { static constexpr bool value = false; };
+#define VERIFY_TRUNCATES(T) template<> struct verifyTruncates<T> { static constexpr bool value = true; };
+VERIFY_TRUNCATING(VERIFY_TRUNCATES)
+
+// Floats holding lanes values
+template<cui32 lanes> struct verifyFloats { typedef fl32x4 type; };
+template<> struct verifyFloats<2> { typedef f32x2 type; };
+template<> struct verifyFloats<16> { typedef f32x16 type; };
+
+// Totals of one check, merged from every thread
+struct verifyTotals {
+   std::atomic<ui64> values = 0, failures = 0;
+   std::atomic<ui32> first = ~0u;
+   std::atomic<fl64> maxError = 0.0;
+
+   void merge(cui64 chunkValues, cui64 chunkFailures, cui32 chunkFirst, cfl64 chunkError) {
+      values += chunkValues; failures += chunkFailures;
+      for (ui32 low = first; chunkFirst < low && !first.compare_exchange_weak(low, chunkFirst);) {}
+      for (fl64 high = maxError; chunkError > high && !maxError.compare_exchange_weak(high, chunkError);) {}
+   }
+};
+
+// Runs body(begin, end) over codes 0~count-1, VERIFY_CHUNK at a time, on verifyThreads threads
+template<class B> static void verifyParallel(cui32 count, B &&body) {
+   std::atomic<ui32> next = 0;
+   auto worker = [&] { for (ui32 begin; (begin = next.fetch_add(VERIFY_CHUNK)) < count;) body(begin, count - begin < VERIFY_CHUNK ? count : begin + VERIFY_CHUNK); };
+   std::thread *workers = new std::thread[verifyThreads - 1];
+
+   for (ui32 i = 0; i < verifyThreads - 1; i++) workers[i] = std::thread(worker);
+   worker();
+   for (ui32 i = 0; i < verifyThreads - 1; i++) workers[i].join();
+   delete[] workers;
+}
+
+// Times run(totals), then prints its row; a check fails on any failure, or an error of more than one step
+template<class C> static void verifyRun(const char *check, const char *isa, const char *type, C &&run) {
+   verifyTotals totals;
+   const auto start = std::chrono::steady_clock::now();
+
+   run(totals);
+   cfl64 ms = std::chrono::duration<fl64, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+   printf("%s,%s,%s,%llu,%llu,%d,%.4f,%.3f\n", check, isa, type, (unsigned long long)totals.values.load(), (unsigned long long)totals.failures.load(),
+          totals.failures ? si32(totals.first) : -1, totals.maxError.load(), ms);
+   fflush(stdout);
+   if (totals.failures != 0 || totals.maxError > 1.0) verifyFailed = true;
+}
+
+// The code of value; std::addressof, as the types overload unary operator&
+template<typename T> static inline cui32 verifyBits(const T &value) { return sizeof(T) == 1 ? ui32(*(cui8 *)std::addressof(value)) : ui32(*(cui16 *)std::addressof(value)); }
+// Bit for bit, so that -0.0 & NaNs are told apart
+static inline cbool verifySame(cfl32 a, cfl32 b) { return memcmp(&a, &b, sizeof(fl32)) == 0; }
+
+template<typename T> static inline cfl32 verifyDecode(cui32 code) { return static_cast<fl32>(*(const T *)&code); }
+template<typename T> static inline cui32 verifyEncode(cfl32 value) { return verifyBits(T(value)); }
+
+// The floats at which encodes near code are checked: its value, the floats either side, & the midpoint to the
+// next code, except those outside the range of T
+template<typename T> static inline cui32 verifyInputs(fl32 *inputs, cui32 code) {
+   constexpr ui32 count = 1u << (sizeof(T) * 8);
+   cfl32 value = verifyDecode<T>(code), lowest = verifyDecode<T>(0), highest = verifyDecode<T>(count - 1);
+   cfl32 candidates[4] = { value, nextafterf(value, -INFINITY), nextafterf(value, INFINITY), code + 1 < count ? (value + verifyDecode<T>(code + 1)) * 0.5f : value };
+   ui32 n = 0;
+
+   for (ui32 i = 0; i < 4; i++) if (candidates[i] >= lowest && candidates[i] <= highest) inputs[n++] = candidates[i];
+   return n;
+}
+
+// The floats above the top code that the scalar path still encodes to it: a half & 15/16 of a step up. Nearer the
+// next step, float rounding of the scalar encode can carry past the top code
+template<typename T> static inline cui32 verifyAbove(fl32 *inputs) {
+   constexpr ui32 top = (1u << (sizeof(T) * 8)) - 1;
+   cfl32 value = verifyDecode<T>(top), step = value - verifyDecode<T>(top - 1);
+   cfl32 candidates[2] = { value + step * 0.5f, value + step * 0.9375f };
+   ui32 n = 0;
+
+   for (ui32 i = 0; i < 2; i++) if (verifyEncode<T>(candidates[i]) == top) inputs[n++] = candidates[i];
+   return n;
+}
+
+// The codes nearest value: the scalar, truncated, code or the one above, whichever decodes closer. Either is taken
+// when they are within 1/64 of a step of a tie, where the float rounding of the encode scale decides
+template<typename T> static inline void verifyNearest(cfl32 value, ui32 &a, ui32 &b) {
+   constexpr ui32 top = (1u << (sizeof(T) * 8)) - 1;
+   cfl64 step = (fl64(verifyDecode<T>(top)) - verifyDecode<T>(0)) / top;
+   cui32 code = verifyEncode<T>(value);
+
+   a = b = code;
+   if (code == top) return;
+   cfl64 closer = (fabs(fl64(verifyDecode<T>(code)) - value) - fabs(fl64(verifyDecode<T>(code + 1)) - value)) / step;
+
+   if (closer > 1.0 / 64.0) a = b = code + 1;
+   else if (closer >= -1.0 / 64.0) b = code + 1;
+}
+
+/************
+ *  Checks  *
+ ************/
+
+// toFixed(toFloat(code)) == code for every code, or the code below if T truncates, & the largest error of encoding then
+// decoding the inputs
+template<typename T> static void verifyRoundTrip(const char *type) {
+   constexpr ui32 count = 1u << (sizeof(T) * 8);
+   cfl64 step = (fl64(verifyDecode<T>(count - 1)) - verifyDecode<T>(0)) / (count - 1);
+
+   verifyRun("round trip", VERIFY_BUILD, type, [&](verifyTotals &totals) {
+      verifyParallel(count, [&](cui32 begin, cui32 end) {
+         ui64 failures = 0; ui32 first = ~0u; fl64 error = 0.0;
+
+         for (ui32 code = begin; code < end; code++) {
+            fl32 inputs[4];
+            cui32 n = verifyInputs<T>(inputs, code);
+
+            cui32 got = verifyEncode<T>(verifyDecode<T>(code));
+
+            if (got != code && !(verifyTruncates<T>::value && got + 1 == code)) { failures++; first = code < first ? code : first; }
+            for (ui32 i = 0; i < n; i++) {
+               cfl64 e = fabs(fl64(verifyDecode<T>(verifyEncode<T>(inputs[i]))) - inputs[i]) / step;
+               error = e > error ? e : error;
+            }
+         }
+         totals.merge(end - begin, failures, first, error);
+      });
+   });
+}
+
+// fpdtToFloat & fpdtToFixed against the scalar path, at the current instruction set; truncating encodes must match it
+// bit for bit, & encodes rounded to nearest must give the code nearest each input. The inputs of the top code take
+// in the floats above it that the scalar path encodes to it
+template<typename T> static void verifyBulk(const char *type) {
+   constexpr ui32 count = 1u << (sizeof(T) * 8);
+   const char *isa = verifyISA[fpdtISA()];
+   static const char * const checks[] = { "fpdtToFixed", "fpdtToFixed nearest" };
+
+   verifyRun("fpdtToFloat", isa, type, [&](verifyTotals &totals) {
+      verifyParallel(count, [&](cui32 begin, cui32 end) {
+         ui32 codes[VERIFY_CHUNK]; fl32 floats[VERIFY_CHUNK];
+         T *src = (T *)codes;
+         ui64 failures = 0; ui32 first = ~0u;
+
+         for (ui32 code = begin; code < end; code++) {
+            if constexpr (sizeof(T) == 1) ((ui8 *)codes)[code - begin] = ui8(code);
+            else ((ui16 *)codes)[code - begin] = ui16(code);
+         }
+         fpdtToFloat(floats, src, end - begin);
+         for (ui32 code = begin; code < end; code++) {
+            cfl32 expected = verifyDecode<T>(code);
+
+            if (!verifySame(floats[code - begin], expected)) { failures++; first = code < first ? code : first; }
+         }
+         totals.merge(end - begin, failures, first, 0.0);
+      });
+   });
+   for (ui32 round = FPDT_ROUND_TRUNCATE; round <= FPDT_ROUND_NEAREST; round++) verifyRun(checks[round], isa, type, [&](verifyTotals &totals) {
+      verifyParallel(count, [&](cui32 begin, cui32 end) {
+         fl32 inputs[VERIFY_CHUNK * 4 + 2]; ui32 owners[VERIFY_CHUNK * 4 + 2], codes[VERIFY_CHUNK];
+         T *dest = (T *)codes;
+         ui32 n = 0; ui64 failures = 0; ui32 first = ~0u;
+
+         for (ui32 code = begin; code < end; code++) {
+            ui32 added = verifyInputs<T>(&inputs[n], code);
+
+            if (code == count - 1) added += verifyAbove<T>(&inputs[n + added]);
+            for (ui32 i = 0; i < added; i++) owners[n + i] = code;
+            n += added;
+         }
+         for (ui32 at = 0; at < n; at += VERIFY_CHUNK) { // dest holds VERIFY_CHUNK codes of T
+            cui32 m = n - at < VERIFY_CHUNK ? n - at : VERIFY_CHUNK;
+
+            fpdtToFixed(dest, &inputs[at], m, round);
+            for (ui32 i = 0; i < m; i++) {
+               cui32 got = sizeof(T) == 1 ? ((cui8 *)codes)[i] : ((cui16 *)codes)[i];
+               ui32 a, b;
+
+               if (round == FPDT_ROUND_NEAREST) verifyNearest<T>(inputs[at + i], a, b);
+               else a = b = verifyEncode<T>(inputs[at + i]);
+               if (got != a && got != b) { failures++; first = owners[at + i] < first ? owners[at + i] : first; }
+            }
+         }
+         totals.merge(n, failures, first, 0.0);
+      });
+   });
+}
+
+// Rounded encodes within a step of the top code of T, at the current instruction set: its value, the float below,
+// the midpoint to the code below, & the float above it, then the floats above it that the scalar path still gives
+// the top code, over a length that runs through every main loop & tail. Each must give the top code or the one
+// below; first is the lowest code given otherwise
+template<typename T> static void verifyTop(const char *type) {
+   constexpr ui32 top = (1u << (sizeof(T) * 8)) - 1, count = 61; // 32 + 16 + 13
+   cfl32 value = verifyDecode<T>(top), middle = (verifyDecode<T>(top - 1) + value) * 0.5f;
+   fl32  near[6] = { value, nextafterf(value, -INFINITY), middle, nextafterf(middle, INFINITY), value, value };
+   static const char * const checks[] = { "top nearest", "top stochastic" };
+
+   verifyAbove<T>(&near[4]); // Any it leaves out stay at the top code's value
+   for (ui32 round = FPDT_ROUND_NEAREST; round <= FPDT_ROUND_STOCHASTIC; round++) verifyRun(checks[round - FPDT_ROUND_NEAREST], verifyISA[fpdtISA()], type, [&](verifyTotals &totals) {
+      fl32 inputs[count]; ui32 codes[count];
+      T *dest = (T *)codes;
+      ui64 failures = 0; ui32 first = ~0u;
+
+      for (ui32 i = 0; i < count; i++) inputs[i] = near[i % 6];
+      for (ui32 pass = 0; pass < 64; pass++) { // Stochastic rounding draws new noise on each pass
+         fpdtToFixed(dest, inputs, count, round);
+         for (ui32 i = 0; i < count; i++) {
+            cui32 got = sizeof(T) == 1 ? ((cui8 *)codes)[i] : ((cui16 *)codes)[i];
+
+            if (got + 1 < top) { failures++; first = got < first ? got : first; }
+         }
+      }
+      totals.merge(count * 64, failures, first, 0.0);
+   });
+}
+
+// PCM24Decoder & PCM24Encoder against the scalar path of each sample, at the current instruction set, over streams of
+// 3-channel frames fed in chunks of random sizes, so that partial frames are carried over between calls. The decode
+// stream holds every 24-bit sample; the encode stream every code of a 16-bit T, or every sample & the midpoint above
+// it as floats, then NaN, the infinities, & values out of range. first is the lowest failing sample
+template<typename T> static void verifyPCM(const char *type) {
+   typedef _pcm_format<T, false> F;
+   constexpr ui32 channels = 3, most = channels * 40, decodes = 1u << 24, encodes = F::narrow ? 1u << 16 : (1u << 25) + 6;
+   static cfl32 special[] = { NAN, INFINITY, -INFINITY, 1.5f, -1.5f, -0.0f };
+   const char *isa = verifyISA[fpdtISA()];
+   auto input = [](cui32 i) -> T { // Encode input i
+      if constexpr (F::narrow) { cui16 code = ui16(i); return *(const T *)&code; }
+      else return i < (1u << 25) ? (fl32(si32(i >> 1) - 8388608) + fl32(i & 1) * 0.5f) * (1.0f / 8388608.0f) : special[i - (1u << 25)];
+   };
+
+   verifyRun("pcm decode", isa, type, [&](verifyTotals &totals) {
+      PCM24Decoder<T> decoder(channels);
+      ui8 bytes[most * 3]; T got[most + channels];
+      ui32 seed = 0x02545F491u, done = 0, first = ~0u, unused = 0;
+      ui64 failures = 0;
+
+      for (ui32 at = 0; at < decodes * 3;) { // Byte at of the stream is byte at % 3 of sample at / 3
+         cui32 chunk = 1 + _fpdt_xorshift(seed) % (most * 3), take = decodes * 3 - at < chunk ? decodes * 3 - at : chunk;
+
+         for (ui32 i = 0; i < take; i++) bytes[i] = ui8(((at + i) / 3 - 8388608u) >> ((at + i) % 3 * 8));
+         csize_t n = decoder.decode(got, bytes, take);
+
+         for (size_t i = 0; i < n; i++, done++) {
+            ui8 sample[3]; T want;
+
+            _i24_narrow1(sample, done - 8388608u);
+            _pcm_decode1<F>(std::addressof(want), sample, unused);
+            if (memcmp(std::addressof(want), std::addressof(got[i]), sizeof(T)) != 0) { failures++; first = done < first ? done : first; }
+         }
+         at += take;
+      }
+      totals.merge(done, failures, first, 0.0);
+   });
+   verifyRun("pcm encode", isa, type, [&](verifyTotals &totals) {
+      PCM24Encoder<T> encoder(channels);
+      T src[most]; ui8 got[(most + channels) * 3];
+      ui32 seed = 0x0B5AD4ECEu, done = 0, first = ~0u;
+      ui64 failures = 0;
+
+      for (ui32 at = 0; at < encodes;) {
+         cui32 chunk = 1 + _fpdt_xorshift(seed) % most, take = encodes - at < chunk ? encodes - at : chunk;
+
+         for (ui32 i = 0; i < take; i++) src[i] = input(at + i);
+         csize_t n = encoder.encode(got, src, take) / 3;
+
+         for (size_t i = 0; i < n; i++, done++) {
+            const T value = input(done); ui8 want[3];
+
+            _pcm_encode1<F>(want, std::addressof(value));
+            if (memcmp(want, got + i * 3, 3) != 0) { failures++; first = done < first ? done : first; }
+         }
+         at += take;
+      }
+      totals.merge(done, failures, first, 0.0);
+   });
+}
+
+// Vector decodes & encodes against the scalar path of each lane; vector code c holds lane codes c, c + 1, ...
+template<typename V, typename T, cui32 lanes> static void verifyVector(const char *type) {
+   typedef typename verifyFloats<lanes>::type F;
+   constexpr ui32 count = 1u << (sizeof(T) * 8);
+
+   if constexpr (requires (const V &value) { static_cast<F>(value); }) verifyRun("vector decode", VERIFY_BUILD, type, [&](verifyTotals &totals) {
+      verifyParallel(count, [&](cui32 begin, cui32 end) {
+         al64 ui8 packed[64];
+         ui64 failures = 0; ui32 first = ~0u;
+
+         for (ui32 code = begin; code < end; code++) {
+            fl32 floats[16];
+
+            for (ui32 lane = 0; lane < lanes; lane++) {
+               cui32 laneCode = (code + lane) % count;
+
+               memcpy(&packed[lane * sizeof(T)], &laneCode, sizeof(T));
+            }
+            const F decoded = static_cast<F>(*(const V *)packed);
+
+            memcpy(floats, &decoded, lanes * sizeof(fl32));
+            for (ui32 lane = 0; lane < lanes; lane++) {
+               cfl32 expected = verifyDecode<T>((code + lane) % count);
+
+               if (!verifySame(floats[lane], expected)) { failures++; first = code < first ? code : first; break; }
+            }
+         }
+         totals.merge(end - begin, failures, first, 0.0);
+      });
+   });
+   if constexpr (requires (const F &value) { V(value); }) verifyRun("vector encode", VERIFY_BUILD, type, [&](verifyTotals &totals) {
+      verifyParallel(count, [&](cui32 begin, cui32 end) {
+         ui64 values = 0, failures = 0; ui32 first = ~0u;
+
+         for (ui32 code = begin; code < end; code++) {
+            fl32 inputs[16][4]; ui32 n[16];
+
+            for (ui32 lane = 0; lane < lanes; lane++) n[lane] = verifyInputs<T>(inputs[lane], (code + lane) % count);
+            for (ui32 j = 0; j < 4; j++) { // Each lane takes its jth input, or its first when it has fewer
+               al64 fl32 floats[16] = {};
+               al64 ui8 packed[64];
+
+               for (ui32 lane = 0; lane < lanes; lane++) floats[lane] = inputs[lane][j < n[lane] ? j : 0];
+               const V encoded = V(*(const F *)floats);
+
+               memcpy(packed, std::addressof(encoded), lanes * sizeof(T));
+               values++;
+               for (ui32 lane = 0; lane < lanes; lane++) {
+                  cui32 got = sizeof(T) == 1 ? packed[lane] : ((cui16 *)packed)[lane];
+
+                  if (got != verifyEncode<T>(floats[lane])) { failures++; first = code < first ? code : first; break; }
+               }
+            }
+         }
+         totals.merge(values, failures, first, 0.0);
+      });
+   });
+}
+
+// FixedArray operators between arrays of unequal lengths, which must leave the longer one's elements past the
+// shorter count as they were, & padding at code 0, so that growing within the padded size adds code-0 elements.
+// Each case is one value; first is the lowest failing case
+template<typename T> static void verifyArray(const char *type) {
+   typedef typename FixedArray<T>::code code;
+   static const ui32 lengths[][2] = { { 29, 7 }, { 45, 3 }, { 100, 7 }, { 64, 33 }, { 17, 16 } };
+
+   verifyRun("array", VERIFY_BUILD, type, [&](verifyTotals &totals) {
+      ui64 values = 0, failures = 0; ui32 first = ~0u;
+
+      for (ui32 c = 0; c < sizeof(lengths) / sizeof(lengths[0]); c++) for (ui32 op = 0; op < 5; op++, values++) {
+         csize_t longer = lengths[c][0], shorter = lengths[c][1];
+         FixedArray<T> a(longer), b(shorter);
+
+         for (size_t i = 0; i < longer; i++) *(code *)(a.data + i) = code(i * 37 + 11);
+         for (size_t i = 0; i < shorter; i++) *(code *)(b.data + i) = code(i * 53 + 5);
+         const FixedArray<T> before(a);
+         FixedArray<T> result;
+
+         switch (op) {
+         case 0: a += b; break;
+         case 1: a -= b; break;
+         case 2: a *= b; break;
+         case 3: a.clamp(b[0], b[1]); break;
+         default: result = a + b;
+         }
+         bool good = op == 3 || !memcmp(a.data + shorter, before.data + shorter, (longer - shorter) * sizeof(T));
+
+         // Grow both within their padded sizes; every new element must be code 0
+         csize_t grownA = FixedArray<T>::padded(a.count) / sizeof(T), grownR = FixedArray<T>::padded(result.count) / sizeof(T);
+
+         a.resize(grownA); result.resize(grownR);
+         for (size_t i = longer; i < grownA; i++) good = good && *(const code *)(a.data + i) == 0;
+         for (size_t i = result.count ? shorter : 0; i < grownR; i++) good = good && *(const code *)(result.data + i) == 0;
+         if (!good) { failures++; first = c * 5 + op < first ? c * 5 + op : first; }
+      }
+      totals.merge(values, failures, first, 0.0);
+   });
+}
+
+// FixedArray +, -, *, /, scale(), & clamp() against T's own operators, element by element, over lengths that end
+// in a partial register; divisors are at least as large as their dividends, so quotients stay within range. Where
+// T's - subtracts the code of 0.0 rather than adding it back, the array's - still adds it back, as "Fixed-point
+// array.h" notes. Each element is one value; first is the lowest failing element
+template<typename T> static void verifyArrayOps(const char *type) {
+   typedef typename FixedArray<T>::code code;
+   constexpr ui32 count = 1u << (sizeof(T) * 8);
+   csize_t longer = 103, shorter = 77;
+   static const char * const checks[] = { "array +", "array -", "array *", "array /", "array scale", "array clamp" };
+
+   FixedArray<T> a(longer), b(shorter), d(shorter);
+   ui32 seed = 0x02545F491u;
+
+   for (size_t i = 0; i < longer; i++) *(code *)(a.data + i) = code(_fpdt_xorshift(seed) % count);
+   for (size_t i = 0; i < shorter; i++) {
+      *(code *)(b.data + i) = code(_fpdt_xorshift(seed) % count);
+      d.data[i] = fabsf(fl32(b.data[i])) < fabsf(fl32(a.data[i])) ? a.data[i] : b.data[i];
+      if (fl32(d.data[i]) == 0.0f) d.data[i] = T(1.0f);
+   }
+   const T floor = T(fl32(verifyDecode<T>(count / 4))), ceiling = T(fl32(verifyDecode<T>(count - count / 4)));
+   cui32 zero = ui32(FixedArray<T>::lanes::zero()), restore = verifyBits(T(0.0f) - T(0.0f)) == zero ? 0 : zero * 2;
+
+   for (ui32 op = 0; op < 6; op++) verifyRun(checks[op], VERIFY_BUILD, type, [&](verifyTotals &totals) {
+      FixedArray<T> result;
+      ui64 failures = 0; ui32 first = ~0u;
+
+      switch (op) {
+      case 0: result = a + b; break;
+      case 1: result = a - b; break;
+      case 2: result = a * b; break;
+      case 3: result = a / d; break;
+      case 4: result = a; result.scale(0.75f); break;
+      default: result = a; result.clamp(floor, ceiling);
+      }
+      for (size_t i = 0; i < result.count; i++) {
+         T expected = a.data[i];
+
+         switch (op) {
+         case 0: expected = a.data[i] + b.data[i]; break;
+         case 1: expected = a.data[i] - b.data[i]; break;
+         case 2: expected = a.data[i] * b.data[i]; break;
+         case 3: expected = a.data[i] / d.data[i]; break;
+         case 4: expected *= 0.75f; break;
+         default: expected = expected < floor ? floor : expected > ceiling ? ceiling : expected;
+         }
+         cui32 want = (verifyBits(expected) + (op == 1 ? restore : 0)) & (count - 1);
+
+         if (verifyBits(result.data[i]) != want) { failures++; first = ui32(i) < first ? ui32(i) : first; }
+      }
+      totals.merge(result.count, failures, first, 0.0);
+   });
+}
+
+/**********
+ *  Main  *
+ **********/
+
+int main(int argc, char **argv) {
+   verifyThreads = argc > 1 ? ui32(strtoul(argv[1], nullptr, 10)) : std::thread::hardware_concurrency();
+   if (!verifyThreads) verifyThreads = 1;
+   cui32 widest = fpdtISA();
+
+   printf("check,isa,type,values,failures,first,maxError,ms\n");
+#define VERIFY_ROUND_TRIP(T) verifyRoundTrip<T>(#T);
+   VERIFY_SCALARS(VERIFY_ROUND_TRIP)
+#define VERIFY_VECTOR(V, T, lanes) verifyVector<V, T, lanes>(#V);
+   VERIFY_VECTORS(VERIFY_VECTOR)
+#define VERIFY_ARRAY(T) verifyArray<T>(#T);
+   VERIFY_ARRAYS(VERIFY_ARRAY)
+#define VERIFY_ARRAY_OPS(T) verifyArrayOps<T>(#T);
+   VERIFY_ARRAYS(VERIFY_ARRAY_OPS)
+   for (ui32 isa = FPDT_ISA_SSE; isa <= widest; isa++) { // The instruction set is global, so it only changes between checks
+      fpdtSetISA(isa);
+#define VERIFY_BULK(T) verifyBulk<T>(#T);
+      VERIFY_SCALARS(VERIFY_BULK)
+#define VERIFY_TOP(T) verifyTop<T>(#T);
+      VERIFY_SCALARS(VERIFY_TOP)
+#define VERIFY_PCM(T) verifyPCM<T>(#T);
+      VERIFY_PCM_TYPES(VERIFY_PCM)
+   }
+   fpdtSetISA(widest);
+   return verifyFailed ? 1 : 0;
+}
@@ -0,0 +1,405 @@
+/**********************************************************************
+ * File: Half-precision conversion.h              Created: 2024/07/19 *
+ *                                          Last modified: 2024/07/26 *
+ *                                                                    *
+ * Desc: Bulk conversion between 32-bit floats & bfloat16 (fl16), for *
+ *       arrays of fl16, VEC16Dh, & AVX32Df16, & IEEE 754 binary16    *
+ *       halves, as scalar ieee16 & 8-lane ieee16x8 types.            *
+ *                                                                    *
+ * Notes: Encodes round to nearest even. NaNs stay NaNs, made quiet,  *
+ *        & bfloat16 denormals are flushed to signed zero, as         *
+ *        AVX512-BF16 does, so that every kernel gives the same       *
+ *        codes. Half encodes keep denormals & match vcvtps2ph.       *
+ *        Kernels are SSE, AVX2, or AVX512, chosen by fpdtISA(), with *
+ *        scalar tails; encodes use vcvtne2ps2bf16 when the host has  *
+ *        AVX512-BF16, half kernels use F16C, & ieee16x8 arithmetic   *
+ *        is native when the host has AVX512-FP16.                    *
+ *                                                                    *
+ * MIT license.                     Copyright (c) David William Bull. *
+ **********************************************************************/
+#pragma once
+
+#include "vector structures.h"
+#include "Fixed-point CPU dispatch.h"
+
+#define _HALF_PRECISION_CONVERSION_
+
+/**************
+ *  bfloat16  *
+ **************/
+
+static inline cui16 _fph_toBF16(cfl32 value) {
+   cui32 bits = (ui32 &)value;
+
+   if ((bits & 0x07FFFFFFF) > 0x07F800000) return ui16((bits >> 16) | 0x040);
+   if (!(bits & 0x07F800000)) return ui16((bits >> 16) & 0x08000);
+   return ui16((bits + 0x07FFF + ((bits >> 16) & 1)) >> 16);
+}
+
+static inline cfl32 _fph_fromBF16(cui16 code) { cui32 bits = ui32(code) << 16; return (fl32 &)bits; }
+
+// As _fph_toBF16(), leaving codes in the low 16 bits of each lane
+static inline csi128 _fph_toBF16SSE(cfl32x4 value) {
+   csi128 bits = _mm_castps_si128(value), magnitude = _mm_and_si128(bits, _mm_set1_epi32(0x07FFFFFFF));
+   csi128 rounded = _mm_add_epi32(_mm_add_epi32(bits, _mm_set1_epi32(0x07FFF)), _mm_and_si128(_mm_srli_epi32(bits, 16), _mm_set1_epi32(1)));
+   si128 code = _mm_blendv_epi8(rounded, _mm_or_si128(bits, _mm_set1_epi32(0x0400000)), _mm_cmpgt_epi32(magnitude, _mm_set1_epi32(0x07F800000)));
+
+   code = _mm_blendv_epi8(code, _mm_and_si128(bits, _mm_set1_epi32(0x080000000)), _mm_cmpeq_epi32(_mm_and_si128(bits, _mm_set1_epi32(0x07F800000)), _mm_setzero_si128()));
+   return _mm_srli_epi32(code, 16);
+}
+
+static inline void _fph_encodeBF16SSE(ui16 *dest, cfl32 *src, csize_t count) {
+   size_t i = 0;
+
+   for (; i + 8 <= count; i += 8)
+      _mm_storeu_si128((si128 *)&dest[i], _mm_packus_epi32(_fph_toBF16SSE(_mm_loadu_ps(&src[i])), _fph_toBF16SSE(_mm_loadu_ps(&src[i + 4]))));
+   for (; i < count; i++) dest[i] = _fph_toBF16(src[i]);
+}
+
+static inline void _fph_decodeBF16SSE(fl32 *dest, cui16 *src, csize_t count) {
+   size_t i = 0;
+
+   for (; i + 8 <= count; i += 8) {
+      csi128 codes = _mm_loadu_si128((csi128 *)&src[i]);
+
+      _mm_storeu_si128((si128 *)&dest[i], _mm_unpacklo_epi16(_mm_setzero_si128(), codes));
+      _mm_storeu_si128((si128 *)&dest[i + 4], _mm_unpackhi_epi16(_mm_setzero_si128(), codes));
+   }
+   for (; i < count; i++) dest[i] = _fph_fromBF16(src[i]);
+}
+
+#ifdef _FPDT_KERNELS_AVX2_
+static inline _FPDT_TARGET_AVX2_ csi256 _fph_toBF16AVX2(cfl32x8 value) {
+   csi256 bits = _mm256_castps_si256(value), magnitude = _mm256_and_si256(bits, _mm256_set1_epi32(0x07FFFFFFF));
+   csi256 rounded = _mm256_add_epi32(_mm256_add_epi32(bits, _mm256_set1_epi32(0x07FFF)), _mm256_and_si256(_mm256_srli_epi32(bits, 16), _mm256_set1_epi32(1)));
+   si256 code = _mm256_blendv_epi8(rounded, _mm256_or_si256(bits, _mm256_set1_epi32(0x0400000)), _mm256_cmpgt_epi32(magnitude, _mm256_set1_epi32(0x07F800000)));
+
+   code = _mm256_blendv_epi8(code, _mm256_and_si256(bits, _mm256_set1_epi32(0x080000000)), _mm256_cmpeq_epi32(_mm256_and_si256(bits, _mm256_set1_epi32(0x07F800000)), _mm256_setzero_si256()));
+   return _mm256_srli_epi32(code, 16);
+}
+
+static inline _FPDT_TARGET_AVX2_ void _fph_encodeBF16AVX2(ui16 *dest, cfl32 *src, csize_t count) {
+   size_t i = 0;
+
+   // The packs interleave the two sources by 128-bit lane; the permute restores their order
+   for (; i + 16 <= count; i += 16) {
+      csi256 codes = _mm256_packus_epi32(_fph_toBF16AVX2(_mm256_loadu_ps(&src[i])), _fph_toBF16AVX2(_mm256_loadu_ps(&src[i + 8])));
+
+      _mm256_storeu_si256((si256 *)&dest[i], _mm256_permute4x64_epi64(codes, 0x0D8));
+   }
+   _fph_encodeBF16SSE(&dest[i], &src[i], count - i);
+}
+
+static inline _FPDT_TARGET_AVX2_ void _fph_decodeBF16AVX2(fl32 *dest, cui16 *src, csize_t count) {
+   size_t i = 0;
+
+   for (; i + 16 <= count; i += 16) {
+      _mm256_storeu_si256((si256 *)&dest[i], _mm256_slli_epi32(_mm256_cvtepu16_epi32(_mm_loadu_si128((csi128 *)&src[i])), 16));
+      _mm256_storeu_si256((si256 *)&dest[i + 8], _mm256_slli_epi32(_mm256_cvtepu16_epi32(_mm_loadu_si128((csi128 *)&src[i + 8])), 16));
+   }
+   _fph_decodeBF16SSE(&dest[i], &src[i], count - i);
+}
+#endif
+
+#ifdef _FPDT_KERNELS_AVX512_
+static inline _FPDT_TARGET_AVX512_ csi512 _fph_toBF16AVX512(cfl32x16 value) {
+   csi512 bits = _mm512_castps_si512(value);
+   csi512 rounded = _mm512_add_epi32(_mm512_add_epi32(bits, _mm512_set1_epi32(0x07FFF)), _mm512_and_si512(_mm512_srli_epi32(bits, 16), _mm512_set1_epi32(1)));
+   si512 code = _mm512_mask_or_epi32(rounded, _mm512_cmpgt_epi32_mask(_mm512_and_si512(bits, _mm512_set1_epi32(0x07FFFFFFF)), _mm512_set1_epi32(0x07F800000)), bits, _mm512_set1_epi32(0x0400000));
+
+   code = _mm512_mask_and_epi32(code, _mm512_testn_epi32_mask(bits, _mm512_set1_epi32(0x07F800000)), bits, _mm512_set1_epi32(0x080000000));
+   return _mm512_srli_epi32(code, 16);
+}
+
+static inline _FPDT_TARGET_AVX512_ void _fph_encodeBF16AVX512(ui16 *dest, cfl32 *src, csize_t count) {
+   size_t i = 0;
+
+   for (; i + 16 <= count; i += 16) _mm256_storeu_si256((si256 *)&dest[i], _mm512_cvtepi32_epi16(_fph_toBF16AVX512(_mm512_loadu_ps(&src[i]))));
+   _fph_encodeBF16SSE(&dest[i], &src[i], count - i);
+}
+
+static inline _FPDT_TARGET_AVX512_ void _fph_decodeBF16AVX512(fl32 *dest, cui16 *src, csize_t count) {
+   size_t i = 0;
+
+   for (; i + 16 <= count; i += 16) _mm512_storeu_si512(&dest[i], _mm512_slli_epi32(_mm512_cvtepu16_epi32(_mm256_loadu_si256((csi256 *)&src[i])), 16));
+   _fph_decodeBF16SSE(&dest[i], &src[i], count - i);
+}
+#endif
+
+#ifdef _FPDT_KERNELS_BF16_
+// 32 floats per instruction; the low source fills the low half of the result
+static inline void _fph_encodeBF16Native(ui16 *dest, cfl32 *src, csize_t count) {
+   size_t i = 0;
+
+   for (; i + 32 <= count; i += 32) {
+      __m512bh codes = _mm512_cvtne2ps_pbh(_mm512_loadu_ps(&src[i + 16]), _mm512_loadu_ps(&src[i]));
+
+      _mm512_storeu_si512(&dest[i], (si512 &)codes);
+   }
+   _fph_encodeBF16SSE(&dest[i], &src[i], count - i);
+}
+#endif
+
+/*
+ *  Kernel tables, indexed by fpdtISA()
+ */
+
+static decltype(&_fph_encodeBF16SSE) const _fph_encodeBF16ISA[] = _FPDT_KERNELS_(_fph_encodeBF16);
+static decltype(&_fph_decodeBF16SSE) const _fph_decodeBF16ISA[] = _FPDT_KERNELS_(_fph_decodeBF16);
+
+// AVX512-BF16 is an extension of AVX512, so is only taken when the AVX512 kernels are
+static inline decltype(&_fph_encodeBF16SSE) _fph_encodeBF16Kernel(void) {
+   cui32 isa = fpdtISA();
+
+#ifdef _FPDT_KERNELS_BF16_
+   if (isa == FPDT_ISA_AVX512 && (fpdtCPUFeatures() & FPDT_CPU_BF16)) return _fph_encodeBF16Native;
+#endif
+   return _fph_encodeBF16ISA[isa];
+}
+
+// Convert count 32-bit floats to bfloat16, rounded to nearest even
+inline void fpdtToBF16(fl16 *dest, cfl32 *src, csize_t count) { _fph_encodeBF16Kernel()((ui16 *)dest, src, count); }
+inline void fpdtToBF16(VEC16Dh *dest, cfl32 *src, csize_t count) { _fph_encodeBF16Kernel()((ui16 *)dest, src, count * 16); }
+inline void fpdtToBF16(AVX32Df16 *dest, cfl32 *src, csize_t count) { _fph_encodeBF16Kernel()((ui16 *)dest, src, count * 32); }
+
+// Convert count bfloat16 values, or vectors of them, to 32-bit floats
+inline void fpdtToFloat(fl32 *dest, cfl16 *src, csize_t count) { _fph_decodeBF16ISA[fpdtISA()](dest, (cui16 *)src, count); }
+inline void fpdtToFloat(fl32 *dest, cVEC16Dh *src, csize_t count) { _fph_decodeBF16ISA[fpdtISA()](dest, (cui16 *)src, count * 16); }
+inline void fpdtToFloat(fl32 *dest, cAVX32Df16 *src, csize_t count) { _fph_decodeBF16ISA[fpdtISA()](dest, (cui16 *)src, count * 32); }
+
+/***************
+ *  IEEE half  *
+ ***************/
+
+// The inline types only assume F16C where the compiler is allowed to emit it; the AVX2 kernels take it with AVX2
+#if defined(__F16C__) || (defined(_MSC_VER) && defined(__AVX2__))
+#define _FPH_F16C_
+#endif
+
+// As vcvtps2ph with round to nearest even: NaNs stay NaNs, made quiet, overflows become infinity, & denormals are kept
+static inline cui16 _fph_toHalf(cfl32 value) {
+   cui32 bits = (ui32 &)value, sign = (bits >> 16) & 0x08000, magnitude = bits & 0x07FFFFFFF;
+
+   if (magnitude > 0x07F800000) return ui16(sign | 0x07E00 | ((magnitude >> 13) & 0x03FF));
+   if (magnitude >= 0x0477FF000) return ui16(sign | 0x07C00);
+   if (magnitude < 0x038800000) { // Below 2^-14, denormal: adding 0.5, whose step is 2^-24, rounds to it
+      cui32 absBits = magnitude;
+      cfl32 sum = (fl32 &)absBits + 0.5f;
+      return ui16(sign | ((ui32 &)sum - 0x03F000000));
+   }
+   cui32 rebased = magnitude - (112 << 23);
+   return ui16(sign | ((rebased + 0x0FFF + ((rebased >> 13) & 1)) >> 13));
+}
+
+// Codes are shifted to the top of a float's mantissa, then rebiased; denormals add 2^-14 as a normal, & subtract it
+static inline cfl32 _fph_fromHalf(cui16 code) {
+   cui32 bits = ui32(code & 0x07FFF) << 13, exponent = bits & 0x0F800000, sign = ui32(code & 0x08000) << 16;
+   ui32 temp;
+
+   if (!exponent) { temp = bits + (113 << 23); cfl32 value = (fl32 &)temp - 6.103515625e-05f; temp = (ui32 &)value | sign; }
+   else if (exponent != 0x0F800000) temp = (bits + (112 << 23)) | sign;
+   else temp = (bits + (224 << 23)) | (bits > 0x0F800000 ? 0x0400000 : 0) | sign; // As vcvtph2ps, NaNs are made quiet
+   return (fl32 &)temp;
+}
+
+// Kernels for hosts without F16C, as _fph_toHalf() & _fph_fromHalf(), leaving codes in the low 16 bits of each lane
+static inline csi128 _fph_toHalfSSE(cfl32x4 value) {
+   csi128 bits = _mm_castps_si128(value), magnitude = _mm_and_si128(bits, _mm_set1_epi32(0x07FFFFFFF));
+   csi128 sign = _mm_and_si128(_mm_srli_epi32(bits, 16), _mm_set1_epi32(0x08000)), rebased = _mm_sub_epi32(magnitude, _mm_set1_epi32(112 << 23));
+   csi128 denormal = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(magnitude), _mm_set1_ps(0.5f))), _mm_set1_epi32(0x03F000000));
+   si128 code = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(rebased, _mm_set1_epi32(0x0FFF)), _mm_and_si128(_mm_srli_epi32(rebased, 13), _mm_set1_epi32(1))), 13);
+
+   code = _mm_blendv_epi8(code, denormal, _mm_cmplt_epi32(magnitude, _mm_set1_epi32(0x038800000)));
+   code = _mm_blendv_epi8(code, _mm_set1_epi32(0x07C00), _mm_cmpgt_epi32(magnitude, _mm_set1_epi32(0x0477FEFFF)));
+   code = _mm_blendv_epi8(code, _mm_or_si128(_mm_and_si128(_mm_srli_epi32(magnitude, 13), _mm_set1_epi32(0x03FF)), _mm_set1_epi32(0x07E00)), _mm_cmpgt_epi32(magnitude, _mm_set1_epi32(0x07F800000)));
+   return _mm_or_si128(code, sign);
+}
+
+static inline cfl32x4 _fph_fromHalfSSE(csi128 code) {
+   csi128 bits = _mm_slli_epi32(_mm_and_si128(code, _mm_set1_epi32(0x07FFF)), 13), exponent = _mm_and_si128(bits, _mm_set1_epi32(0x0F800000));
+   csi128 special = _mm_and_si128(_mm_cmpeq_epi32(exponent, _mm_set1_epi32(0x0F800000)), _mm_set1_epi32(112 << 23));
+   csi128 quiet = _mm_and_si128(_mm_cmpgt_epi32(bits, _mm_set1_epi32(0x0F800000)), _mm_set1_epi32(0x0400000));
+   cfl32x4 normal = _mm_castsi128_ps(_mm_or_si128(_mm_add_epi32(_mm_add_epi32(bits, _mm_set1_epi32(112 << 23)), special), quiet));
+   cfl32x4 denormal = _mm_sub_ps(_mm_castsi128_ps(_mm_add_epi32(bits, _mm_set1_epi32(113 << 23))), _mm_set1_ps(6.103515625e-05f));
+   cfl32x4 value = _mm_blendv_ps(normal, denormal, _mm_castsi128_ps(_mm_cmpeq_epi32(exponent, _mm_setzero_si128())));
+
+   return _mm_or_ps(value, _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(code, _mm_set1_epi32(0x08000)), 16)));
+}
+
+static inline void _fph_encodeHalfSSE(ui16 *dest, cfl32 *src, csize_t count) {
+   size_t i = 0;
+
+   for (; i + 8 <= count; i += 8)
+      _mm_storeu_si128((si128 *)&dest[i], _mm_packus_epi32(_fph_toHalfSSE(_mm_loadu_ps(&src[i])), _fph_toHalfSSE(_mm_loadu_ps(&src[i + 4]))));
+   for (; i < count; i++) dest[i] = _fph_toHalf(src[i]);
+}
+
+static inline void _fph_decodeHalfSSE(fl32 *dest, cui16 *src, csize_t count) {
+   size_t i = 0;
+
+   for (; i + 8 <= count; i += 8) {
+      csi128 codes = _mm_loadu_si128((csi128 *)&src[i]);
+
+      _mm_storeu_ps(&dest[i], _fph_fromHalfSSE(_mm_unpacklo_epi16(codes, _mm_setzero_si128())));
+      _mm_storeu_ps(&dest[i + 4], _fph_fromHalfSSE(_mm_unpackhi_epi16(codes, _mm_setzero_si128())));
+   }
+   for (; i < count; i++) dest[i] = _fph_fromHalf(src[i]);
+}
+
+#ifdef _FPDT_KERNELS_AVX2_
+static inline _FPDT_TARGET_AVX2_ void _fph_encodeHalfAVX2(ui16 *dest, cfl32 *src, csize_t count) {
+   size_t i = 0;
+
+   for (; i + 16 <= count; i += 16) {
+      _mm_storeu_si128((si128 *)&dest[i], _mm256_cvtps_ph(_mm256_loadu_ps(&src[i]), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+      _mm_storeu_si128((si128 *)&dest[i + 8], _mm256_cvtps_ph(_mm256_loadu_ps(&src[i + 8]), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+   }
+   for (; i < count; i++) dest[i] = _fph_toHalf(src[i]);
+}
+
+static inline _FPDT_TARGET_AVX2_ void _fph_decodeHalfAVX2(fl32 *dest, cui16 *src, csize_t count) {
+   size_t i = 0;
+
+   for (; i + 16 <= count; i += 16) {
+      _mm256_storeu_ps(&dest[i], _mm256_cvtph_ps(_mm_loadu_si128((csi128 *)&src[i])));
+      _mm256_storeu_ps(&dest[i + 8], _mm256_cvtph_ps(_mm_loadu_si128((csi128 *)&src[i + 8])));
+   }
+   for (; i < count; i++) dest[i] = _fph_fromHalf(src[i]);
+}
+#endif
+
+#ifdef _FPDT_KERNELS_AVX512_
+static inline _FPDT_TARGET_AVX512_ void _fph_encodeHalfAVX512(ui16 *dest, cfl32 *src, csize_t count) {
+   size_t i = 0;
+
+   for (; i + 16 <= count; i += 16) _mm256_storeu_si256((si256 *)&dest[i], _mm512_cvtps_ph(_mm512_loadu_ps(&src[i]), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+   if (i < count) { // Masked tail
+      const __mmask16 mask = __mmask16((1u << (count - i)) - 1u);
+      _mm256_mask_storeu_epi16(&dest[i], mask, _mm512_cvtps_ph(_mm512_maskz_loadu_ps(mask, &src[i]), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+   }
+}
+
+static inline _FPDT_TARGET_AVX512_ void _fph_decodeHalfAVX512(fl32 *dest, cui16 *src, csize_t count) {
+   size_t i = 0;
+
+   for (; i + 16 <= count; i += 16) _mm512_storeu_ps(&dest[i], _mm512_cvtph_ps(_mm256_loadu_si256((csi256 *)&src[i])));
+   if (i < count) {
+      const __mmask16 mask = __mmask16((1u << (count - i)) - 1u);
+      _mm512_mask_storeu_ps(&dest[i], mask, _mm512_cvtph_ps(_mm256_maskz_loadu_epi16(mask, &src[i])));
+   }
+}
+#endif
+
+static decltype(&_fph_encodeHalfSSE) const _fph_encodeHalfISA[] = _FPDT_KERNELS_(_fph_encodeHalf);
+static decltype(&_fph_decodeHalfSSE) const _fph_decodeHalfISA[] = _FPDT_KERNELS_(_fph_decodeHalf);
+
+// 16-bit, IEEE 754 binary16 : Decimal range of -65504.0~65504.0, with denormals, infinities, & NaNs
+struct ieee16 {
+   typedef const ieee16 cieee16;
+
+   ui16 data;
+
+#ifdef _FPH_F16C_
+   inline cui16 toFixed(cfl32 &value) const { return ui16(_mm_extract_epi16(_mm_cvtps_ph(_mm_set_ss(value), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC), 0)); }
+   inline cfl32 toFloat(void) const { return _mm_cvtss_f32(_mm_cvtph_ps(_mm_cvtsi32_si128(data))); }
+#else
+   inline cui16 toFixed(cfl32 &value) const { return _fph_toHalf(value); }
+   inline cfl32 toFloat(void) const { return _fph_fromHalf(data); }
+#endif
+
+   ieee16(void) = default;
+   ieee16(cui16 value) { data = value; }
+   ieee16(cfl32 value) { data = toFixed(value); }
+
+   operator cfl32(void) const { return toFloat(); }
+
+   // Each operation is done in 32-bit float, which has over twice the precision of a half, so rounding the result once more gives the correctly rounded half
+   inline cieee16 operator-(void) const { return ieee16(ui16(data ^ 0x08000)); }
+   inline cieee16 operator+(cieee16 &value) const { return ieee16(toFloat() + value.toFloat()); }
+   inline cieee16 operator-(cieee16 &value) const { return ieee16(toFloat() - value.toFloat()); }
+   inline cieee16 operator*(cieee16 &value) const { return ieee16(toFloat() * value.toFloat()); }
+   inline cieee16 operator/(cieee16 &value) const { return ieee16(toFloat() / value.toFloat()); }
+   inline cieee16 operator+=(cieee16 &value) { data = toFixed(toFloat() + value.toFloat()); return *this; }
+   inline cieee16 operator-=(cieee16 &value) { data = toFixed(toFloat() - value.toFloat()); return *this; }
+   inline cieee16 operator*=(cieee16 &value) { data = toFixed(toFloat() * value.toFloat()); return *this; }
+   inline cieee16 operator/=(cieee16 &value) { data = toFixed(toFloat() / value.toFloat()); return *this; }
+
+   inline cbool operator==(cieee16 &value) const { return toFloat() == value.toFloat(); }
+   inline cbool operator!=(cieee16 &value) const { return toFloat() != value.toFloat(); }
+   inline cbool operator<(cieee16 &value) const { return toFloat() < value.toFloat(); }
+   inline cbool operator>(cieee16 &value) const { return toFloat() > value.toFloat(); }
+   inline cbool operator<=(cieee16 &value) const { return toFloat() <= value.toFloat(); }
+   inline cbool operator>=(cieee16 &value) const { return toFloat() >= value.toFloat(); }
+};
+
+typedef const ieee16 cieee16;
+
+#ifdef _FPH_F16C_
+#ifdef _FPDT_KERNELS_FP16_
+// Whether ieee16x8 arithmetic is native, resolved on first use; ~0 means not yet resolved. As both paths give the
+// same results, a later fpdtSetISA() leaves it as it is
+inline vui32 __fph_native__ = ~0u;
+
+// AVX512-FP16 is an extension of AVX512, so is only taken when the AVX512 kernels are
+static inline cbool _fph_nativeHalf(void) {
+   ui32 native = __fph_native__;
+
+   if (native == ~0u) __fph_native__ = native = fpdtISA() == FPDT_ISA_AVX512 && (fpdtCPUFeatures() & FPDT_CPU_FP16);
+   return native != 0;
+}
+#endif
+
+// 8x 16-bit, IEEE 754 binary16; arithmetic is native when the host has AVX512-FP16, else done in 32-bit floats with F16C, with the same results
+struct ieee16x8 {
+   typedef const ieee16x8 cieee16x8;
+
+   union { si128 xmm; ieee16 data[8]; ui16 data16[8]; };
+
+   ieee16x8(void) = default;
+   ieee16x8(cieee16 value) { xmm = _mm_set1_epi16(si16(value.data)); }
+   ieee16x8(cfl32 value) { xmm = _mm_set1_epi16(si16(ieee16(value).data)); }
+   ieee16x8(cfl32x8 value) { xmm = _mm256_cvtps_ph(value, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+   ieee16x8(cieee16 (&value)[8]) { xmm = _mm_loadu_si128((csi128 *)value); }
+
+   operator cfl32x8(void) const { return _mm256_cvtph_ps(xmm); }
+
+   inline cieee16x8 operator-(void) const { ieee16x8 temp; temp.xmm = _mm_xor_si128(xmm, _mm_set1_epi16(si16(0x08000))); return temp; }
+
+   inline cieee16x8 operator+(cieee16x8 &value) const {
+#ifdef _FPDT_KERNELS_FP16_
+      if (_fph_nativeHalf()) { ieee16x8 temp; temp.xmm = _mm_castph_si128(_mm_add_ph(_mm_castsi128_ph(xmm), _mm_castsi128_ph(value.xmm))); return temp; }
+#endif
+      return ieee16x8(_mm256_add_ps(_mm256_cvtph_ps(xmm), _mm256_cvtph_ps(value.xmm)));
+   }
+   inline cieee16x8 operator-(cieee16x8 &value) const {
+#ifdef _FPDT_KERNELS_FP16_
+      if (_fph_nativeHalf()) { ieee16x8 temp; temp.xmm = _mm_castph_si128(_mm_sub_ph(_mm_castsi128_ph(xmm), _mm_castsi128_ph(value.xmm))); return temp; }
+#endif
+      return ieee16x8(_mm256_sub_ps(_mm256_cvtph_ps(xmm), _mm256_cvtph_ps(value.xmm)));
+   }
+   inline cieee16x8 operator*(cieee16x8 &value) const {
+#ifdef _FPDT_KERNELS_FP16_
+      if (_fph_nativeHalf()) { ieee16x8 temp; temp.xmm = _mm_castph_si128(_mm_mul_ph(_mm_castsi128_ph(xmm), _mm_castsi128_ph(value.xmm))); return temp; }
+#endif
+      return ieee16x8(_mm256_mul_ps(_mm256_cvtph_ps(xmm), _mm256_cvtph_ps(value.xmm)));
+   }
+   inline cieee16x8 operator/(cieee16x8 &value) const {
+#ifdef _FPDT_KERNELS_FP16_
+      if (_fph_nativeHalf()) { ieee16x8 temp; temp.xmm = _mm_castph_si128(_mm_div_ph(_mm_castsi128_ph(xmm), _mm_castsi128_ph(value.xmm))); return temp; }
+#endif
+      return ieee16x8(_mm256_div_ps(_mm256_cvtph_ps(xmm), _mm256_cvtph_ps(value.xmm)));
+   }
+   inline cieee16x8 operator+=(cieee16x8 &value) { return *this = *this + value; }
+   inline cieee16x8 operator-=(cieee16x8 &value) { return *this = *this - value; }
+   inline cieee16x8 operator*=(cieee16x8 &value) { return *this = *this * value; }
+   inline cieee16x8 operator/=(cieee16x8 &value) { return *this = *this / value; }
+};
+
+typedef const ieee16x8 cieee16x8;
+#endif
+
+// Convert count 32-bit floats to IEEE halves, rounded to nearest even
+inline void fpdtToHalf(ieee16 *dest, cfl32 *src, csize_t count) { _fph_encodeHalfISA[fpdtISA()]((ui16 *)dest, src, count); }
+
+// Convert count IEEE halves to 32-bit floats
+inline void fpdtToFloat(fl32 *dest, cieee16 *src, csize_t count) { _fph_decodeHalfISA[fpdtISA()](dest, (cui16 *)src, count); }
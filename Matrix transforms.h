@@ -0,0 +1,313 @@
+/**********************************************************************
+ * File: Matrix transforms.h                      Created: 2024/07/16 *
+ *                                          Last modified: 2024/07/26 *
+ *                                                                    *
+ * Desc: Operations on AVXmatrix & AVX512matrix, the 4x4 float        *
+ *       matrices of "vector structures.h": multiply, transpose, &    *
+ *       inverse on their ymm & zmm members, plus batched transforms  *
+ *       of VEC3Df, VEC4Df, & SSE4Df32 arrays.                        *
+ *                                                                    *
+ * Notes: Matrices are row-major, vector[r] being row r, & points are *
+ *        row vectors, so p * M = p.x * row 0 + p.y * row 1 + p.z *   *
+ *        row 2 + p.w * row 3; translations are in row 3, & A * B     *
+ *        applies A, then B.                                          *
+ *        AVXmatrix operations require AVX2 & FMA, AVX512matrix ones  *
+ *        AVX512F; compilers other than MSVC only declare them when   *
+ *        those instruction sets are enabled at compile time.         *
+ *        Batched transforms take either matrix type, & run SSE,      *
+ *        AVX2, or AVX512 kernels chosen by fpdtISA(), with masked or *
+ *        scalar tails; dest may be src.                              *
+ *        The inverse of a singular matrix has infinite or NaN        *
+ *        elements.                                                   *
+ *                                                                    *
+ * MIT license.                     Copyright (c) David William Bull. *
+ **********************************************************************/
+#pragma once
+
+#include "vector structures.h"
+#include "Fixed-point CPU dispatch.h"
+
+#define _MATRIX_TRANSFORMS_
+
+#if defined(_MSC_VER) || defined(__FMA__)
+#define _MTX_FMADD256_(a, b, c) _mm256_fmadd_ps(a, b, c)
+#else
+#define _MTX_FMADD256_(a, b, c) _mm256_add_ps(_mm256_mul_ps(a, b), c)
+#endif
+
+/**************
+ *  Matrices  *
+ **************/
+
+// Inverse of four rows by 2x2 blocks, M = | A B |, each block held as (m00, m01, m10, m11)
+//                                         | C D |
+static inline void _mtx_inverse(const __m128 (&m)[4], __m128 (&inverse)[4]) {
+   cfl32x4 a = _mm_movelh_ps(m[0], m[1]), b = _mm_movehl_ps(m[1], m[0]);
+   cfl32x4 c = _mm_movelh_ps(m[2], m[3]), d = _mm_movehl_ps(m[3], m[2]);
+
+   // Determinants of the blocks, (|A|, |B|, |C|, |D|)
+   cfl32x4 dets = _mm_sub_ps(_mm_mul_ps(_mm_shuffle_ps(m[0], m[2], 0x88), _mm_shuffle_ps(m[1], m[3], 0xDD)),
+                             _mm_mul_ps(_mm_shuffle_ps(m[0], m[2], 0xDD), _mm_shuffle_ps(m[1], m[3], 0x88)));
+   cfl32x4 detA = _mm_shuffle_ps(dets, dets, 0x00), detB = _mm_shuffle_ps(dets, dets, 0x55);
+   cfl32x4 detC = _mm_shuffle_ps(dets, dets, 0xAA), detD = _mm_shuffle_ps(dets, dets, 0xFF);
+
+   // 2x2 products X * Y, adj(X) * Y, & X * adj(Y)
+   const auto mul = [](cfl32x4 x, cfl32x4 y) { return _mm_add_ps(_mm_mul_ps(x, _mm_shuffle_ps(y, y, 0xCC)), _mm_mul_ps(_mm_shuffle_ps(x, x, 0xB1), _mm_shuffle_ps(y, y, 0x66))); };
+   const auto adjMul = [](cfl32x4 x, cfl32x4 y) { return _mm_sub_ps(_mm_mul_ps(_mm_shuffle_ps(x, x, 0x0F), y), _mm_mul_ps(_mm_shuffle_ps(x, x, 0xA5), _mm_shuffle_ps(y, y, 0x4E))); };
+   const auto mulAdj = [](cfl32x4 x, cfl32x4 y) { return _mm_sub_ps(_mm_mul_ps(x, _mm_shuffle_ps(y, y, 0x33)), _mm_mul_ps(_mm_shuffle_ps(x, x, 0xB1), _mm_shuffle_ps(y, y, 0x66))); };
+
+   cfl32x4 adjDC = adjMul(d, c), adjAB = adjMul(a, b);
+
+   // Adjugates of the blocks of the inverse, scaled by |M|
+   fl32x4 x = _mm_sub_ps(_mm_mul_ps(detD, a), mul(b, adjDC));
+   fl32x4 w = _mm_sub_ps(_mm_mul_ps(detA, d), mul(c, adjAB));
+   fl32x4 y = _mm_sub_ps(_mm_mul_ps(detB, c), mulAdj(d, adjAB));
+   fl32x4 z = _mm_sub_ps(_mm_mul_ps(detC, b), mulAdj(a, adjDC));
+
+   // |M| = |A| * |D| + |B| * |C| - trace(adj(A) * B * adj(D) * C)
+   fl32x4 trace = _mm_mul_ps(adjAB, _mm_shuffle_ps(adjDC, adjDC, 0xD8));
+   trace = _mm_add_ps(trace, _mm_shuffle_ps(trace, trace, 0x4E));
+   trace = _mm_add_ps(trace, _mm_shuffle_ps(trace, trace, 0xB1));
+
+   cfl32x4 det = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), trace);
+   cfl32x4 rcpDet = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), det);
+
+   x = _mm_mul_ps(x, rcpDet); y = _mm_mul_ps(y, rcpDet);
+   z = _mm_mul_ps(z, rcpDet); w = _mm_mul_ps(w, rcpDet);
+
+   // Adjugate each block back while interleaving them into rows
+   inverse[0] = _mm_shuffle_ps(x, y, 0x77);
+   inverse[1] = _mm_shuffle_ps(x, y, 0x22);
+   inverse[2] = _mm_shuffle_ps(z, w, 0x77);
+   inverse[3] = _mm_shuffle_ps(z, w, 0x22);
+}
+
+#if defined(_MSC_VER) || defined(__AVX2__)
+// a * b
+inline cAVXmatrix MatMultiply(cAVXmatrix &a, cAVXmatrix &b) {
+   cfl32x8 row0 = _mm256_broadcast_ps(&b.xmm[0]), row1 = _mm256_broadcast_ps(&b.xmm[1]);
+   cfl32x8 row2 = _mm256_broadcast_ps(&b.xmm[2]), row3 = _mm256_broadcast_ps(&b.xmm[3]);
+   AVXmatrix result;
+
+   for (ui32 i = 0; i < 2; i++) {
+      fl32x8 rows = _mm256_mul_ps(_mm256_permute_ps(a.ymm[i], 0x00), row0);
+
+      rows = _MTX_FMADD256_(_mm256_permute_ps(a.ymm[i], 0x55), row1, rows);
+      rows = _MTX_FMADD256_(_mm256_permute_ps(a.ymm[i], 0xAA), row2, rows);
+      result.ymm[i] = _MTX_FMADD256_(_mm256_permute_ps(a.ymm[i], 0xFF), row3, rows);
+   }
+   return result;
+}
+
+inline cAVXmatrix MatTranspose(cAVXmatrix &m) {
+   cfl32x8 rows02 = _mm256_permute2f128_ps(m.ymm[0], m.ymm[1], 0x20), rows13 = _mm256_permute2f128_ps(m.ymm[0], m.ymm[1], 0x31);
+   AVXmatrix result;
+
+   // Pairs of columns, (x0 x1 y0 y1 | x2 x3 y2 y3) & (z0 z1 w0 w1 | z2 z3 w2 w3), then their 64-bit halves in order
+   result.ymm[0] = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(_mm256_unpacklo_ps(rows02, rows13)), 0xD8));
+   result.ymm[1] = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(_mm256_unpackhi_ps(rows02, rows13)), 0xD8));
+   return result;
+}
+
+inline cAVXmatrix MatInverse(cAVXmatrix &m) {
+   AVXmatrix result;
+
+   _mtx_inverse(m.xmm, result.xmm);
+   return result;
+}
+
+inline cAVXmatrix operator*(cAVXmatrix &a, cAVXmatrix &b) { return MatMultiply(a, b); }
+#endif
+
+#if defined(_MSC_VER) || defined(__AVX512F__)
+// a * b
+inline cAVX512matrix MatMultiply(cAVX512matrix &a, cAVX512matrix &b) {
+   AVX512matrix result;
+
+   // Element j of each row of a, by row j of b in every lane
+   result.zmm = _mm512_mul_ps(_mm512_permute_ps(a.zmm, 0x00), _mm512_shuffle_f32x4(b.zmm, b.zmm, 0x00));
+   result.zmm = _mm512_fmadd_ps(_mm512_permute_ps(a.zmm, 0x55), _mm512_shuffle_f32x4(b.zmm, b.zmm, 0x55), result.zmm);
+   result.zmm = _mm512_fmadd_ps(_mm512_permute_ps(a.zmm, 0xAA), _mm512_shuffle_f32x4(b.zmm, b.zmm, 0xAA), result.zmm);
+   result.zmm = _mm512_fmadd_ps(_mm512_permute_ps(a.zmm, 0xFF), _mm512_shuffle_f32x4(b.zmm, b.zmm, 0xFF), result.zmm);
+   return result;
+}
+
+inline cAVX512matrix MatTranspose(cAVX512matrix &m) {
+   AVX512matrix result;
+
+   result.zmm = _mm512_permutexvar_ps(_mm512_setr_epi32(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15), m.zmm);
+   return result;
+}
+
+inline cAVX512matrix MatInverse(cAVX512matrix &m) {
+   AVX512matrix result;
+
+   _mtx_inverse(m.xmm, result.xmm);
+   return result;
+}
+
+inline cAVX512matrix operator*(cAVX512matrix &a, cAVX512matrix &b) { return MatMultiply(a, b); }
+#endif
+
+/*************
+ *  Kernels  *
+ *************/
+
+// Each kernel transforms count elements of src by the row-major matrix m into dest; 3D kernels take w as 1 for points, or 0 for vectors
+
+static inline void _mtx_transform4SSE(VEC4Df *dest, cVEC4Df *src, csize_t count, cfl32 *m) {
+   cfl32x4 row0 = _mm_loadu_ps(&m[0]), row1 = _mm_loadu_ps(&m[4]), row2 = _mm_loadu_ps(&m[8]), row3 = _mm_loadu_ps(&m[12]);
+
+   for (size_t i = 0; i < count; i++) {
+      cfl32x4 p = _mm_loadu_ps(src[i]._fl32);
+      fl32x4 out = _mm_mul_ps(_mm_shuffle_ps(p, p, 0x00), row0);
+
+      out = _mm_add_ps(out, _mm_mul_ps(_mm_shuffle_ps(p, p, 0x55), row1));
+      out = _mm_add_ps(out, _mm_mul_ps(_mm_shuffle_ps(p, p, 0xAA), row2));
+      _mm_storeu_ps(dest[i]._fl32, _mm_add_ps(out, _mm_mul_ps(_mm_shuffle_ps(p, p, 0xFF), row3)));
+   }
+}
+
+template<bool point> static inline void _mtx_transform3SSE(VEC3Df *dest, cVEC3Df *src, csize_t count, cfl32 *m) {
+   cfl32x4 row0 = _mm_loadu_ps(&m[0]), row1 = _mm_loadu_ps(&m[4]), row2 = _mm_loadu_ps(&m[8]), row3 = _mm_loadu_ps(&m[12]);
+
+   for (size_t i = 0; i < count; i++) {
+      fl32x4 out = _mm_mul_ps(_mm_load_ps1(&src[i].x), row0);
+
+      out = _mm_add_ps(out, _mm_mul_ps(_mm_load_ps1(&src[i].y), row1));
+      out = _mm_add_ps(out, _mm_mul_ps(_mm_load_ps1(&src[i].z), row2));
+      if (point) out = _mm_add_ps(out, row3);
+      _mm_storel_pi((__m64 *)&dest[i].x, out);
+      _mm_store_ss(&dest[i].z, _mm_movehl_ps(out, out));
+   }
+}
+
+#ifdef _FPDT_KERNELS_AVX2_
+// Two elements per register, one per 128-bit lane
+static inline _FPDT_TARGET_AVX2_ void _mtx_transform4AVX2(VEC4Df *dest, cVEC4Df *src, csize_t count, cfl32 *m) {
+   cfl32x8 row0 = _mm256_broadcast_ps((const __m128 *)&m[0]), row1 = _mm256_broadcast_ps((const __m128 *)&m[4]);
+   cfl32x8 row2 = _mm256_broadcast_ps((const __m128 *)&m[8]), row3 = _mm256_broadcast_ps((const __m128 *)&m[12]);
+   size_t i = 0;
+
+   for (; i + 2 <= count; i += 2) {
+      cfl32x8 p = _mm256_loadu_ps(src[i]._fl32);
+      fl32x8 out = _mm256_mul_ps(_mm256_permute_ps(p, 0x00), row0);
+
+      out = _MTX_FMADD256_(_mm256_permute_ps(p, 0x55), row1, out);
+      out = _MTX_FMADD256_(_mm256_permute_ps(p, 0xAA), row2, out);
+      _mm256_storeu_ps(dest[i]._fl32, _MTX_FMADD256_(_mm256_permute_ps(p, 0xFF), row3, out));
+   }
+   _mtx_transform4SSE(&dest[i], &src[i], count - i, m);
+}
+
+template<bool point> static inline _FPDT_TARGET_AVX2_ void _mtx_transform3AVX2(VEC3Df *dest, cVEC3Df *src, csize_t count, cfl32 *m) {
+   cfl32x8 row0 = _mm256_broadcast_ps((const __m128 *)&m[0]), row1 = _mm256_broadcast_ps((const __m128 *)&m[4]);
+   cfl32x8 row2 = _mm256_broadcast_ps((const __m128 *)&m[8]), row3 = _mm256_broadcast_ps((const __m128 *)&m[12]);
+   csi256 mask = _mm256_setr_epi32(-1, -1, -1, -1, -1, -1, 0, 0);
+   csi256 xs = _mm256_setr_epi32(0, 0, 0, 0, 3, 3, 3, 3), ys = _mm256_setr_epi32(1, 1, 1, 1, 4, 4, 4, 4), zs = _mm256_setr_epi32(2, 2, 2, 2, 5, 5, 5, 5);
+   csi256 pack = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7);
+   size_t i = 0;
+
+   // Two elements of three floats per register, spread to one per 128-bit lane, then packed back
+   for (; i + 2 <= count; i += 2) {
+      cfl32x8 p = _mm256_maskload_ps(&src[i].x, mask);
+      fl32x8 out = _mm256_mul_ps(_mm256_permutevar8x32_ps(p, xs), row0);
+
+      out = _MTX_FMADD256_(_mm256_permutevar8x32_ps(p, ys), row1, out);
+      out = _MTX_FMADD256_(_mm256_permutevar8x32_ps(p, zs), row2, out);
+      if (point) out = _mm256_add_ps(out, row3);
+      _mm256_maskstore_ps(&dest[i].x, mask, _mm256_permutevar8x32_ps(out, pack));
+   }
+   _mtx_transform3SSE<point>(&dest[i], &src[i], count - i, m);
+}
+#endif
+
+#ifdef _FPDT_KERNELS_AVX512_
+// Four elements per register, one per 128-bit lane
+static inline _FPDT_TARGET_AVX512_ void _mtx_transform4AVX512(VEC4Df *dest, cVEC4Df *src, csize_t count, cfl32 *m) {
+   cfl32x16 rows = _mm512_loadu_ps(m);
+   cfl32x16 row0 = _mm512_shuffle_f32x4(rows, rows, 0x00), row1 = _mm512_shuffle_f32x4(rows, rows, 0x55);
+   cfl32x16 row2 = _mm512_shuffle_f32x4(rows, rows, 0xAA), row3 = _mm512_shuffle_f32x4(rows, rows, 0xFF);
+
+   const auto transform = [&](cfl32x16 p) _FPDT_TARGET_AVX512_ {
+      fl32x16 out = _mm512_mul_ps(_mm512_permute_ps(p, 0x00), row0);
+
+      out = _mm512_fmadd_ps(_mm512_permute_ps(p, 0x55), row1, out);
+      out = _mm512_fmadd_ps(_mm512_permute_ps(p, 0xAA), row2, out);
+      return _mm512_fmadd_ps(_mm512_permute_ps(p, 0xFF), row3, out);
+   };
+   size_t i = 0;
+
+   for (; i + 8 <= count; i += 8) {
+      cfl32x16 a = _mm512_loadu_ps(src[i]._fl32), b = _mm512_loadu_ps(src[i + 4]._fl32);
+
+      _mm512_storeu_ps(dest[i]._fl32, transform(a));
+      _mm512_storeu_ps(dest[i + 4]._fl32, transform(b));
+   }
+   for (; i < count; i += 4) {
+      const __mmask16 mask = count - i < 4 ? __mmask16((1u << ((count - i) * 4)) - 1u) : __mmask16(0x0FFFF);
+
+      _mm512_mask_storeu_ps(dest[i]._fl32, mask, transform(_mm512_maskz_loadu_ps(mask, src[i]._fl32)));
+   }
+}
+
+template<bool point> static inline _FPDT_TARGET_AVX512_ void _mtx_transform3AVX512(VEC3Df *dest, cVEC3Df *src, csize_t count, cfl32 *m) {
+   cfl32x16 rows = _mm512_loadu_ps(m);
+   cfl32x16 row0 = _mm512_shuffle_f32x4(rows, rows, 0x00), row1 = _mm512_shuffle_f32x4(rows, rows, 0x55);
+   cfl32x16 row2 = _mm512_shuffle_f32x4(rows, rows, 0xAA), row3 = _mm512_shuffle_f32x4(rows, rows, 0xFF);
+   csi512 xs = _mm512_setr_epi32(0, 0, 0, 0, 3, 3, 3, 3, 6, 6, 6, 6, 9, 9, 9, 9);
+   csi512 ys = _mm512_setr_epi32(1, 1, 1, 1, 4, 4, 4, 4, 7, 7, 7, 7, 10, 10, 10, 10);
+   csi512 zs = _mm512_setr_epi32(2, 2, 2, 2, 5, 5, 5, 5, 8, 8, 8, 8, 11, 11, 11, 11);
+   csi512 pack = _mm512_setr_epi32(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, 15, 15, 15, 15);
+
+   // Four elements of three floats per register, spread to one per 128-bit lane, then packed back
+   const auto transform = [&](cfl32x16 p) _FPDT_TARGET_AVX512_ {
+      fl32x16 out = _mm512_mul_ps(_mm512_permutexvar_ps(xs, p), row0);
+
+      out = _mm512_fmadd_ps(_mm512_permutexvar_ps(ys, p), row1, out);
+      out = _mm512_fmadd_ps(_mm512_permutexvar_ps(zs, p), row2, out);
+      if (point) out = _mm512_add_ps(out, row3);
+      return _mm512_permutexvar_ps(pack, out);
+   };
+   size_t i = 0;
+
+   // Whole loads read 4 floats past their 4 elements, so stop while 2 more elements remain
+   for (; i + 10 <= count; i += 8) {
+      cfl32x16 a = _mm512_loadu_ps(&src[i].x), b = _mm512_loadu_ps(&src[i + 4].x);
+
+      _mm512_mask_storeu_ps(&dest[i].x, 0x0FFF, transform(a));
+      _mm512_mask_storeu_ps(&dest[i + 4].x, 0x0FFF, transform(b));
+   }
+   for (; i < count; i += 4) {
+      const __mmask16 mask = count - i < 4 ? __mmask16((1u << ((count - i) * 3)) - 1u) : __mmask16(0x0FFF);
+
+      _mm512_mask_storeu_ps(&dest[i].x, mask, transform(_mm512_maskz_loadu_ps(mask, &src[i].x)));
+   }
+}
+#endif
+
+/*
+ *  Kernel tables, indexed by fpdtISA()
+ */
+
+static decltype(&_mtx_transform4SSE) const _mtx_transform4ISA[] = _FPDT_KERNELS_(_mtx_transform4);
+static decltype(&_mtx_transform3SSE<true>) const _mtx_transformPointsISA[] = _FPDT_KERNELS_T_(_mtx_transform3, true);
+static decltype(&_mtx_transform3SSE<false>) const _mtx_transformVectorsISA[] = _FPDT_KERNELS_T_(_mtx_transform3, false);
+
+/************************
+ *  Batched transforms  *
+ ************************/
+
+// dest[i] = src[i] * m, for count 4D elements
+inline void MatTransform(VEC4Df *dest, cVEC4Df *src, csize_t count, cAVXmatrix &m) { _mtx_transform4ISA[fpdtISA()](dest, src, count, m.fl); }
+inline void MatTransform(VEC4Df *dest, cVEC4Df *src, csize_t count, cAVX512matrix &m) { _mtx_transform4ISA[fpdtISA()](dest, src, count, m.fl); }
+inline void MatTransform(SSE4Df32 *dest, cSSE4Df32 *src, csize_t count, cAVXmatrix &m) { _mtx_transform4ISA[fpdtISA()]((VEC4Df *)dest, (cVEC4Df *)src, count, m.fl); }
+inline void MatTransform(SSE4Df32 *dest, cSSE4Df32 *src, csize_t count, cAVX512matrix &m) { _mtx_transform4ISA[fpdtISA()]((VEC4Df *)dest, (cVEC4Df *)src, count, m.fl); }
+
+// dest[i] = (src[i], 1) * m, for count 3D points; w of the result is dropped, without a perspective divide
+inline void MatTransformPoints(VEC3Df *dest, cVEC3Df *src, csize_t count, cAVXmatrix &m) { _mtx_transformPointsISA[fpdtISA()](dest, src, count, m.fl); }
+inline void MatTransformPoints(VEC3Df *dest, cVEC3Df *src, csize_t count, cAVX512matrix &m) { _mtx_transformPointsISA[fpdtISA()](dest, src, count, m.fl); }
+
+// dest[i] = (src[i], 0) * m, for count 3D directions, which ignore the translation in row 3
+inline void MatTransformVectors(VEC3Df *dest, cVEC3Df *src, csize_t count, cAVXmatrix &m) { _mtx_transformVectorsISA[fpdtISA()](dest, src, count, m.fl); }
+inline void MatTransformVectors(VEC3Df *dest, cVEC3Df *src, csize_t count, cAVX512matrix &m) { _mtx_transformVectorsISA[fpdtISA()](dest, src, count, m.fl); }
@@ -0,0 +1,365 @@
+/**********************************************************************
+ * File: PCM audio conversion.h                   Created: 2024/07/21 *
+ *                                          Last modified: 2024/07/26 *
+ *                                                                    *
+ * Desc: Streaming conversion between interleaved, packed s24le PCM   *
+ *       & 32-bit floats, fs1p14, f1p15, or fp16n_1_1.                *
+ *       PCM24Decoder<T> & PCM24Encoder<T> take chunks of any size,   *
+ *       carrying a partial frame over to the next call, so that      *
+ *       every call returns whole frames of all channels.             *
+ *                                                                    *
+ * Notes: A sample s maps to s / 2^23, so floats span -1.0~1.0;       *
+ *        f1p15 holds two's complement Q15 codes, as its wrapping     *
+ *        scalar conversion gives for negative values.                *
+ *        Narrowing to 16 bits rounds to nearest, & may first add     *
+ *        TPDF dither of +-1 code; results saturate. Widening is      *
+ *        exact, except for fp16n_1_1, whose step is not a power of   *
+ *        2, & floats, which round to nearest & saturate, NaNs to the *
+ *        lowest sample.                                              *
+ *        Kernels are SSE, AVX2, or AVX512, chosen by fpdtISA(), & 16 *
+ *        samples at a time, whatever the channel count. Without      *
+ *        dither, all give the same results as their scalar tails.    *
+ *                                                                    *
+ * MIT license.                     Copyright (c) David William Bull. *
+ **********************************************************************/
+#pragma once
+
+#include <cstring>
+#include "24-bit integers.h"
+#include "Fixed-point bulk conversion.h"
+
+#define _PCM_AUDIO_CONVERSION_
+
+/*************
+ *  Formats  *
+ *************/
+
+// Sample s maps to code s * scale + bias, then code ^ flip; signed 16-bit codes are flipped to offset binary
+template<typename T> struct _pcm_code;
+template<> struct _pcm_code<fl32> { static constexpr fl32 scale = 1.0f / 8388608.0f, bias = 0.0f; static constexpr ui16 flip = 0; };
+template<> struct _pcm_code<fs1p14> { static constexpr fl32 scale = 1.0f / 512.0f, bias = 0.0f; static constexpr ui16 flip = 0x08000; };
+template<> struct _pcm_code<f1p15> { static constexpr fl32 scale = 1.0f / 256.0f, bias = 0.0f; static constexpr ui16 flip = 0; };
+template<> struct _pcm_code<fp16n_1_1> { static constexpr fl32 scale = 32767.5f / 8388608.0f, bias = -0.5f; static constexpr ui16 flip = 0x08000; };
+
+template<typename T, cbool Dither> struct _pcm_format : _pcm_code<T> {
+   typedef T type;
+
+   static constexpr bool narrow = sizeof(T) == 2, dither = Dither && narrow;
+   static constexpr fl32 rcpScale = 1.0f / _pcm_code<T>::scale;
+   static constexpr fl32 lo = narrow ? -32768.0f : -8388608.0f, hi = narrow ? 32767.0f : 8388607.0f; // Signed code range
+   static constexpr fl32 sampleLo = -8388608.0f, sampleHi = 8388607.0f;
+};
+
+/************
+ *  Dither  *
+ ************/
+
+// Triangular noise of -1.0~1.0 codes, the sum of the 2 16-bit halves of one xorshift32 step
+static inline cfl32 _pcm_tpdf1(ui32 &state) {
+   cui32 bits = _fpdt_xorshift(state);
+   return fl32(si32((bits & 0x0FFFF) + (bits >> 16)) - 65535) * (1.0f / 65536.0f);
+}
+
+static inline cfl32x4 _pcm_tpdf4(si128 &state) {
+   state = _mm_xor_si128(state, _mm_slli_epi32(state, 13));
+   state = _mm_xor_si128(state, _mm_srli_epi32(state, 17));
+   state = _mm_xor_si128(state, _mm_slli_epi32(state, 5));
+   csi128 sum = _mm_add_epi32(_mm_and_si128(state, _mm_set1_epi32(0x0FFFF)), _mm_srli_epi32(state, 16));
+   return _mm_mul_ps(_mm_cvtepi32_ps(_mm_sub_epi32(sum, _mm_set1_epi32(65535))), _mm_set1_ps(1.0f / 65536.0f));
+}
+
+#ifdef _FPDT_KERNELS_AVX2_
+static inline _FPDT_TARGET_AVX2_ cfl32x8 _pcm_tpdf8(si256 &state) {
+   state = _mm256_xor_si256(state, _mm256_slli_epi32(state, 13));
+   state = _mm256_xor_si256(state, _mm256_srli_epi32(state, 17));
+   state = _mm256_xor_si256(state, _mm256_slli_epi32(state, 5));
+   csi256 sum = _mm256_add_epi32(_mm256_and_si256(state, _mm256_set1_epi32(0x0FFFF)), _mm256_srli_epi32(state, 16));
+   return _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_sub_epi32(sum, _mm256_set1_epi32(65535))), _mm256_set1_ps(1.0f / 65536.0f));
+}
+#endif
+
+#ifdef _FPDT_KERNELS_AVX512_
+static inline _FPDT_TARGET_AVX512_ cfl32x16 _pcm_tpdf16(si512 &state) {
+   state = _mm512_xor_si512(state, _mm512_slli_epi32(state, 13));
+   state = _mm512_xor_si512(state, _mm512_srli_epi32(state, 17));
+   state = _mm512_xor_si512(state, _mm512_slli_epi32(state, 5));
+   csi512 sum = _mm512_add_epi32(_mm512_and_si512(state, _mm512_set1_epi32(0x0FFFF)), _mm512_srli_epi32(state, 16));
+   return _mm512_mul_ps(_mm512_cvtepi32_ps(_mm512_sub_epi32(sum, _mm512_set1_epi32(65535))), _mm512_set1_ps(1.0f / 65536.0f));
+}
+#endif
+
+/*************
+ *  Kernels  *
+ *************/
+
+// Each decode kernel converts count samples from src, 3 bytes each, to dest; each encode kernel the reverse.
+// state is the dither generator, read & written only when F::dither. Every kernel gives the scalar functions'
+// results: the multiply & add are not fused, & clamps take NaNs to the low end, as maxps with the value first does
+
+template<class F> static inline void _pcm_decode1(typename F::type *dest, cui8 *src, ui32 &state) {
+   fl32 value = fl32(si32(_i24_widen<true>(src))) * F::scale + F::bias;
+
+   if constexpr (F::narrow) {
+      if constexpr (F::dither) value += _pcm_tpdf1(state);
+      value = _fpdt_round1<FPDT_ROUND_NEAREST>(value, state);
+      value = value > F::lo ? (value < F::hi ? value : F::hi) : F::lo;
+      ((ui16 *)dest)[0] = ui16(si32(value)) ^ F::flip;
+   } else *(fl32 *)dest = value;
+}
+
+template<class F> static inline void _pcm_encode1(ui8 *dest, const typename F::type *src) {
+   fl32 value;
+
+   if constexpr (F::narrow) value = (fl32(si16(((cui16 *)src)[0] ^ F::flip)) - F::bias) * F::rcpScale;
+   else value = *(cfl32 *)src * F::rcpScale;
+   ui32 unused = 0;
+   value = _fpdt_round1<FPDT_ROUND_NEAREST>(value, unused);
+   _i24_narrow1(dest, ui32(si32(value > F::sampleLo ? (value < F::sampleHi ? value : F::sampleHi) : F::sampleLo)));
+}
+
+// 4 samples to 16-bit codes, or floats, from 32-bit samples
+template<class F> static inline csi128 _pcm_code4(csi128 sample, si128 &rng) {
+   fl32x4 value = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(sample), _mm_set1_ps(F::scale)), _mm_set1_ps(F::bias));
+
+   if constexpr (F::dither) value = _mm_add_ps(value, _pcm_tpdf4(rng));
+   value = _mm_round_ps(value, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+   return _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(value, _mm_set1_ps(F::lo)), _mm_set1_ps(F::hi)));
+}
+
+// 4 16-bit codes, or floats, to 32-bit samples
+template<class F> static inline csi128 _pcm_sample4(cfl32x4 value) {
+   cfl32x4 scaled = _mm_round_ps(_mm_mul_ps(_mm_sub_ps(value, _mm_set1_ps(F::bias)), _mm_set1_ps(F::rcpScale)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+   return _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(scaled, _mm_set1_ps(F::sampleLo)), _mm_set1_ps(F::sampleHi)));
+}
+
+template<class F> static inline void _pcm_decodeSSE(typename F::type *dest, cui8 *src, csize_t count, ui32 &state) {
+   cui128 flip = _mm_set1_epi16(si16(F::flip));
+   si128   rng = F::dither ? _fpdt_rngSeed4(state, 0) : _mm_setzero_si128();
+   size_t  i = 0;
+
+   for (; i + 16 <= count; i += 16) {
+      si128 sample[4];
+
+      _i24_load16SSE<true>(sample, src + i * 3);
+      if constexpr (F::narrow) {
+         _mm_storeu_si128((si128 *)(dest + i), _mm_xor_si128(_mm_packs_epi32(_pcm_code4<F>(sample[0], rng), _pcm_code4<F>(sample[1], rng)), flip));
+         _mm_storeu_si128((si128 *)(dest + i + 8), _mm_xor_si128(_mm_packs_epi32(_pcm_code4<F>(sample[2], rng), _pcm_code4<F>(sample[3], rng)), flip));
+      } else for (ui32 j = 0; j < 4; j++) _mm_storeu_ps(dest + i + j * 4, _mm_mul_ps(_mm_cvtepi32_ps(sample[j]), _mm_set1_ps(F::scale)));
+   }
+   if constexpr (F::dither) state = ui32(_mm_cvtsi128_si32(rng)) | 1u;
+   for (; i < count; i++) _pcm_decode1<F>(dest + i, src + i * 3, state);
+}
+
+template<class F> static inline void _pcm_encodeSSE(ui8 *dest, const typename F::type *src, csize_t count, ui32 &) {
+   cui128 flip = _mm_set1_epi16(si16(F::flip));
+   size_t  i = 0;
+
+   for (; i + 16 <= count; i += 16) {
+      si128 sample[4];
+
+      if constexpr (F::narrow) for (ui32 j = 0; j < 2; j++) {
+         csi128 code = _mm_xor_si128(_mm_loadu_si128((csi128 *)(src + i + j * 8)), flip);
+
+         sample[j * 2] = _pcm_sample4<F>(_mm_cvtepi32_ps(_mm_cvtepi16_epi32(code)));
+         sample[j * 2 + 1] = _pcm_sample4<F>(_mm_cvtepi32_ps(_mm_cvtepi16_epi32(_mm_srli_si128(code, 8))));
+      } else for (ui32 j = 0; j < 4; j++) sample[j] = _pcm_sample4<F>(_mm_loadu_ps(src + i + j * 4));
+      _i24_store16SSE(dest + i * 3, sample);
+   }
+   for (; i < count; i++) _pcm_encode1<F>(dest + i * 3, src + i);
+}
+
+#ifdef _FPDT_KERNELS_AVX2_
+template<class F> static inline _FPDT_TARGET_AVX2_ csi256 _pcm_code8(csi256 sample, si256 &rng) {
+   fl32x8 value = _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(sample), _mm256_set1_ps(F::scale)), _mm256_set1_ps(F::bias));
+
+   if constexpr (F::dither) value = _mm256_add_ps(value, _pcm_tpdf8(rng));
+   value = _mm256_round_ps(value, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+   return _mm256_cvttps_epi32(_mm256_min_ps(_mm256_max_ps(value, _mm256_set1_ps(F::lo)), _mm256_set1_ps(F::hi)));
+}
+
+template<class F> static inline _FPDT_TARGET_AVX2_ csi256 _pcm_sample8(cfl32x8 value) {
+   cfl32x8 scaled = _mm256_round_ps(_mm256_mul_ps(_mm256_sub_ps(value, _mm256_set1_ps(F::bias)), _mm256_set1_ps(F::rcpScale)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+   return _mm256_cvttps_epi32(_mm256_min_ps(_mm256_max_ps(scaled, _mm256_set1_ps(F::sampleLo)), _mm256_set1_ps(F::sampleHi)));
+}
+
+template<class F> static inline _FPDT_TARGET_AVX2_ void _pcm_decodeAVX2(typename F::type *dest, cui8 *src, csize_t count, ui32 &state) {
+   cui256 flip = _mm256_set1_epi16(si16(F::flip));
+   si256   rng = F::dither ? _mm256_setr_m128i(_fpdt_rngSeed4(state, 0), _fpdt_rngSeed4(state, 4)) : _mm256_setzero_si256();
+   size_t  i = 0;
+
+   for (; i + 16 <= count; i += 16) {
+      si256 sample[2];
+
+      _i24_load16AVX2<true>(sample, src + i * 3);
+      if constexpr (F::narrow) { // packs works within 128-bit lanes, so the 64-bit quarters are reordered
+         csi256 codes = _mm256_packs_epi32(_pcm_code8<F>(sample[0], rng), _pcm_code8<F>(sample[1], rng));
+
+         _mm256_storeu_si256((si256 *)(dest + i), _mm256_xor_si256(_mm256_permute4x64_epi64(codes, 0x0D8), flip));
+      } else for (ui32 j = 0; j < 2; j++) _mm256_storeu_ps(dest + i + j * 8, _mm256_mul_ps(_mm256_cvtepi32_ps(sample[j]), _mm256_set1_ps(F::scale)));
+   }
+   if constexpr (F::dither) state = ui32(_mm_cvtsi128_si32(_mm256_castsi256_si128(rng))) | 1u;
+   for (; i < count; i++) _pcm_decode1<F>(dest + i, src + i * 3, state);
+}
+
+template<class F> static inline _FPDT_TARGET_AVX2_ void _pcm_encodeAVX2(ui8 *dest, const typename F::type *src, csize_t count, ui32 &) {
+   cui256 flip = _mm256_set1_epi16(si16(F::flip));
+   size_t  i = 0;
+
+   for (; i + 16 <= count; i += 16) {
+      si256 sample[2];
+
+      if constexpr (F::narrow) {
+         csi256 code = _mm256_xor_si256(_mm256_loadu_si256((csi256 *)(src + i)), flip);
+
+         sample[0] = _pcm_sample8<F>(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm256_castsi256_si128(code))));
+         sample[1] = _pcm_sample8<F>(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm256_extracti128_si256(code, 1))));
+      } else for (ui32 j = 0; j < 2; j++) sample[j] = _pcm_sample8<F>(_mm256_loadu_ps(src + i + j * 8));
+      _i24_store16AVX2(dest + i * 3, sample);
+   }
+   for (; i < count; i++) _pcm_encode1<F>(dest + i * 3, src + i);
+}
+#endif
+
+#ifdef _FPDT_KERNELS_AVX512_
+// Tails run under masks, so the generator advances by whole vectors & the scalar dither is never used
+template<class F> static inline _FPDT_TARGET_AVX512_ void _pcm_decodeAVX512(typename F::type *dest, cui8 *src, csize_t count, ui32 &state) {
+   si512 rng = _mm512_setzero_si512();
+
+   if constexpr (F::dither) rng = _mm512_inserti64x4(_mm512_castsi256_si512(_mm256_setr_m128i(_fpdt_rngSeed4(state, 0), _fpdt_rngSeed4(state, 4))),
+                                                     _mm256_setr_m128i(_fpdt_rngSeed4(state, 8), _fpdt_rngSeed4(state, 12)), 1);
+   for (size_t i = 0; i < count; i += 16) {
+      cui32    n = count - i < 16 ? ui32(count - i) : 16;
+      cfl32x16 sample = _mm512_cvtepi32_ps(_i24_loadAVX512<true>(src + i * 3, n));
+
+      if constexpr (F::narrow) {
+         fl32x16 value = _mm512_add_ps(_mm512_mul_ps(sample, _mm512_set1_ps(F::scale)), _mm512_set1_ps(F::bias));
+
+         if constexpr (F::dither) value = _mm512_add_ps(value, _pcm_tpdf16(rng));
+         value = _mm512_min_ps(_mm512_max_ps(_mm512_roundscale_ps(value, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC), _mm512_set1_ps(F::lo)), _mm512_set1_ps(F::hi));
+         _mm256_mask_storeu_epi16(dest + i, __mmask16((1u << n) - 1), _mm256_xor_si256(_mm512_cvtepi32_epi16(_mm512_cvttps_epi32(value)), _mm256_set1_epi16(si16(F::flip))));
+      } else _mm512_mask_storeu_ps(dest + i, __mmask16((1u << n) - 1), _mm512_mul_ps(sample, _mm512_set1_ps(F::scale)));
+   }
+   if constexpr (F::dither) state = ui32(_mm_cvtsi128_si32(_mm512_castsi512_si128(rng))) | 1u;
+}
+
+template<class F> static inline _FPDT_TARGET_AVX512_ void _pcm_encodeAVX512(ui8 *dest, const typename F::type *src, csize_t count, ui32 &) {
+   for (size_t i = 0; i < count; i += 16) {
+      cui32     n = count - i < 16 ? ui32(count - i) : 16;
+      const __mmask16 mask = __mmask16((1u << n) - 1);
+      fl32x16   value;
+
+      if constexpr (F::narrow) value = _mm512_sub_ps(_mm512_cvtepi32_ps(_mm512_cvtepi16_epi32(_mm256_xor_si256(_mm256_maskz_loadu_epi16(mask, src + i), _mm256_set1_epi16(si16(F::flip))))), _mm512_set1_ps(F::bias));
+      else value = _mm512_maskz_loadu_ps(mask, src + i);
+      value = _mm512_roundscale_ps(_mm512_mul_ps(value, _mm512_set1_ps(F::rcpScale)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+      _i24_storeAVX512(dest + i * 3, _mm512_cvttps_epi32(_mm512_min_ps(_mm512_max_ps(value, _mm512_set1_ps(F::sampleLo)), _mm512_set1_ps(F::sampleHi))), n);
+   }
+}
+#endif
+
+/*************
+ *  Streams  *
+ *************/
+
+// Interleaved s24le frames of channels samples to T, from chunks of any size; the bytes of a partial frame are
+// carried over to the next call, so that dest always receives whole frames. A channel count of 0 is taken as 1
+template<typename T> struct PCM24Decoder {
+   typedef const PCM24Decoder cPCM24Decoder;
+   typedef void (*kernel)(T *dest, cui8 *src, csize_t count, ui32 &state);
+
+   ui32  channels = 0;
+   bool  dither = false; // Add TPDF dither before rounding, when T is 16-bit
+   ui32  state = 0;      // Dither generator
+   ui8  *carry = nullptr;
+   size_t carried = 0;   // Bytes of a partial frame in carry
+
+   static inline kernel select(cbool dither) {
+      typedef _pcm_format<T, false> plain; typedef _pcm_format<T, true> dithered;
+      static kernel const isa[2][3] = { _FPDT_KERNELS_T_(_pcm_decode, plain), _FPDT_KERNELS_T_(_pcm_decode, dithered) };
+
+      return isa[dither][fpdtISA()];
+   }
+
+   PCM24Decoder(cui32 channels, cbool dither = false, cui32 seed = 0x09E3779B9u) : channels(channels ? channels : 1), dither(dither), state(seed | 1u) { carry = new ui8[this->channels * 3]; }
+   PCM24Decoder(cPCM24Decoder &) = delete;
+   PCM24Decoder &operator=(cPCM24Decoder &) = delete;
+   ~PCM24Decoder(void) { delete[] carry; }
+
+   // Bytes of a partial frame held for the next call
+   inline csize_t pending(void) const { return carried; }
+   // Drop any partial frame, e.g. on a seek
+   inline void reset(void) { carried = 0; }
+
+   // Convert bytes of src, & any carried bytes, to dest, which needs room for (pending() + bytes) / 3 samples;
+   // returns the number of samples written, a multiple of channels
+   size_t decode(T *dest, cui8 *src, size_t bytes) {
+      csize_t frame = size_t(channels) * 3;
+      const kernel run = select(dither);
+      size_t  written = 0;
+
+      if (carried) { // Complete the carried frame first
+         csize_t take = frame - carried < bytes ? frame - carried : bytes;
+
+         memcpy(carry + carried, src, take);
+         carried += take; src += take; bytes -= take;
+         if (carried < frame) return 0;
+         run(dest, carry, channels, state);
+         written = channels; carried = 0;
+      }
+      csize_t whole = bytes / frame * frame;
+
+      run(dest + written, src, whole / 3, state);
+      memcpy(carry, src + whole, carried = bytes - whole);
+      return written + whole / 3;
+   }
+};
+
+// T to interleaved s24le frames of channels samples, from chunks of any size; the samples of a partial frame are
+// carried over to the next call, so that dest always receives whole frames. A channel count of 0 is taken as 1
+template<typename T> struct PCM24Encoder {
+   typedef const PCM24Encoder cPCM24Encoder;
+   typedef void (*kernel)(ui8 *dest, const T *src, csize_t count, ui32 &state);
+
+   ui32   channels = 0;
+   T     *carry = nullptr;
+   size_t carried = 0; // Samples of a partial frame in carry
+
+   static inline kernel select(void) {
+      typedef _pcm_format<T, false> plain;
+      static kernel const isa[3] = _FPDT_KERNELS_T_(_pcm_encode, plain);
+
+      return isa[fpdtISA()];
+   }
+
+   explicit PCM24Encoder(cui32 channels) : channels(channels ? channels : 1) { carry = new T[this->channels]; }
+   PCM24Encoder(cPCM24Encoder &) = delete;
+   PCM24Encoder &operator=(cPCM24Encoder &) = delete;
+   ~PCM24Encoder(void) { delete[] carry; }
+
+   // Samples of a partial frame held for the next call
+   inline csize_t pending(void) const { return carried; }
+   // Drop any partial frame, e.g. on a seek
+   inline void reset(void) { carried = 0; }
+
+   // Convert count samples of src, & any carried samples, to dest, which needs room for 3 * (pending() + count)
+   // bytes; returns the number of bytes written, a multiple of 3 * channels
+   size_t encode(ui8 *dest, const T *src, size_t count) {
+      const kernel run = select();
+      size_t written = 0;
+      ui32   unused = 0;
+
+      if (carried) {
+         csize_t take = channels - carried < count ? channels - carried : count;
+
+         memcpy(carry + carried, src, take * sizeof(T));
+         carried += take; src += take; count -= take;
+         if (carried < channels) return 0;
+         run(dest, carry, channels, unused);
+         written = size_t(channels) * 3; carried = 0;
+      }
+      csize_t whole = count / channels * channels;
+
+      run(dest + written, src, whole, unused);
+      memcpy(carry, src + whole, (carried = count - whole) * sizeof(T));
+      return written + whole * 3;
+   }
+};
@@ -0,0 +1,160 @@
+/**********************************************************************
+ * File: Parallel loops.h                         Created: 2024/07/24 *
+ *                                          Last modified: 2024/07/24 *
+ *                                                                    *
+ * Desc: LoopMT(), a parallel for on a pool of one thread per core,   *
+ *       with any compiler; the function equivalent of the $LoopMT    *
+ *       hints of typedefs.h.                                         *
+ *                                                                    *
+ * Notes: The range is split evenly among threads, each of which      *
+ *        takes chunks from the front of its own share, then steals   *
+ *        chunks from the other shares in turn, so loops of uneven    *
+ *        work still end at about the same time on every thread.      *
+ *        The calling thread works as one of the threads. The pool is *
+ *        started on first use, & runs one loop at a time; a loop     *
+ *        started inside another, or while another is running, runs   *
+ *        on its calling thread alone.                                *
+ *        Define LOOPMT_THREADS to fix the number of threads.         *
+ *                                                                    *
+ * MIT license.                     Copyright (c) David William Bull. *
+ **********************************************************************/
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include "typedefs.h"
+
+#define _PARALLEL_LOOPS_
+
+#define _MT_CHUNKS_ 8 // Chunks per thread when no grain is given, to balance uneven work
+
+/*****************
+ *  Thread pool  *
+ *****************/
+
+// One thread's share of a loop; a cache line each, as every thread may take chunks from it
+struct al64 _mt_share {
+   std::atomic<size_t> next;
+   size_t end;
+};
+
+// Calls body(first, last) for a chunk, or body(i) for each index of it
+template<class Body> static inline void _mt_run(void *body, csize_t first, csize_t last) {
+   if constexpr (std::is_invocable_v<Body &, size_t, size_t>) (*(Body *)body)(first, last);
+   else for (size_t i = first; i < last; i++) (*(Body *)body)(i);
+}
+
+// Set on threads running a loop, so that loops inside it run serially
+inline bool &_mt_inside(void) {
+   static thread_local bool inside = false;
+   return inside;
+}
+
+class _mt_pool {
+   std::thread *workers = nullptr;
+   _mt_share *shares = nullptr;
+   ui32 workerCount = 0;
+
+   std::mutex running;               // Held while a loop runs
+   std::atomic<ui32> generation = 0; // Bumped to start a loop, or to stop
+   std::atomic<ui32> pending = 0;    // Workers yet to finish the current loop
+   bool stopping = false;
+
+   // The current loop
+   void (*run)(void *, csize_t, csize_t) = nullptr;
+   void *body = nullptr;
+   size_t grain = 1;
+   ui32 participants = 0;
+
+   // Takes chunks from share index, then from every other share in turn
+   void work(cui32 index) {
+      for (ui32 i = 0; i < participants; i++) {
+         _mt_share &share = shares[(index + i) % participants];
+
+         for (size_t first; (first = share.next.fetch_add(grain, std::memory_order_relaxed)) < share.end;)
+            run(body, first, share.end - first < grain ? share.end : first + grain);
+      }
+   }
+
+   // Workers answer every loop, even those they sit out, so none is left reading a loop when the next is set up
+   void serve(cui32 index) {
+      _mt_inside() = true;
+
+      for (ui32 seen = 0;;) {
+         generation.wait(seen, std::memory_order_acquire);
+         seen = generation.load(std::memory_order_acquire);
+         if (stopping) return;
+         if (index < participants) work(index);
+         if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1) pending.notify_one();
+      }
+   }
+
+public:
+   _mt_pool(void) {
+#ifdef LOOPMT_THREADS
+      cui32 threads = LOOPMT_THREADS;
+#else
+      cui32 threads = std::thread::hardware_concurrency();
+#endif
+      workerCount = threads > 1 ? threads - 1 : 0;
+      shares = new _mt_share[workerCount + 1];
+      if (workerCount) workers = new std::thread[workerCount];
+      for (ui32 i = 0; i < workerCount; i++) workers[i] = std::thread(&_mt_pool::serve, this, i + 1);
+   }
+
+   ~_mt_pool(void) {
+      stopping = true;
+      generation.fetch_add(1, std::memory_order_release);
+      generation.notify_all();
+      for (ui32 i = 0; i < workerCount; i++) workers[i].join();
+      delete[] workers;
+      delete[] shares;
+   }
+
+   // Threads a loop may use, including the calling thread
+   cui32 threads(void) const { return workerCount + 1; }
+
+   template<class Body> void loop(csize_t begin, csize_t end, Body &loopBody, size_t chunk, ui32 threads) {
+      csize_t count = end > begin ? end - begin : 0;
+
+      if (!threads || threads > workerCount + 1) threads = workerCount + 1;
+      if (!chunk) chunk = count / (size_t(threads) * _MT_CHUNKS_);
+      if (!chunk) chunk = 1;
+      if (threads > 1 && count > chunk && !_mt_inside() && running.try_lock()) {
+         for (ui32 t = 0; t < threads; t++) {
+            shares[t].next.store(begin + count * t / threads, std::memory_order_relaxed);
+            shares[t].end = begin + count * (t + 1) / threads;
+         }
+         run = _mt_run<Body>, body = &loopBody, grain = chunk, participants = threads;
+         pending.store(workerCount, std::memory_order_relaxed);
+
+         _mt_inside() = true;
+         generation.fetch_add(1, std::memory_order_release);
+         generation.notify_all();
+         work(0);
+         for (ui32 left; (left = pending.load(std::memory_order_acquire)) != 0;) pending.wait(left, std::memory_order_acquire);
+         _mt_inside() = false;
+         running.unlock();
+      } else for (size_t first = begin; first < end; first += chunk) _mt_run<Body>(&loopBody, first, end - first < chunk ? end : first + chunk);
+   }
+};
+
+inline _mt_pool &_mt_getPool(void) {
+   static _mt_pool pool;
+   return pool;
+}
+
+/******************
+ *  Parallel for  *
+ ******************/
+
+// Calls body(i) for every i of begin ~ end - 1, or body(first, last) for chunks of grain indices, on up to threads threads of
+// the pool, & returns when all are done; threads of 0 uses them all, & grain of 0 gives each thread _MT_CHUNKS_ chunks
+template<class Body> inline void LoopMT(csize_t begin, csize_t end, Body &&body, csize_t grain = 0, cui32 threads = 0) {
+   _mt_getPool().loop(begin, end, body, grain, threads);
+}
+
+// Threads that LoopMT() spreads loops across, including the calling thread
+inline cui32 LoopMTThreads(void) { return _mt_getPool().threads(); }
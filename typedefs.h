@@ -1,6 +1,6 @@
 /****************************************************************
  * File: typedefs.h                         Created:   Jul.2007 *
- *                                    Last modified: 2024/06/17 *
+ *                                    Last modified: 2024/07/24 *
  *                                                              *
  * Desc: Shorthand type defines & composites, and static        *
  *       constant values of common data-type sizes.             *
@@ -11,6 +11,10 @@
  *        2024/05/11: Added all (~2) void pointer combinations  *
  *        2024/05/13: Moved ui24 data type to separate file     *
  *        2024/05/18: Added AVX512 vector types                 *
+ *        2024/07/20: Defining _24BIT_INTEGERS_ includes ui24   *
+ *                    from 24-bit integers.h                    *
+ *        2024/07/24: $LoopMT hints for GCC & Clang, with       *
+ *                    OpenMP                                    *
  *                                                              *
  * MIT license                 Copyright (c) David William Bull *
  ****************************************************************/
@@ -30,11 +34,27 @@
 
 #define vol volatile
 
+// Hints to run the next for loop on several threads: with /Qpar on MSVC, or -fopenmp on GCC & Clang; LoopMT() of
+// Parallel loops.h is the function equivalent, which always spreads the loop across its own pool of threads
+#ifdef _MSC_VER
 #define $LoopMT   __pragma(loop(hint_parallel(0)))
 #define $LoopMT2  __pragma(loop(hint_parallel(2)))
 #define $LoopMT4  __pragma(loop(hint_parallel(4)))
 #define $LoopMT8  __pragma(loop(hint_parallel(8)))
 #define $LoopMT16 __pragma(loop(hint_parallel(16)))
+#elif defined(_OPENMP)
+#define $LoopMT   _Pragma("omp parallel for schedule(static)")
+#define $LoopMT2  _Pragma("omp parallel for schedule(static) num_threads(2)")
+#define $LoopMT4  _Pragma("omp parallel for schedule(static) num_threads(4)")
+#define $LoopMT8  _Pragma("omp parallel for schedule(static) num_threads(8)")
+#define $LoopMT16 _Pragma("omp parallel for schedule(static) num_threads(16)")
+#else
+#define $LoopMT
+#define $LoopMT2
+#define $LoopMT4
+#define $LoopMT8
+#define $LoopMT16
+#endif
 
 // Standard types
 #if !defined(_WINDEF_)
@@ -515,3 +535,8 @@ al4 static const int CHI_SIZE = sizeof(_CHAR_INFO);
 #define refpa(dataType, dimension) (dataType (*)[dimension])
 #define refpa2(dataType, dimension1, dimesnion2) (dataType (*)[dimension1][dimension2])
 #define refp1a1(dataType, dimension1, dimension2) (dataType (*[dimension1])[dimension2])
+
+// 24-bit integers, declared after the types they are built from
+#ifdef _24BIT_INTEGERS_
+#include "24-bit integers.h"
+#endif